@@ -17,6 +17,7 @@
  */
 
 #include "main.h"
+#include "app_metadata.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -47,8 +48,11 @@ long __lseek(int fd, long offet, int whence)
 size_t __write(int file, const unsigned char *ptr, size_t len)
 {
   HAL_StatusTypeDef status;
+  int is_locked;
 
+  is_locked = META_UartLock();
   status = HAL_UART_Transmit(&huart1, (uint8_t*)ptr, len, ~0);
+  META_UartUnlock(is_locked);
 
   return (status == HAL_OK ? len : 0);
 }
@@ -17,6 +17,7 @@
  */
 
 #include "main.h"
+#include "app_metadata.h"
 
 #include <errno.h>
 #include <unistd.h>
@@ -26,13 +27,16 @@ extern UART_HandleTypeDef huart1;
 int _write(int file, char *ptr, int len)
 {
   HAL_StatusTypeDef status;
+  int is_locked;
 
   if ((file != STDOUT_FILENO) && (file != STDERR_FILENO)) {
       errno = EBADF;
       return -1;
   }
 
+  is_locked = META_UartLock();
   status = HAL_UART_Transmit(&huart1, (uint8_t*)ptr, len, ~0);
+  META_UartUnlock(is_locked);
 
   return (status == HAL_OK ? len : 0);
 }
@@ -54,6 +54,10 @@
 extern uint32_t SystemCoreClock;
 void TIM4_Config(void);
 uint32_t TIM4_Get_Value(void);
+#include "app_telemetry_conf.h"
+#ifdef USE_TELEMETRY
+void TLM_TaskSwitchedIn(uint32_t task_nb);
+#endif
 #endif
 #ifndef CMSIS_device_header
 #define CMSIS_device_header "stm32n6xx.h"
@@ -114,6 +118,11 @@ uint32_t TIM4_Get_Value(void);
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() TIM4_Config()
 #define portGET_RUN_TIME_COUNTER_VALUE()         TIM4_Get_Value()
 
+/* Count context switches per task for telemetry. See app_telemetry.c */
+#ifdef USE_TELEMETRY
+#define traceTASK_SWITCHED_IN()                  TLM_TaskSwitchedIn(pxCurrentTCB->uxTCBNumber)
+#endif
+
 /* CMSIS-RTOS V2 flags */
 #define configUSE_OS2_THREAD_SUSPEND_RESUME  0
 #define configUSE_OS2_THREAD_ENUMERATE       0
@@ -0,0 +1,58 @@
+ /**
+ ******************************************************************************
+ * @file    app_bench.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_BENCH
+#define APP_BENCH
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+/* Keep in sync with bench_stage_names[] in app_bench.c */
+typedef enum {
+  BENCH_STAGE_INFERENCE,
+  BENCH_STAGE_PP,
+  BENCH_STAGE_TRACKING,
+  BENCH_STAGE_NB
+} BENCH_Stage_t;
+
+/* Keep in sync with bench_queue_names[] in app_bench.c */
+typedef enum {
+  BENCH_QUEUE_NN_INPUT,   /* camera frame dropped since nn has not released its input buffer */
+  BENCH_QUEUE_NN_OUTPUT,  /* nn stalled since pp has not released its output buffer */
+  BENCH_QUEUE_DISPLAY,    /* display refresh dropped since dp is still drawing previous one */
+  BENCH_QUEUE_NB
+} BENCH_Queue_t;
+
+#ifdef USE_BENCHMARK
+void BENCH_Init(void);
+uint32_t BENCH_Now(void);
+void BENCH_FrameCaptured(void);
+void BENCH_QueueDrop(BENCH_Queue_t queue);
+void BENCH_StageDone(BENCH_Stage_t stage, uint32_t start);
+void BENCH_FrameDone(int nb_detect);
+#else
+#define BENCH_Init() do { } while (0)
+#define BENCH_Now() 0
+#define BENCH_FrameCaptured() do { } while (0)
+#define BENCH_QueueDrop(_queue_) do { } while (0)
+#define BENCH_StageDone(_stage_, _start_) do { (void) (_start_); } while (0)
+#define BENCH_FrameDone(_nb_detect_) do { } while (0)
+#endif
+
+#endif
@@ -19,6 +19,7 @@
 #define APP_CAM
 
 #include <stdint.h>
+#include "zoom.h"
 
 #ifdef STM32N6570_DK_REV
 #define CAMERA_FPS 20
@@ -29,6 +30,12 @@
 void CAM_Init(void);
 void CAM_DisplayPipe_Start(uint8_t *display_pipe_dst, uint32_t cam_mode);
 void CAM_NNPipe_Start(uint8_t *nn_pipe_dst, uint32_t cam_mode);
+/* Smallest roi side nn pipe can be cropped to, since dcmipp can't upscale */
+float CAM_NNPipe_GetRoiMinSize(void);
+/* Crop nn pipe to roi, given in nn full field of view coordinates. roi is updated to the area really captured. Call
+ * it between two nn pipe frames, new crop applies from next frame on.
+ */
+void CAM_NNPipe_SetRoi(zoom_roi_t *roi);
 void CAM_IspUpdate(void);
 
 #endif
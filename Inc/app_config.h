@@ -62,6 +62,155 @@
 #define NN_HEIGHT 224
 #endif
 
+/* Uncomment to enable adaptive compute governor. Adjust nn rate, post process settings and display refresh so cpu
+ * load stays below GOVERNOR_CPU_BUDGET. Without it nn runs at camera rate with static settings.
+ */
+/* #define USE_GOVERNOR */
+#define GOVERNOR_PERIOD_MS 250
+#define GOVERNOR_CPU_BUDGET (85.0)
+#define GOVERNOR_PP_LATENCY_MS 20
+#define GOVERNOR_NN_PERIOD_MAX_MS 2000
+#ifdef STM32N6570_DK_REV
+#define GOVERNOR_CONF_MIN AI_OD_ST_YOLOX_PP_CONF_THRESHOLD
+#else
+#define GOVERNOR_CONF_MIN AI_OD_YOLOV2_PP_CONF_THRESHOLD
+#endif
+#define GOVERNOR_CONF_MAX (0.85)
+#define GOVERNOR_DISP_DIVIDER_MAX 4
+/* Idle mode. Once nothing was detected or tracked for GOVERNOR_IDLE_DELAY_MS, nn runs at most once every
+ * GOVERNOR_IDLE_NN_PERIOD_MS until someone shows up. 0 never idles, set it to 10000 for instance to enable it.
+ */
+#define GOVERNOR_IDLE_DELAY_MS 0
+#define GOVERNOR_IDLE_NN_PERIOD_MS 1000
+
+/* Uncomment to account each inference against a DEADLINE_BUDGET_MS deadline. Misses, failed inferences and worst
+ * latency are shown in stats panel, and a latency histogram is printed on console every DEADLINE_REPORT_NB
+ * inferences. Once DEADLINE_DEGRADE_NB of the last DEADLINE_WINDOW_NB inferences missed, nn runs at most once every
+ * DEADLINE_DEGRADED_NN_PERIOD_MS and post process threshold is raised to DEADLINE_DEGRADED_CONF, until no more than
+ * DEADLINE_RECOVER_NB of them missed.
+ */
+/* #define USE_NN_DEADLINE */
+#define DEADLINE_BUDGET_MS 500
+#define DEADLINE_WINDOW_NB 32
+#define DEADLINE_DEGRADE_NB 8
+#define DEADLINE_RECOVER_NB 2
+#define DEADLINE_REPORT_NB 300
+#define DEADLINE_DEGRADED_NN_PERIOD_MS (2 * DEADLINE_BUDGET_MS)
+#define DEADLINE_DEGRADED_CONF (0.75)
+
+/* Uncomment to enable weight cache. At startup copy weight tensors with highest reuse from external flash into free
+ * internal ram, up to WEIGHT_CACHE_SIZE bytes. Tensors smaller than WEIGHT_CACHE_MIN_SIZE stay in dcache and are left
+ * in flash. Left off: inference time against WEIGHT_CACHE_SIZE has not been measured on board, see
+ * Doc/Build-Options.md.
+ */
+#ifdef STM32N6570_DK_REV
+/* #define USE_WEIGHT_CACHE */
+#endif
+#define WEIGHT_CACHE_SIZE (512 * 1024)
+#define WEIGHT_CACHE_MIN_SIZE (4 * 1024)
+
+/* Uncomment to skip leading u8 to s8 conversion layer of nn. Frame is converted in place in its capture buffer by a
+ * vectorized sign flip instead of being copied into activations by the runtime.
+ */
+#ifdef STM32N6570_DK_REV
+/* #define USE_NN_SIGNED_INPUT */
+#endif
+
+/* Uncomment to skip trailing s8 to float conversion layers of nn. Outputs stay int8, which divides nn output buffers
+ * size by 4, and post process decodes them with the quantized yolox path.
+ */
+#ifdef STM32N6570_DK_REV
+/* #define USE_NN_INT8_OUTPUT */
+#endif
+#ifdef USE_NN_INT8_OUTPUT
+#undef POSTPROCESS_TYPE
+#define POSTPROCESS_TYPE POSTPROCESS_OD_ST_YOLOX_UI
+#endif
+
+/* Uncomment to crop nn input around tracked people (detected ones when tracking is off) instead of feeding the whole
+ * field of view, so far away people get more pixels. Roi keeps NN_ROI_MARGIN of hull size around them, only shrinks
+ * after NN_ROI_SHRINK_DELAY results and goes back to full view after NN_ROI_RELEASE_DELAY results without anyone.
+ * One result out of NN_ROI_SCAN_PERIOD is computed on full view to catch newcomers.
+ */
+/* #define USE_NN_ROI */
+#define NN_ROI_MARGIN (0.25)
+#define NN_ROI_HYSTERESIS (0.2)
+#define NN_ROI_SHRINK_DELAY 10
+#define NN_ROI_RELEASE_DELAY 30
+#define NN_ROI_SCAN_PERIOD 8
+
+/* Uncomment to run nn over NN_TILING_GRID x NN_TILING_GRID tiles of the field of view, one tile per frame in turn,
+ * instead of the whole field of view downscaled. Neighbour tiles overlap by at least NN_TILING_OVERLAP of their size.
+ * Detections of all tiles are merged across tile seams before tracking, after each result using latest result of
+ * other tiles, or once per sweep of all tiles when NN_TILING_SWEEP is 1.
+ */
+/* #define USE_NN_TILING */
+#define NN_TILING_GRID 2
+#define NN_TILING_OVERLAP (0.2)
+#define NN_TILING_SWEEP 0
+#define NN_TILING_IOU_THRESHOLD (0.5)
+#define NN_TILING_CONTAIN_THRESHOLD (0.7)
+#if defined(USE_NN_ROI) && defined(USE_NN_TILING)
+#error "USE_NN_ROI and USE_NN_TILING are exclusive"
+#endif
+
+/* nn pipe crop changes between frames */
+#if defined(USE_NN_ROI) || defined(USE_NN_TILING)
+#define APP_NN_CROP
+#endif
+
+/* Uncomment to stream usb display as MJPEG instead of YUY2. Frames are encoded by cpu with USB_JPEG_QUALITY from 1
+ * to 100. It divides usb bandwidth by about ten at the cost of encoding time.
+ */
+/* #define USE_USB_JPEG */
+#define USB_JPEG_QUALITY 75
+
+/* Task telemetry options, USE_TELEMETRY and TELEMETRY_PERIOD_MS, are in app_telemetry_conf.h */
+#include "app_telemetry_conf.h"
+
+/* Uncomment to record begin / end / instant events of threads and isr into a ring buffer. Send 'd' on console to
+ * dump it and use Scripts/trace2chrome.py to convert the dump into a chrome trace. Send 'c' to clear it.
+ */
+/* #define USE_TRACE */
+#define TRACE_RING_SIZE 2048
+
+/* Uncomment to measure DWT cycles spent in each nn layer. Every NN_PROFILER_RUN_NB inferences, a report with cycles
+ * per layer type and per layer, sorted by cost, is printed on console. Use Scripts/nn_profile_view.py to render it.
+ */
+/* #define USE_NN_PROFILER */
+#define NN_PROFILER_RUN_NB 20
+#define NN_PROFILER_LAYER_MAX 320
+
+/* Uncomment to run headless throughput benchmark. Display is not initialized and nn runs back to back on camera
+ * frames. After BENCHMARK_WARMUP_NB frames, a json report is printed on console every BENCHMARK_FRAME_NB frames.
+ * BENCHMARK_TEST_PATTERN selects a sensor specific test pattern, -1 to use live scene.
+ */
+/* #define USE_BENCHMARK */
+#define BENCHMARK_FRAME_NB 200
+#define BENCHMARK_WARMUP_NB 20
+#define BENCHMARK_TEST_PATTERN 0
+#ifdef USE_BENCHMARK
+/* measure what the pipeline can sustain, not what governor allows */
+#undef USE_GOVERNOR
+#endif
+
+/* Uncomment to send a compact binary record of each post process result (frame id, timestamp, stage timings,
+ * tracks or detections) on console uart. Use Scripts/metadata_decode.py to decode it. Up to METADATA_QUEUE_NB
+ * records wait for uart, further ones are dropped. Also uncomment METADATA_HEADLESS when no video is needed, display
+ * output, screen buffers and dma2d composition are then left out.
+ */
+/* #define USE_METADATA */
+/* #define METADATA_HEADLESS */
+#define METADATA_QUEUE_NB 4
+#if defined(METADATA_HEADLESS) && !defined(USE_METADATA)
+#error "METADATA_HEADLESS requires USE_METADATA"
+#endif
+
+/* No display output. Display camera pipe keeps running since isp update is driven by its vsync */
+#if defined(USE_BENCHMARK) || defined(METADATA_HEADLESS)
+#define APP_HEADLESS
+#endif
+
 #define NN_FORMAT DCMIPP_PIXEL_PACKER_FORMAT_RGB888_YUV444_1
 #define NN_BPP 3
 #define NB_CLASSES 2
@@ -0,0 +1,82 @@
+ /**
+ ******************************************************************************
+ * @file    app_metadata.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_METADATA
+#define APP_METADATA
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+/* Binary record sent on console uart for each post process result. All fields are little endian.
+ *
+ * header  : u8 sync0 (0xa5), u8 sync1 (0x5a), u8 version, u8 type, u16 payload length
+ * payload : u32 frame id, u32 timestamp ms, u32 inference us, u32 pp us, u32 tracking us, u8 flags, u8 box nb,
+ *           then box nb boxes of u32 id, s16 cx, s16 cy, s16 w, s16 h, u8 conf, u8 class
+ * trailer : u16 crc16 ccitt (poly 0x1021, init 0xffff) of version, type, payload length and payload
+ *
+ * Box coordinates are normalized to nn input size in Q2.14 fixed point, conf is scaled to 0..255. When
+ * META_FLAG_TRACKS is set boxes are tracks and carry tracker id, else they are detections with an id of zero.
+ * Keep in sync with Scripts/metadata_decode.py.
+ */
+#define META_SYNC0 0xa5
+#define META_SYNC1 0x5a
+#define META_VERSION 1
+#define META_TYPE_FRAME 1
+#define META_FLAG_TRACKS (1 << 0)
+/* more boxes than META_BOX_MAX were reported, only first ones have been sent */
+#define META_FLAG_TRUNCATED (1 << 1)
+#define META_BOX_MAX 32
+#define META_COORD_FRAC_BITS 14
+
+typedef enum {
+  META_STAGE_INFERENCE,
+  META_STAGE_PP,
+  META_STAGE_TRACKING,
+  META_STAGE_NB
+} META_Stage_t;
+
+#ifdef USE_METADATA
+void META_Init(void);
+uint32_t META_Now(void);
+/* Can be called from any thread. Duration is reported in next record */
+void META_StageDone(META_Stage_t stage, uint32_t start);
+/* Record building must happen from a single thread. Record is dropped if sender is late by METADATA_QUEUE_NB
+ * records. Frame id is incremented anyway so host sees the gap.
+ */
+void META_FrameBegin(int is_tracks);
+void META_AddBox(uint32_t id, float cx, float cy, float w, float h, float conf, int class_index);
+void META_FrameEnd(void);
+/* Console output must be wrapped by these so it never interleaves with a record on the uart. Lock waits for the
+ * record being sent, if any. It does nothing before scheduler start or META_Init(), or from interrupt, and then
+ * returns 0.
+ */
+int META_UartLock(void);
+void META_UartUnlock(int is_locked);
+#else
+#define META_Init() do { } while (0)
+#define META_Now() 0
+#define META_StageDone(_stage_, _start_) do { (void) (_start_); } while (0)
+#define META_FrameBegin(_is_tracks_) do { } while (0)
+#define META_AddBox(_id_, _cx_, _cy_, _w_, _h_, _conf_, _class_index_) do { } while (0)
+#define META_FrameEnd() do { } while (0)
+#define META_UartLock() 0
+#define META_UartUnlock(_is_locked_) do { (void) (_is_locked_); } while (0)
+#endif
+
+#endif
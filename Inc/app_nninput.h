@@ -0,0 +1,42 @@
+ /**
+ ******************************************************************************
+ * @file    app_nninput.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NNINPUT
+#define APP_NNINPUT
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+#ifdef USE_NN_SIGNED_INPUT
+#include "ai_platform.h"
+
+/* Unlink leading u8 to s8 conversion layer of an initialized network when it is an exact sign flip. Must be called
+ * before first inference and before any NNLAYER_First() walk.
+ */
+void NNIN_Init(ai_handle network);
+/* Flip sign of a frame in place and feed it to the first layer kept by NNIN_Init(). Frame is left untouched when no
+ * layer was unlinked. Caller owns cache maintenance of buffer.
+ */
+void NNIN_Convert(uint8_t *buffer, uint32_t len);
+#else
+#define NNIN_Init(_network_) do { (void) (_network_); } while (0)
+#define NNIN_Convert(_buffer_, _len_) do { (void) (_buffer_); (void) (_len_); } while (0)
+#endif
+
+#endif
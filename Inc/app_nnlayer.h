@@ -0,0 +1,38 @@
+ /**
+ ******************************************************************************
+ * @file    app_nnlayer.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NNLAYER
+#define APP_NNLAYER
+
+#include "ai_platform.h"
+#include "core_common.h"
+
+/* Walk layers of an initialized network in execution order:
+ *   for (node = NNLAYER_First(network); node; node = NNLAYER_Next(node))
+ */
+ai_node *NNLAYER_First(ai_handle network);
+/* Layer run after node, NULL after last one */
+ai_node *NNLAYER_Next(ai_node *node);
+/* Same as NNLAYER_First() for a walk that unlinks layers. Asserts no NNLAYER_First() walk was done yet, so other
+ * walkers only see layers that run.
+ */
+ai_node *NNLAYER_EditFirst(ai_handle network);
+/* Unlink node from layers run by network. prev is the layer run before it, NULL for first layer */
+void NNLAYER_Unlink(ai_handle network, ai_node *prev, ai_node *node);
+
+#endif
@@ -0,0 +1,42 @@
+ /**
+ ******************************************************************************
+ * @file    app_nnoutput.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NNOUTPUT
+#define APP_NNOUTPUT
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+#ifdef USE_NN_INT8_OUTPUT
+#include "ai_platform.h"
+
+/* Make all outputs of an initialized network int8. Trailing s8 to float conversion layers are unlinked, outputs
+ * generated as int8 are kept as is. Must be called before first inference and before any NNLAYER_First() walk.
+ */
+void NNOUT_Init(ai_handle network);
+/* Point int8 outputs to out[] buffers. Must be called before each inference */
+void NNOUT_Bind(uint8_t *out[]);
+/* Quantization of output idx, valid once NNOUT_Init() returned */
+void NNOUT_GetQuant(int idx, float *scale, int8_t *zero_point);
+#else
+#define NNOUT_Init(_network_) do { (void) (_network_); } while (0)
+#define NNOUT_Bind(_out_) do { (void) (_out_); } while (0)
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+ /**
+ ******************************************************************************
+ * @file    app_nnprof.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_NNPROF
+#define APP_NNPROF
+
+#include "app_config.h"
+
+#ifdef USE_NN_PROFILER
+#include "ai_platform.h"
+
+/* Register an observer on an initialized network. Cycles of each layer are then accumulated during inferences and a
+ * report is printed every NN_PROFILER_RUN_NB inferences, from the thread calling ai_network_run().
+ */
+void NNPROF_Init(ai_handle network);
+#else
+#define NNPROF_Init(_network_) do { (void) (_network_); } while (0)
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+ /**
+ ******************************************************************************
+ * @file    app_telemetry.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TELEMETRY
+#define APP_TELEMETRY
+
+#include <stdint.h>
+
+void TLM_Init(void);
+/* Called by kernel from traceTASK_SWITCHED_IN() */
+void TLM_TaskSwitchedIn(uint32_t task_nb);
+
+#endif
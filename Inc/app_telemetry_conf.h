@@ -0,0 +1,30 @@
+ /**
+ ******************************************************************************
+ * @file    app_telemetry_conf.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TELEMETRY_CONF
+#define APP_TELEMETRY_CONF
+
+/* Included by FreeRTOSConfig.h for its context switch hook, so it holds telemetry options only */
+
+/* Uncomment to periodically print per task cpu share, stack high water mark and context switch count as csv
+ * lines on console. Use Scripts/telemetry_view.py to display them.
+ */
+/* #define USE_TELEMETRY */
+#define TELEMETRY_PERIOD_MS 1000
+
+#endif
@@ -0,0 +1,71 @@
+ /**
+ ******************************************************************************
+ * @file    app_text.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TEXT
+#define APP_TEXT
+
+#include <stdint.h>
+
+#include "stm32_lcd.h"
+
+/* Printable ascii range covered by lcd utility fonts */
+#define TXT_GLYPH_FIRST ' '
+#define TXT_GLYPH_LAST '~'
+#define TXT_GLYPH_NB (TXT_GLYPH_LAST - TXT_GLYPH_FIRST + 1)
+
+/* Number of ARGB4444 pixels needed to hold the atlas of a _w_ x _h_ font */
+#define TXT_ATLAS_PIXELS(_w_, _h_) (TXT_GLYPH_NB * (_w_) * (_h_))
+
+/* Glyph size of lcd utility font _f_ (Font8 to Font24) as a constant expression, to size static buffers. sFONT fields
+ * can't be used there. TXT_Init() and TXT_RenderString() check buffers against the sFONT they are given.
+ */
+#define TXT_FONT_WIDTH(_f_) TXT_FONT_WIDTH_(_f_)
+#define TXT_FONT_HEIGHT(_f_) TXT_FONT_HEIGHT_(_f_)
+#define TXT_FONT_WIDTH_(_f_) TXT_WIDTH_##_f_
+#define TXT_FONT_HEIGHT_(_f_) TXT_HEIGHT_##_f_
+#define TXT_WIDTH_Font8 5
+#define TXT_HEIGHT_Font8 8
+#define TXT_WIDTH_Font12 7
+#define TXT_HEIGHT_Font12 12
+#define TXT_WIDTH_Font16 11
+#define TXT_HEIGHT_Font16 16
+#define TXT_WIDTH_Font20 14
+#define TXT_HEIGHT_Font20 20
+#define TXT_WIDTH_Font24 17
+#define TXT_HEIGHT_Font24 24
+
+typedef struct {
+  int width;
+  int height;
+  const uint16_t *pixels;
+  int pitch;                /* pixels between two rows */
+} TXT_Bitmap_t;
+
+/* Text renderer writing whole glyph rows straight into an ARGB4444 frame buffer. It has no global buffer, so it can
+ * be used from several threads as long as they don't draw into the same frame buffer.
+ */
+int TXT_Init(sFONT *font, uint32_t text_color, uint32_t back_color, uint16_t *atlas, int atlas_pixels);
+int TXT_GetGlyphWidth(void);
+int TXT_GetGlyphHeight(void);
+/* Render text once into pixels so it can later be drawn with a single TXT_DrawBitmap() */
+int TXT_RenderString(const char *text, TXT_Bitmap_t *bmp, uint16_t *pixels, int pixels_nb);
+/* Draw clipped to a fb_width x fb_height frame buffer. Returns drawn width in pixels */
+int TXT_DrawBitmap(uint16_t *fb, int fb_width, int fb_height, int x, int y, const TXT_Bitmap_t *bmp);
+int TXT_DrawString(uint16_t *fb, int fb_width, int fb_height, int x, int y, const char *text);
+
+#endif
@@ -0,0 +1,83 @@
+ /**
+ ******************************************************************************
+ * @file    app_trace.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_TRACE
+#define APP_TRACE
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+/* Keep in sync with trc_names[] in app_trace.c */
+typedef enum {
+  TRC_ID_NN_RUN,
+  TRC_ID_NN_WAIT,
+  TRC_ID_PP_RUN,
+  TRC_ID_PP_TRACK,
+  TRC_ID_DP_DRAW,
+  TRC_ID_DP_CACHE,
+  TRC_ID_ISP_UPDATE,
+  TRC_ID_GOV_UPDATE,
+  TRC_ID_GOV_IDLE,
+  TRC_ID_CAM_VSYNC,
+  TRC_ID_CAM_FRAME,
+  TRC_ID_NN_FRAME_DROP,
+  TRC_ID_NN_MISS,
+  TRC_ID_NN_DEGRADE,
+  TRC_ID_SCRL_UPDATE,
+  TRC_ID_SCRL_DMA2D,
+  TRC_ID_SCRL_YUV,
+  TRC_ID_SCRL_SHOW,
+  TRC_ID_SCRL_RELEASE,
+  TRC_ID_SCRL_SPI,
+  TRC_ID_SCRL_CPU_COMPOSE,
+  TRC_ID_SCRL_JPEG,
+  TRC_ID_NB
+} TRC_Id_t;
+
+typedef enum {
+  TRC_TYPE_BEGIN,
+  TRC_TYPE_END,
+  TRC_TYPE_INSTANT,
+  /* begin / end pair that may happen on different contexts (thread -> isr) */
+  TRC_TYPE_ASYNC_BEGIN,
+  TRC_TYPE_ASYNC_END,
+} TRC_Type_t;
+
+#ifdef USE_TRACE
+void TRC_Init(void);
+void TRC_Record(uint32_t type, uint32_t id, uint32_t arg);
+void TRC_Dump(void);
+
+#define TRACE_BEGIN(_id_) TRC_Record(TRC_TYPE_BEGIN, _id_, 0)
+#define TRACE_END(_id_) TRC_Record(TRC_TYPE_END, _id_, 0)
+#define TRACE_INSTANT(_id_, _arg_) TRC_Record(TRC_TYPE_INSTANT, _id_, _arg_)
+#define TRACE_ASYNC_BEGIN(_id_) TRC_Record(TRC_TYPE_ASYNC_BEGIN, _id_, 0)
+#define TRACE_ASYNC_END(_id_) TRC_Record(TRC_TYPE_ASYNC_END, _id_, 0)
+#else
+#define TRC_Init() do { } while (0)
+#define TRC_Dump() do { } while (0)
+
+#define TRACE_BEGIN(_id_) do { } while (0)
+#define TRACE_END(_id_) do { } while (0)
+#define TRACE_INSTANT(_id_, _arg_) do { } while (0)
+#define TRACE_ASYNC_BEGIN(_id_) do { } while (0)
+#define TRACE_ASYNC_END(_id_) do { } while (0)
+#endif
+
+#endif
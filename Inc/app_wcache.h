@@ -0,0 +1,40 @@
+ /**
+ ******************************************************************************
+ * @file    app_wcache.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef APP_WCACHE
+#define APP_WCACHE
+
+#include <stdint.h>
+
+#include "app_config.h"
+
+#ifdef USE_WEIGHT_CACHE
+#include "ai_platform.h"
+
+/* Copy hottest weight tensors of an initialized network from external flash into internal ram, up to
+ * WEIGHT_CACHE_SIZE bytes, and rebind them. Must be called before first inference.
+ */
+void WCACHE_Init(ai_handle network);
+/* Number of weight bytes read from internal ram */
+uint32_t WCACHE_Used(void);
+#else
+#define WCACHE_Init(_network_) do { (void) (_network_); } while (0)
+#define WCACHE_Used() 0
+#endif
+
+#endif
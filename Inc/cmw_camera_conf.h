@@ -48,6 +48,10 @@ extern "C" {
 
 /* This is defined in Makefile or project */
 
+/* Route dcmipp callbacks trace hooks to event trace */
+#include "app_trace.h"
+#define CMW_TRACE_BEGIN(_ev_) TRACE_BEGIN(TRC_ID_CAM_##_ev_)
+#define CMW_TRACE_END(_ev_) TRACE_END(TRC_ID_CAM_##_ev_)
 
 #ifdef __cplusplus
 }
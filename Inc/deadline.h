@@ -0,0 +1,65 @@
+ /**
+ ******************************************************************************
+ * @file    deadline.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef _DEADLINE_
+#define _DEADLINE_ 1
+
+#include <stdint.h>
+
+/* Host checked by Scripts/deadline_check.py */
+
+/* latency histogram buckets, see dl_hist_bound() */
+#define DL_HIST_NB 8
+#define DL_WINDOW_MAX 32
+
+typedef struct {
+  uint32_t budget_ms;         /* inference deadline */
+  int window;                 /* misses are counted over this number of last inferences, up to DL_WINDOW_MAX */
+  int degrade_nb;             /* degrade once window holds this number of misses ... */
+  int recover_nb;             /* ... until it holds no more than this number */
+} dl_conf_t;
+
+typedef struct {
+  uint32_t run_nb;
+  uint32_t miss_nb;           /* failed inferences included */
+  uint32_t error_nb;
+  uint32_t error;             /* last error, 0 if none */
+  uint32_t error_run;         /* run number of last error */
+  uint32_t last_ms;
+  uint32_t worst_ms;
+  uint32_t hist[DL_HIST_NB];
+  int window_miss_nb;
+  int is_degraded;
+  uint32_t degrade_nb;        /* number of times degraded mode was entered */
+} dl_stats_t;
+
+typedef struct {
+  dl_conf_t cfg;
+  uint32_t window;            /* one bit per inference of window, newest in bit 0, set on miss */
+  dl_stats_t st;
+} dl_ctx_t;
+
+int dl_init(dl_ctx_t *ctx, dl_conf_t *cfg);
+/* Account an inference of ms duration. error is 0 on success, a failed inference counts as a miss. Return 1 when
+ * degraded mode was entered or left.
+ */
+int dl_update(dl_ctx_t *ctx, uint32_t ms, uint32_t error);
+/* Histogram bucket idx holds latencies below this bound, UINT32_MAX for last one */
+uint32_t dl_hist_bound(const dl_ctx_t *ctx, int idx);
+
+#endif
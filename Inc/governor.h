@@ -0,0 +1,95 @@
+ /**
+ ******************************************************************************
+ * @file    governor.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef _GOVERNOR_
+#define _GOVERNOR_ 1
+
+#include <stdint.h>
+
+/* Host checked and replayed by Scripts/governor_sim.py */
+
+typedef struct {
+  float cpu_budget;           /* target cpu load in percent */
+  uint32_t pp_latency_ms;     /* target post process latency */
+  uint32_t nn_period_min_ms;
+  uint32_t nn_period_max_ms;
+  float conf_min;
+  float conf_max;
+  float conf_step;
+  int max_boxes_min;
+  int max_boxes_max;
+  int disp_divider_max;
+  uint32_t idle_delay_ms;     /* switch to idle mode after this time without objects, 0 to never idle */
+  uint32_t idle_nn_period_ms; /* minimum period between two inferences in idle mode */
+} gov_conf_t;
+
+typedef struct {
+  uint32_t ts_ms;
+  float cpu_load;             /* cpu load in percent since previous sample */
+  uint32_t nn_period_ms;
+  uint32_t inf_ms;
+  uint32_t pp_ms;
+  uint32_t disp_ms;
+  int nb_detect;
+  int nb_candidates;          /* boxes above threshold before nms and max_boxes cap, -1 if unknown */
+  int nb_tracks;              /* -1 when tracking is disabled */
+  int nb_lost;                /* tracks kept on prediction only, -1 when tracking is disabled */
+} gov_sample_t;
+
+typedef struct {
+  uint32_t nn_period_ms;      /* minimum period between two inferences */
+  float conf_threshold;
+  int max_boxes;
+  int disp_divider;           /* refresh display once every disp_divider pp results */
+  int is_idle;                /* nothing seen for idle_delay_ms */
+} gov_setpoint_t;
+
+typedef struct {
+  const char *name;
+  void (*init)(void *priv, const gov_conf_t *cfg, gov_setpoint_t *sp);
+  void (*update)(void *priv, const gov_conf_t *cfg, const gov_sample_t *s, gov_setpoint_t *sp);
+} gov_policy_t;
+
+/* gov_policy_presence private state */
+typedef struct {
+  uint32_t last_seen_ms;
+  uint32_t nn_period_ms;      /* active mode nn period, restored when leaving idle mode */
+} gov_presence_t;
+
+typedef struct {
+  gov_conf_t cfg;
+  const gov_policy_t *policy;
+  void *priv;
+  gov_setpoint_t sp;
+} gov_ctx_t;
+
+/* Keep setpoint at its initial value. Useful as a reference */
+extern const gov_policy_t gov_policy_fixed;
+/* Additive decrease / multiplicative increase of nn period driven by cpu load. Confidence threshold and max boxes
+ * are driven by post process latency.
+ */
+extern const gov_policy_t gov_policy_aimd;
+/* gov_policy_aimd while objects or lost tracks are present, idle_nn_period_ms once nothing was seen for
+ * idle_delay_ms. priv is a gov_presence_t.
+ */
+extern const gov_policy_t gov_policy_presence;
+
+int gov_init(gov_ctx_t *ctx, gov_conf_t *cfg, const gov_policy_t *policy, void *priv);
+void gov_update(gov_ctx_t *ctx, const gov_sample_t *s);
+
+#endif
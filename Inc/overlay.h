@@ -0,0 +1,57 @@
+ /**
+ ******************************************************************************
+ * @file    overlay.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef _OVERLAY_
+#define _OVERLAY_ 1
+
+#include <stdint.h>
+
+/* Host checked by Scripts/overlay_bench.py.
+ *
+ * Areas drawn into one overlay frame buffer, 2 bytes per pixel, so next draw into this buffer only erases and writes
+ * back those areas.
+ */
+
+typedef struct
+{
+  uint32_t X0;
+  uint32_t Y0;
+  uint32_t XSize;
+  uint32_t YSize;
+} Rectangle_TypeDef;
+
+typedef struct {
+  int width;                  /* frame buffer size in pixels */
+  int height;
+  Rectangle_TypeDef *rects;
+  int rect_max;
+  int nb;
+  int is_overflow;            /* more than rect_max areas were drawn, whole frame buffer must be handled */
+} ovl_dirty_t;
+
+void ovl_dirty_init(ovl_dirty_t *dirty, int width, int height, Rectangle_TypeDef *rects, int rect_max);
+/* Record area clipped to frame buffer. Empty areas are dropped */
+void ovl_dirty_add(ovl_dirty_t *dirty, int x, int y, int w, int h);
+void ovl_dirty_reset(ovl_dirty_t *dirty);
+int ovl_is_overlapping(const Rectangle_TypeDef *a, const Rectangle_TypeDef *b);
+/* Byte ranges covering r in a frame buffer of given width, for cache maintenance. Start with *row at 0, each call
+ * returns length of next range starting at byte *offset, 0 once r is covered.
+ */
+int ovl_range_next(const Rectangle_TypeDef *r, int width, int *row, uint32_t *offset);
+
+#endif
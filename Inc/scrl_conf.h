@@ -0,0 +1,31 @@
+ /**
+ ******************************************************************************
+ * @file    scrl_conf.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef SCRL_CONF
+#define SCRL_CONF
+
+#include "app_trace.h"
+
+/* Route screen library trace hooks to event trace */
+#define SCRL_TRACE_BEGIN(_ev_) TRACE_BEGIN(TRC_ID_SCRL_##_ev_)
+#define SCRL_TRACE_END(_ev_) TRACE_END(TRC_ID_SCRL_##_ev_)
+#define SCRL_TRACE_INSTANT(_ev_, _arg_) TRACE_INSTANT(TRC_ID_SCRL_##_ev_, _arg_)
+#define SCRL_TRACE_ASYNC_BEGIN(_ev_) TRACE_ASYNC_BEGIN(TRC_ID_SCRL_##_ev_)
+#define SCRL_TRACE_ASYNC_END(_ev_) TRACE_ASYNC_END(TRC_ID_SCRL_##_ev_)
+
+#endif
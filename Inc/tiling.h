@@ -0,0 +1,79 @@
+ /**
+ ******************************************************************************
+ * @file    tiling.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef _TILING_
+#define _TILING_ 1
+
+#include "zoom.h"
+
+/* Tiles are zoom rois, so coordinates follow zoom.h conventions. Host checked by Scripts/tile_merge_bench.py */
+
+#define TILE_MAX 16
+
+/* box sides touching an inner tile border. Object likely continues in neighbour tile */
+#define TILE_CUT_LEFT   (1 << 0)
+#define TILE_CUT_RIGHT  (1 << 1)
+#define TILE_CUT_TOP    (1 << 2)
+#define TILE_CUT_BOTTOM (1 << 3)
+
+typedef struct {
+  float cx;
+  float cy;
+  float w;
+  float h;
+  float conf;
+  int class_index;
+  int tile;
+  int cut;                    /* TILE_CUT_* */
+} tile_box_t;
+
+typedef struct {
+  int grid;                   /* grid x grid tiles */
+  float overlap;              /* minimum overlap of neighbour tiles, as a fraction of tile size */
+  float min_size;             /* smallest tile side */
+  int is_sweep;               /* merge once all tiles have a new result instead of after each result */
+  float iou_thresh;           /* boxes overlapping more are the same object */
+  float contain_thresh;       /* boxes of two tiles whose intersection covers this fraction of smaller one are too */
+  float cut_margin;           /* box side closer to an inner tile border than this fraction of tile is cut */
+} tile_conf_t;
+
+typedef struct {
+  tile_conf_t cfg;
+  int tile_nb;
+  zoom_roi_t tiles[TILE_MAX];
+  int next;
+  /* latest result of each tile, box_max boxes per tile */
+  int box_max;
+  tile_box_t *boxes;
+  int box_nb[TILE_MAX];
+  tile_box_t *work;
+  unsigned int fresh;         /* tiles with a result since last merge */
+} tile_ctx_t;
+
+/* boxes and work are both arrays of grid * grid * box_max boxes */
+int tile_init(tile_ctx_t *ctx, tile_conf_t *cfg, int box_max, tile_box_t *boxes, tile_box_t *work);
+/* Tile to capture next, round robin */
+int tile_next(tile_ctx_t *ctx);
+/* Store result of tile captured with roi. Boxes are given in tile coordinates and are mapped to full field of view
+ * in place. Return 1 when it's time to merge.
+ */
+int tile_add(tile_ctx_t *ctx, int tile, const zoom_roi_t *roi, int nb, tile_box_t *boxes);
+/* Merge latest result of all tiles into out, highest confidence first. Return number of boxes written */
+int tile_merge(tile_ctx_t *ctx, int out_max, tile_box_t *out);
+
+#endif
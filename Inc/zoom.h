@@ -0,0 +1,66 @@
+ /**
+ ******************************************************************************
+ * @file    zoom.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef _ZOOM_
+#define _ZOOM_ 1
+
+/* Host checked by Scripts/zoom_sim.py.
+ *
+ * All coordinates are normalized to nn full field of view, [0, 1] on both axes. A roi keeps full field of view aspect
+ * ratio, so nn sees people with the same proportions whatever the zoom level.
+ */
+
+typedef struct {
+  float x;                    /* top left corner */
+  float y;
+  float size;                 /* side, 1 for full field of view */
+} zoom_roi_t;
+
+typedef struct {
+  float cx;
+  float cy;
+  float w;
+  float h;
+} zoom_box_t;
+
+typedef struct {
+  float margin;               /* boxes hull grows by this fraction of its size on each side */
+  float min_size;             /* smallest roi side */
+  float hysteresis;           /* roi shrinks once hull needs a side this fraction smaller ... */
+  int shrink_delay;           /* ... during this number of consecutive updates */
+  int release_delay;          /* updates without any box before going back to full field of view */
+  int scan_period;            /* one update out of scan_period requests full field of view, 0 to never scan */
+} zoom_conf_t;
+
+typedef struct {
+  zoom_conf_t cfg;
+  zoom_roi_t roi;
+  int shrink_cnt;
+  int empty_cnt;
+  int update_cnt;
+} zoom_ctx_t;
+
+extern const zoom_roi_t zoom_roi_full;
+
+int zoom_init(zoom_ctx_t *ctx, zoom_conf_t *cfg);
+/* Select roi of next frames from boxes of last result, boxes being in full field of view coordinates */
+void zoom_update(zoom_ctx_t *ctx, int nb, const zoom_box_t *boxes, zoom_roi_t *roi);
+/* Map a box found in a frame captured with roi back to full field of view coordinates */
+void zoom_remap(const zoom_roi_t *roi, float *cx, float *cy, float *w, float *h);
+
+#endif
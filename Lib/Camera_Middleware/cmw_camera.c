@@ -19,6 +19,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "cmw_camera.h"
+#include "cmw_trace.h"
 
 #include "isp_api.h"
 #include "stm32n6xx_hal_dcmipp.h"
@@ -747,11 +748,13 @@ __weak int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe)
 void HAL_DCMIPP_PIPE_VsyncEventCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t Pipe)
 {
   UNUSED(hdcmipp);
+  CMW_TRACE_BEGIN(VSYNC);
   if(Camera_Drv.VsyncEventCallback != NULL)
   {
       Camera_Drv.VsyncEventCallback(&camera_bsp, Pipe);
   }
   CMW_CAMERA_PIPE_VsyncEventCallback(Pipe);
+  CMW_TRACE_END(VSYNC);
 }
 
 /**
@@ -763,11 +766,13 @@ void HAL_DCMIPP_PIPE_VsyncEventCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t
 void HAL_DCMIPP_PIPE_FrameEventCallback(DCMIPP_HandleTypeDef *hdcmipp, uint32_t Pipe)
 {
   UNUSED(hdcmipp);
+  CMW_TRACE_BEGIN(FRAME);
   if(Camera_Drv.FrameEventCallback != NULL)
   {
       Camera_Drv.FrameEventCallback(&camera_bsp, Pipe);
   }
   CMW_CAMERA_PIPE_FrameEventCallback(Pipe);
+  CMW_TRACE_END(FRAME);
 }
 
 /**
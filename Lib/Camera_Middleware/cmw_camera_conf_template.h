@@ -45,6 +45,10 @@ extern "C" {
 #define USE_VD66GY_SENSOR
 #define USE_VD55G1_SENSOR
 
+/* Optional trace hooks around dcmipp event callbacks, see cmw_trace.h */
+/* #define CMW_TRACE_BEGIN(_ev_) */
+/* #define CMW_TRACE_END(_ev_) */
+
 #ifdef __cplusplus
 }
 #endif
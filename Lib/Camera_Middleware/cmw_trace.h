@@ -0,0 +1,34 @@
+ /**
+ ******************************************************************************
+ * @file    cmw_trace.h
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CMW_TRACE_H
+#define CMW_TRACE_H
+
+/* Trace hooks around dcmipp event callbacks. Application may define them in cmw_camera_conf.h, they are empty
+ * otherwise. _ev_ is VSYNC or FRAME.
+ */
+#include "cmw_camera_conf.h"
+
+#ifndef CMW_TRACE_BEGIN
+#define CMW_TRACE_BEGIN(_ev_) do { } while (0)
+#endif
+#ifndef CMW_TRACE_END
+#define CMW_TRACE_END(_ev_) do { } while (0)
+#endif
+
+#endif /* CMW_TRACE_H */
@@ -32,13 +32,16 @@ int32_t app_postprocess_init(void *params_postprocess, NN_Instance_TypeDef *NN_I
 {
   int32_t error = AI_OD_POSTPROCESS_ERROR_NO;
   od_st_yolox_pp_static_param_t *params = (od_st_yolox_pp_static_param_t *) params_postprocess;
-  const LL_Buffer_InfoTypeDef *buffers_info = LL_ATON_Output_Buffers_Info(NN_Instance);
-  params->raw_s_scale = *(buffers_info[0].scale);
-  params->raw_s_zero_point = *(buffers_info[0].offset);
-  params->raw_l_scale = *(buffers_info[1].scale);
-  params->raw_l_zero_point = *(buffers_info[1].offset);
-  params->raw_m_scale = *(buffers_info[2].scale);
-  params->raw_m_zero_point = *(buffers_info[2].offset);
+  /* Without npu instance, caller fills raw scales and zero points from its own runtime */
+  if (NN_Instance) {
+    const LL_Buffer_InfoTypeDef *buffers_info = LL_ATON_Output_Buffers_Info(NN_Instance);
+    params->raw_s_scale = *(buffers_info[0].scale);
+    params->raw_s_zero_point = *(buffers_info[0].offset);
+    params->raw_l_scale = *(buffers_info[1].scale);
+    params->raw_l_zero_point = *(buffers_info[1].offset);
+    params->raw_m_scale = *(buffers_info[2].scale);
+    params->raw_m_zero_point = *(buffers_info[2].offset);
+  }
   params->nb_classes = AI_OD_ST_YOLOX_PP_NB_CLASSES;
   params->nb_anchors = AI_OD_ST_YOLOX_PP_NB_ANCHORS;
   params->grid_width_L = AI_OD_ST_YOLOX_PP_L_GRID_WIDTH;
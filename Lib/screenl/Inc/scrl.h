@@ -16,9 +16,16 @@ typedef enum {
   SCRL_ARGB8888,/* AKA st ABGR888 */
   SCRL_RGB888, /* AKA st BGR888 */
   SCRL_BGR888, /* AKA st RGB888 */
+  SCRL_JPEG, /* Only as UVCL screen format */
   SCRL_FORMAT_NB
 } SCRL_Format;
 
+typedef enum {
+  SCRL_COMPOSITION_HW,    /* default. Layers are blended by hardware */
+  SCRL_COMPOSITION_CPU,   /* Layers are blended and converted by cpu in a single pass. UVCL with YUV422 output only */
+  SCRL_COMPOSITION_AUTO,  /* Use fastest one, fallback to cpu when hardware is busy */
+} SCRL_Composition;
+
 typedef struct {
   uint16_t x;
   uint16_t y;
@@ -29,6 +36,11 @@ typedef struct {
   uint16_t height;
 } SCRL_Size;
 
+typedef struct {
+  SCRL_Point origin;
+  SCRL_Size size;
+} SCRL_Rect;
+
 typedef struct {
   SCRL_Point origin;
   SCRL_Size size;
@@ -41,6 +53,13 @@ typedef struct {
   SCRL_Format format;
   void *address;
   uint16_t fps;
+  /* address holds buffer_nb consecutive screen buffers used in turn. 0 means 1. Only use in UVCL mode */
+  int buffer_nb;
+  /* SCRL_JPEG only. Layers are composed as SCRL_YUV422 into composition_address then encoded into screen buffers.
+   * Each screen buffer is width * height bytes long. jpeg_quality goes from 1 to 100, 0 selects a default value.
+   */
+  void *composition_address;
+  int jpeg_quality;
 } SCRL_ScreenConfig;
 
 /* Initialize scrl subsystem
@@ -72,5 +91,14 @@ int SCRL_ReloadLayer(SCRL_Layer layer);
  * return 0 in case of success else negative value is returned
  */
 int SRCL_Update(void);
+/* Select how layers are composed into screen. Only UVCL mode supports SCRL_COMPOSITION_CPU, other modes treat
+ * SCRL_COMPOSITION_AUTO as SCRL_COMPOSITION_HW. SCRL_COMPOSITION_AUTO times both methods with DWT_CYCCNT, which must
+ * be enabled by the caller.
+ *
+ * composition : composition mode
+ *
+ * return 0 in case of success else negative value is returned
+ */
+int SCRL_SetComposition(SCRL_Composition composition);
 
 #endif
@@ -0,0 +1,23 @@
+#ifndef _SCRL_RASTER_
+#define _SCRL_RASTER_
+
+#include <stdint.h>
+
+/* Span based software rasterizer used by common drivers. It has no hardware dependency so it can also be built on
+ * host.
+ * - 16 bits variants are format agnostic and serve both RGB565 and ARGB4444 layers.
+ * - 24 bits variants take color as 0x00RRGGBB and store it as b, g, r bytes.
+ * - pitch is the number of pixels between two rows.
+ * Callers are in charge of clipping.
+ */
+void SCRR_FillSpan16(uint16_t *dst, int n, uint16_t color);
+void SCRR_FillSpan24(uint8_t *dst, int n, uint32_t color);
+void SCRR_FillRect16(uint16_t *dst, int pitch, int w, int h, uint16_t color);
+void SCRR_FillRect24(uint8_t *dst, int pitch, int w, int h, uint32_t color);
+void SCRR_VLine16(uint16_t *dst, int pitch, int h, uint16_t color);
+void SCRR_VLine24(uint8_t *dst, int pitch, int h, uint32_t color);
+/* src rows are src_pitch pixels apart and have no alignment constraint */
+void SCRR_CopyRect16(uint16_t *dst, int pitch, const uint8_t *src, int src_pitch, int w, int h);
+void SCRR_CopyRect24(uint8_t *dst, int pitch, const uint8_t *src, int src_pitch, int w, int h);
+
+#endif
@@ -3,6 +3,9 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include "scrl_trace.h"
+#include "scrl_raster.h"
+
 #define container_of(ptr, type, member) (type *) ((unsigned char *)ptr - offsetof(type,member))
 
 /* Store current DMA2D_HandleTypeDef instance so we can propagate to irq handler */
@@ -26,26 +29,42 @@ static uint32_t cvt_lcd_pixel_format(SCRL_Format fmt)
   return LCD_PIXEL_FORMAT_RGB565;
 }
 
+/* Clip rectangle against current layer. Return 0 when nothing is left to draw */
+static int cmn_clip(struct scrl_common_ctx *ctx, uint32_t Xpos, uint32_t Ypos, uint32_t *Width, uint32_t *Height)
+{
+  uint32_t layer_width = ctx->layers[ctx->layer].size.width;
+  uint32_t layer_height = ctx->layers[ctx->layer].size.height;
+
+  if (Xpos >= layer_width || Ypos >= layer_height)
+    return 0;
+  *Width = *Width < layer_width - Xpos ? *Width : layer_width - Xpos;
+  *Height = *Height < layer_height - Ypos ? *Height : layer_height - Ypos;
+
+  return *Width && *Height;
+}
+
+static uint16_t *cmn_pel_bpp2(struct scrl_common_ctx *ctx, uint32_t Xpos, uint32_t Ypos)
+{
+  return (uint16_t *) ctx->layers[ctx->layer].address + (Ypos * ctx->layers[ctx->layer].size.width) + Xpos;
+}
+
+static uint8_t *cmn_pel_bpp3(struct scrl_common_ctx *ctx, uint32_t Xpos, uint32_t Ypos)
+{
+  return (uint8_t *) ctx->layers[ctx->layer].address + ((Ypos * ctx->layers[ctx->layer].size.width) + Xpos) * 3;
+}
+
 static int32_t SPI_FillRGBRectBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint8_t *pData, uint32_t Width,
                                    uint32_t Height)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint16_t *pel;
-  int w, h;
+  uint32_t src_pitch = Width;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = (uint16_t *) ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width) + Xpos;
-  for (h = 0; h < Height; h++) {
-    for (w = 0; w < Width; w++) {
-      pel[w] = *(uint16_t *)pData;
-      pData += 2;
-    }
-    pel += layer_width;
-  }
+  if (!cmn_clip(ctx, Xpos, Ypos, &Width, &Height))
+    return 0;
+  SCRR_CopyRect16(cmn_pel_bpp2(ctx, Xpos, Ypos), ctx->layers[ctx->layer].size.width, pData, src_pitch, Width,
+                  Height);
 
   return 0;
 }
@@ -53,17 +72,13 @@ static int32_t SPI_FillRGBRectBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Yp
 static int32_t SPI_DrawHLineBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint16_t *pel;
-  int i;
+  uint32_t height = 1;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = (uint16_t *) ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width) + Xpos;
-  for (i = 0; i < Length; i++)
-    *pel++ = Color;
+  if (!cmn_clip(ctx, Xpos, Ypos, &Length, &height))
+    return 0;
+  SCRR_FillSpan16(cmn_pel_bpp2(ctx, Xpos, Ypos), Length, Color);
 
   return 0;
 }
@@ -71,19 +86,13 @@ static int32_t SPI_DrawHLineBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos
 static int32_t SPI_DrawVLineBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint16_t *pel;
-  int i;
+  uint32_t width = 1;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = (uint16_t *) ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width) + Xpos;
-  for (i = 0; i < Length; i++) {
-    *pel = Color;
-    pel += layer_width;
-  }
+  if (!cmn_clip(ctx, Xpos, Ypos, &width, &Length))
+    return 0;
+  SCRR_VLine16(cmn_pel_bpp2(ctx, Xpos, Ypos), ctx->layers[ctx->layer].size.width, Length, Color);
 
   return 0;
 }
@@ -92,21 +101,12 @@ static int32_t SPI_FillRectBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos,
                            uint32_t Color)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint16_t *pel;
-  int w, h;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = (uint16_t *) ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width) + Xpos;
-  for (h = 0; h < Height; h++) {
-    for (w = 0; w < Width; w++) {
-      pel[w] = Color;
-    }
-    pel += layer_width;
-  }
+  if (!cmn_clip(ctx, Xpos, Ypos, &Width, &Height))
+    return 0;
+  SCRR_FillRect16(cmn_pel_bpp2(ctx, Xpos, Ypos), ctx->layers[ctx->layer].size.width, Width, Height, Color);
 
   return 0;
 }
@@ -114,15 +114,14 @@ static int32_t SPI_FillRectBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos,
 static int32_t SPI_SetPixelBpp2(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Color)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint16_t *pel;
+  uint32_t width = 1;
+  uint32_t height = 1;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = (uint16_t *) ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width) + Xpos;
-  *pel = Color;
+  if (!cmn_clip(ctx, Xpos, Ypos, &width, &height))
+    return 0;
+  *cmn_pel_bpp2(ctx, Xpos, Ypos) = Color;
 
   return 0;
 }
@@ -139,23 +138,14 @@ static int32_t SPI_FillRGBRectBpp3(uint32_t Instance, uint32_t Xpos, uint32_t Yp
                                    uint32_t Height)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint8_t *pel;
-  int w, h;
+  uint32_t src_pitch = Width;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width * 3) + Xpos * 3;
-  for (h = 0; h < Height; h++) {
-    for (w = 0; w < Width; w++) {
-      pel[3 * w + 0] = *pData++;
-      pel[3 * w + 1] = *pData++;
-      pel[3 * w + 2] = *pData++;
-    }
-    pel += layer_width + 3;
-  }
+  if (!cmn_clip(ctx, Xpos, Ypos, &Width, &Height))
+    return 0;
+  SCRR_CopyRect24(cmn_pel_bpp3(ctx, Xpos, Ypos), ctx->layers[ctx->layer].size.width, pData, src_pitch, Width,
+                  Height);
 
   return 0;
 }
@@ -164,29 +154,13 @@ static int32_t SPI_FillRectBpp3(uint32_t Instance, uint32_t Xpos, uint32_t Ypos,
                            uint32_t Color)
 {
   struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
-  int layer_width;
-  uint8_t r, g, b;
-  uint8_t *pel;
-  int w, h;
-
-  r = (Color >> 16) & 0xff;
-  g = (Color >> 8) & 0xff;
-  b = (Color >> 0) & 0xff;
 
   assert(ctx);
 
-  layer_width = ctx->layers[ctx->layer].size.width;
-  pel = ctx->layers[ctx->layer].address;
-  pel += (Ypos * layer_width * 3) + Xpos * 3;
-  for (h = 0; h < Height; h++) {
-    for (w = 0; w < Width; w++) {
-      /* FIXME */
-      pel[3 * w + 0] = b;
-      pel[3 * w + 1] = g;
-      pel[3 * w + 2] = r;
-    }
-    pel += layer_width * 3;
-  }
+  if (!cmn_clip(ctx, Xpos, Ypos, &Width, &Height))
+    return 0;
+  /* FIXME : color is stored as b, g, r whatever layer is SCRL_RGB888 or SCRL_BGR888 */
+  SCRR_FillRect24(cmn_pel_bpp3(ctx, Xpos, Ypos), ctx->layers[ctx->layer].size.width, Width, Height, Color);
 
   return 0;
 }
@@ -198,7 +172,16 @@ static int32_t SPI_DrawHLineBpp3(uint32_t Instance, uint32_t Xpos, uint32_t Ypos
 
 static int32_t SPI_DrawVLineBpp3(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Length, uint32_t Color)
 {
-  return SPI_FillRectBpp3(Instance, Xpos, Ypos, 1 , Length, Color);
+  struct scrl_common_ctx *ctx = (struct scrl_common_ctx *) Instance;
+  uint32_t width = 1;
+
+  assert(ctx);
+
+  if (!cmn_clip(ctx, Xpos, Ypos, &width, &Length))
+    return 0;
+  SCRR_VLine24(cmn_pel_bpp3(ctx, Xpos, Ypos), ctx->layers[ctx->layer].size.width, Length, Color);
+
+  return 0;
 }
 
 static int32_t SPI_SetPixelBpp3(uint32_t Instance, uint32_t Xpos, uint32_t Ypos, uint32_t Color)
@@ -396,6 +379,7 @@ static void SCRC_dma2d_cb(DMA2D_HandleTypeDef *hdma2d)
   struct scrl_common_ctx *ctx = container_of(hdma2d, struct scrl_common_ctx, hdma2d);
   int ret;
 
+  SCRL_TRACE_ASYNC_END(DMA2D);
   HAL_NVIC_DisableIRQ(DMA2D_IRQn);
   ret = HAL_DMA2D_DeInit(&ctx->hdma2d);
   assert(ret == HAL_OK);
@@ -494,6 +478,7 @@ void SCRC_Composition_Start(struct scrl_common_ctx *ctx, int is_output_byte_swap
   ctx->hdma2d.XferCpltCallback = SCRC_dma2d_cb;
   ctx->hdma2d.XferErrorCallback = SCRC_dma2d_error_cb;
   HAL_NVIC_EnableIRQ(DMA2D_IRQn);
+  SCRL_TRACE_ASYNC_BEGIN(DMA2D);
   ret = HAL_DMA2D_BlendingStart_IT(&ctx->hdma2d, src_buffer[1], src_buffer[0], dst_buffer, ctx->layers[0].size.width,
                                    ctx->layers[0].size.height);
   assert(ret == HAL_OK);
@@ -0,0 +1,145 @@
+#include "scrl_damage.h"
+
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b)  (((a) < (b)) ? (a) : (b))
+#endif /* MIN */
+#ifndef MAX
+#define MAX(a, b)  (((a) > (b)) ? (a) : (b))
+#endif /* MAX */
+
+static int rect_cost(SCRD_Damage *damage, const SCRL_Rect *r)
+{
+  int cost = SCRD_WINDOW_COST + r->size.width * r->size.height;
+
+  if (r->size.width != damage->screen.width)
+    cost += SCRD_ROW_COST * r->size.height;
+
+  return cost;
+}
+
+/* Widen r into a full width band when it is cheaper to send */
+static void rect_optimize(SCRD_Damage *damage, SCRL_Rect *r)
+{
+  SCRL_Rect band = { {0, r->origin.y}, {damage->screen.width, r->size.height} };
+
+  if (rect_cost(damage, &band) <= rect_cost(damage, r))
+    *r = band;
+}
+
+static void rect_union(SCRD_Damage *damage, const SCRL_Rect *a, const SCRL_Rect *b, SCRL_Rect *u)
+{
+  int x0 = MIN(a->origin.x, b->origin.x);
+  int y0 = MIN(a->origin.y, b->origin.y);
+  int x1 = MAX(a->origin.x + a->size.width, b->origin.x + b->size.width);
+  int y1 = MAX(a->origin.y + a->size.height, b->origin.y + b->size.height);
+
+  u->origin.x = x0;
+  u->origin.y = y0;
+  u->size.width = x1 - x0;
+  u->size.height = y1 - y0;
+  rect_optimize(damage, u);
+}
+
+static void rect_remove(SCRD_Damage *damage, int idx)
+{
+  damage->rects[idx] = damage->rects[--damage->nb];
+}
+
+void SCRD_Init(SCRD_Damage *damage, SCRL_Size screen)
+{
+  memset(damage, 0, sizeof(*damage));
+  damage->screen = screen;
+}
+
+void SCRD_Clear(SCRD_Damage *damage)
+{
+  damage->nb = 0;
+  damage->is_full = 0;
+}
+
+void SCRD_AddFull(SCRD_Damage *damage)
+{
+  damage->rects[0].origin.x = 0;
+  damage->rects[0].origin.y = 0;
+  damage->rects[0].size = damage->screen;
+  damage->nb = 1;
+  damage->is_full = 1;
+}
+
+void SCRD_Add(SCRD_Damage *damage, const SCRL_Rect *rect)
+{
+  SCRL_Rect full = { {0, 0}, damage->screen };
+  int x0 = rect->origin.x;
+  int y0 = rect->origin.y;
+  int x1 = MIN(rect->origin.x + rect->size.width, damage->screen.width);
+  int y1 = MIN(rect->origin.y + rect->size.height, damage->screen.height);
+  int best, best_extra, extra;
+  int cost = 0;
+  SCRL_Rect r, u;
+  int i;
+
+  if (damage->is_full || x1 <= x0 || y1 <= y0)
+    return;
+
+  r.origin.x = x0;
+  r.origin.y = y0;
+  r.size.width = x1 - x0;
+  r.size.height = y1 - y0;
+  rect_optimize(damage, &r);
+
+restart:
+  /* absorb any rectangle that is cheaper to send together with r */
+  for (i = 0; i < damage->nb; i++) {
+    rect_union(damage, &damage->rects[i], &r, &u);
+    if (rect_cost(damage, &u) <= rect_cost(damage, &damage->rects[i]) + rect_cost(damage, &r)) {
+      r = u;
+      rect_remove(damage, i);
+      goto restart;
+    }
+  }
+
+  /* no more room. Merge with the rectangle that adds the least cost */
+  if (damage->nb == SCRD_RECT_NB) {
+    best = 0;
+    best_extra = 0;
+    for (i = 0; i < damage->nb; i++) {
+      rect_union(damage, &damage->rects[i], &r, &u);
+      extra = rect_cost(damage, &u) - rect_cost(damage, &damage->rects[i]) - rect_cost(damage, &r);
+      if (i == 0 || extra < best_extra) {
+        best = i;
+        best_extra = extra;
+      }
+    }
+    rect_union(damage, &damage->rects[best], &r, &r);
+    rect_remove(damage, best);
+    goto restart;
+  }
+
+  damage->rects[damage->nb++] = r;
+
+  for (i = 0; i < damage->nb; i++)
+    cost += rect_cost(damage, &damage->rects[i]);
+  if (cost >= rect_cost(damage, &full))
+    SCRD_AddFull(damage);
+}
+
+int SCRD_NextChunk(const SCRL_Rect *rect, SCRL_Size screen, int bpp, int max_len, int *pos, int *offset)
+{
+  int row_len = rect->size.width * bpp;
+  int total = row_len * rect->size.height;
+  int row, len;
+
+  if (*pos >= total)
+    return 0;
+
+  row = *pos / row_len;
+  *offset = ((rect->origin.y + row) * screen.width + rect->origin.x) * bpp + *pos % row_len;
+  /* full width rows follow each other in memory */
+  len = rect->size.width == screen.width ? total - *pos : row_len - *pos % row_len;
+  len = MIN(len, max_len);
+  *pos += len;
+
+  return len;
+}
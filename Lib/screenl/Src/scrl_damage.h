@@ -0,0 +1,43 @@
+#ifndef _SCRL_DAMAGE_
+#define _SCRL_DAMAGE_
+
+#include "scrl.h"
+
+/* Damage region tracking for screens updated by window, like spi one. No driver uses it yet: application camera
+ * background changes at each update, so whole screen is always sent. It has no hardware dependency and is host
+ * checked by Scripts/damage_check.py.
+ * Damage is kept as at most SCRD_RECT_NB rectangles in screen coordinates. Rectangles are merged, or widened into
+ * full width bands, whenever it lowers transfer cost. Cost of a rectangle is its number of pixels plus
+ * SCRD_WINDOW_COST for display window setup, plus SCRD_ROW_COST per row when rectangle is narrower than screen since
+ * its rows are not contiguous in memory and are sent one by one.
+ */
+#ifndef SCRD_RECT_NB
+#define SCRD_RECT_NB 8
+#endif
+#ifndef SCRD_WINDOW_COST
+#define SCRD_WINDOW_COST 64
+#endif
+#ifndef SCRD_ROW_COST
+#define SCRD_ROW_COST 32
+#endif
+
+typedef struct {
+  SCRL_Size screen;
+  SCRL_Rect rects[SCRD_RECT_NB];
+  int nb;
+  int is_full;
+} SCRD_Damage;
+
+void SCRD_Init(SCRD_Damage *damage, SCRL_Size screen);
+void SCRD_Clear(SCRD_Damage *damage);
+void SCRD_AddFull(SCRD_Damage *damage);
+/* rect is clipped to screen */
+void SCRD_Add(SCRD_Damage *damage, const SCRL_Rect *rect);
+/* Get next chunk of rect pixels, in display order, from a frame buffer of screen size with bpp bytes per pixel.
+ * A chunk is contiguous in memory and at most max_len bytes long. pos is the byte position inside rect pixels, it
+ * starts at 0 and is updated on each call.
+ * return chunk length in bytes with its offset inside frame buffer, or 0 once rect has been fully sent.
+ */
+int SCRD_NextChunk(const SCRL_Rect *rect, SCRL_Size screen, int bpp, int max_len, int *pos, int *offset);
+
+#endif
@@ -0,0 +1,494 @@
+#include "scrl_jpeg.h"
+
+#include <string.h>
+
+/* Column pass of the dct relies on gcc vector extensions. Same rules as scrl_yuv.c */
+#ifndef SCRJ_USE_VECTOR
+#if defined(__ARM_FEATURE_MVE) || defined(__ARM_NEON) || defined(__SSE2__)
+#define SCRJ_USE_VECTOR 1
+#else
+#define SCRJ_USE_VECTOR 0
+#endif
+#endif
+
+/* libjpeg jfdctint.c constants */
+#define CONST_BITS 13
+#define PASS1_BITS 2
+#define FIX_0_298631336 2446
+#define FIX_0_390180644 3196
+#define FIX_0_541196100 4433
+#define FIX_0_765366865 6270
+#define FIX_0_899976223 7373
+#define FIX_1_175875602 9633
+#define FIX_1_501321110 12299
+#define FIX_1_847759065 15137
+#define FIX_1_961570560 16069
+#define FIX_2_053119869 16819
+#define FIX_2_562915447 20995
+#define FIX_3_072711026 25172
+#define DESCALE(_x_, _n_) (((_x_) + (1 << ((_n_) - 1))) >> (_n_))
+
+/* One dimension dct on 8 elements stride apart. First pass output is scaled up by 1 << PASS1_BITS, second pass
+ * removes it so final coefficients are eight times true dct ones.
+ */
+#define DEFINE_FDCT_1D(_name_, _type_) \
+static inline void _name_(_type_ *d, int stride, int is_first_pass) \
+{ \
+  _type_ tmp0, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7; \
+  _type_ tmp10, tmp11, tmp12, tmp13; \
+  _type_ z1, z2, z3, z4, z5; \
+  const int odd_shift = is_first_pass ? CONST_BITS - PASS1_BITS : CONST_BITS + PASS1_BITS; \
+ \
+  tmp0 = d[0 * stride] + d[7 * stride]; \
+  tmp7 = d[0 * stride] - d[7 * stride]; \
+  tmp1 = d[1 * stride] + d[6 * stride]; \
+  tmp6 = d[1 * stride] - d[6 * stride]; \
+  tmp2 = d[2 * stride] + d[5 * stride]; \
+  tmp5 = d[2 * stride] - d[5 * stride]; \
+  tmp3 = d[3 * stride] + d[4 * stride]; \
+  tmp4 = d[3 * stride] - d[4 * stride]; \
+ \
+  tmp10 = tmp0 + tmp3; \
+  tmp13 = tmp0 - tmp3; \
+  tmp11 = tmp1 + tmp2; \
+  tmp12 = tmp1 - tmp2; \
+  if (is_first_pass) { \
+    d[0 * stride] = (tmp10 + tmp11) << PASS1_BITS; \
+    d[4 * stride] = (tmp10 - tmp11) << PASS1_BITS; \
+  } else { \
+    d[0 * stride] = DESCALE(tmp10 + tmp11, PASS1_BITS); \
+    d[4 * stride] = DESCALE(tmp10 - tmp11, PASS1_BITS); \
+  } \
+  z1 = (tmp12 + tmp13) * FIX_0_541196100; \
+  d[2 * stride] = DESCALE(z1 + tmp13 * FIX_0_765366865, odd_shift); \
+  d[6 * stride] = DESCALE(z1 - tmp12 * FIX_1_847759065, odd_shift); \
+ \
+  z1 = tmp4 + tmp7; \
+  z2 = tmp5 + tmp6; \
+  z3 = tmp4 + tmp6; \
+  z4 = tmp5 + tmp7; \
+  z5 = (z3 + z4) * FIX_1_175875602; \
+  tmp4 = tmp4 * FIX_0_298631336; \
+  tmp5 = tmp5 * FIX_2_053119869; \
+  tmp6 = tmp6 * FIX_3_072711026; \
+  tmp7 = tmp7 * FIX_1_501321110; \
+  z1 = z1 * -FIX_0_899976223; \
+  z2 = z2 * -FIX_2_562915447; \
+  z3 = z3 * -FIX_1_961570560 + z5; \
+  z4 = z4 * -FIX_0_390180644 + z5; \
+  d[7 * stride] = DESCALE(tmp4 + z1 + z3, odd_shift); \
+  d[5 * stride] = DESCALE(tmp5 + z2 + z4, odd_shift); \
+  d[3 * stride] = DESCALE(tmp6 + z2 + z3, odd_shift); \
+  d[1 * stride] = DESCALE(tmp7 + z1 + z4, odd_shift); \
+}
+
+/* MCU is 16x8 pixels: two luma blocks followed by one cb and one cr block */
+#define MCU_WIDTH 16
+#define MCU_HEIGHT 8
+#define BLOCK_NB 4
+
+/* position of pixel at row r and column c in a block given to fdct() */
+#if SCRJ_USE_VECTOR
+#define BLK(_r_, _c_) ((_c_) * 8 + (_r_))
+#else
+#define BLK(_r_, _c_) ((_r_) * 8 + (_c_))
+#endif
+
+typedef struct {
+  uint16_t code[256];
+  uint8_t size[256];
+} huff_table_t;
+
+typedef struct {
+  uint8_t *p;
+  uint32_t acc;
+  int nbits;
+} bit_writer_t;
+
+static const uint8_t zigzag[64] = {
+   0,  1,  8, 16,  9,  2,  3, 10,
+  17, 24, 32, 25, 18, 11,  4,  5,
+  12, 19, 26, 33, 40, 48, 41, 34,
+  27, 20, 13,  6,  7, 14, 21, 28,
+  35, 42, 49, 56, 57, 50, 43, 36,
+  29, 22, 15, 23, 30, 37, 44, 51,
+  58, 59, 52, 45, 38, 31, 39, 46,
+  53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+/* Annex K tables, natural order */
+static const uint8_t std_lum_quant[64] = {
+  16,  11,  10,  16,  24,  40,  51,  61,
+  12,  12,  14,  19,  26,  58,  60,  55,
+  14,  13,  16,  24,  40,  57,  69,  56,
+  14,  17,  22,  29,  51,  87,  80,  62,
+  18,  22,  37,  56,  68, 109, 103,  77,
+  24,  35,  55,  64,  81, 104, 113,  92,
+  49,  64,  78,  87, 103, 121, 120, 101,
+  72,  92,  95,  98, 112, 100, 103,  99,
+};
+
+static const uint8_t std_chr_quant[64] = {
+  17,  18,  24,  47,  99,  99,  99,  99,
+  18,  21,  26,  66,  99,  99,  99,  99,
+  24,  26,  56,  99,  99,  99,  99,  99,
+  47,  66,  99,  99,  99,  99,  99,  99,
+  99,  99,  99,  99,  99,  99,  99,  99,
+  99,  99,  99,  99,  99,  99,  99,  99,
+  99,  99,  99,  99,  99,  99,  99,  99,
+  99,  99,  99,  99,  99,  99,  99,  99,
+};
+
+/* huffman tables are given as number of codes of each length from 1 to 16 followed by symbols */
+static const uint8_t dc_lum_bits[16] = { 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+static const uint8_t dc_lum_vals[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+static const uint8_t dc_chr_bits[16] = { 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+static const uint8_t dc_chr_vals[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+static const uint8_t ac_lum_bits[16] = { 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+static const uint8_t ac_lum_vals[162] = {
+  0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+  0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+  0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+  0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+  0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+  0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+  0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+  0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+  0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+  0xf9, 0xfa,
+};
+static const uint8_t ac_chr_bits[16] = { 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+static const uint8_t ac_chr_vals[162] = {
+  0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+  0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+  0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+  0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+  0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+  0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+  0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+  0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+  0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+  0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+  0xf9, 0xfa,
+};
+
+static struct {
+  /* quantization tables in zigzag order as written in DQT, index 0 for luma and 1 for chroma */
+  uint8_t quant[2][64];
+  /* reciprocal of eight times quantization value, in zigzag order */
+  uint32_t recip[2][64];
+  huff_table_t dc[2];
+  huff_table_t ac[2];
+} scrj;
+
+DEFINE_FDCT_1D(fdct_1d, int32_t)
+
+#if SCRJ_USE_VECTOR
+typedef int32_t v4si __attribute__((vector_size(16)));
+
+DEFINE_FDCT_1D(v_fdct_1d, v4si)
+
+/* Block is loaded transposed so that the row pass works on four rows per lane. Block is then transposed back and
+ * column pass works on four columns per lane. Passes run in the same order as libjpeg so rounding is identical.
+ */
+static void fdct(int32_t *blk)
+{
+  v4si v[16];
+  int32_t t;
+  int i, j;
+
+  memcpy(v, blk, sizeof(v));
+  v_fdct_1d(&v[0], 2, 1);
+  v_fdct_1d(&v[1], 2, 1);
+  memcpy(blk, v, sizeof(v));
+
+  for (i = 0; i < 8; i++) {
+    for (j = i + 1; j < 8; j++) {
+      t = blk[i * 8 + j];
+      blk[i * 8 + j] = blk[j * 8 + i];
+      blk[j * 8 + i] = t;
+    }
+  }
+
+  memcpy(v, blk, sizeof(v));
+  v_fdct_1d(&v[0], 2, 0);
+  v_fdct_1d(&v[1], 2, 0);
+  memcpy(blk, v, sizeof(v));
+}
+#else
+static void fdct(int32_t *blk)
+{
+  int i;
+
+  for (i = 0; i < 8; i++)
+    fdct_1d(&blk[i * 8], 1, 1);
+  for (i = 0; i < 8; i++)
+    fdct_1d(&blk[i], 8, 0);
+}
+#endif
+
+static void build_huff_table(huff_table_t *tbl, const uint8_t *bits, const uint8_t *vals)
+{
+  uint16_t code = 0;
+  int len, i, k = 0;
+
+  for (len = 1; len <= 16; len++) {
+    for (i = 0; i < bits[len - 1]; i++, k++) {
+      tbl->code[vals[k]] = code++;
+      tbl->size[vals[k]] = len;
+    }
+    code <<= 1;
+  }
+}
+
+static void build_quant_table(int idx, const uint8_t *std, int quality)
+{
+  int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+  int q, k;
+
+  for (k = 0; k < 64; k++) {
+    q = (std[zigzag[k]] * scale + 50) / 100;
+    q = q < 1 ? 1 : q;
+    q = q > 255 ? 255 : q;
+    scrj.quant[idx][k] = q;
+    /* exact for dividends below 1 << 21, dct output stays below 1 << 15 */
+    scrj.recip[idx][k] = (uint32_t) ((((uint64_t) 1 << 32) + q * 8 - 1) / (q * 8));
+  }
+}
+
+static inline void bw_put(bit_writer_t *bw, uint32_t code, int size)
+{
+  uint8_t b;
+
+  bw->acc = (bw->acc << size) | code;
+  bw->nbits += size;
+  while (bw->nbits >= 8) {
+    bw->nbits -= 8;
+    b = bw->acc >> bw->nbits;
+    *bw->p++ = b;
+    /* byte stuffing */
+    if (b == 0xff)
+      *bw->p++ = 0;
+  }
+}
+
+static void bw_flush(bit_writer_t *bw)
+{
+  /* pad with ones */
+  if (bw->nbits)
+    bw_put(bw, (1 << (8 - bw->nbits)) - 1, 8 - bw->nbits);
+}
+
+static inline int bit_size(uint32_t v)
+{
+  return v ? 32 - __builtin_clz(v) : 0;
+}
+
+/* put a size category followed by value bits, negative values are sent as one complement */
+static inline void put_value(bit_writer_t *bw, const huff_table_t *tbl, int symbol_high, int v)
+{
+  uint32_t a = v < 0 ? -v : v;
+  int size = bit_size(a);
+
+  bw_put(bw, tbl->code[symbol_high | size], tbl->size[symbol_high | size]);
+  if (size)
+    bw_put(bw, (v < 0 ? v - 1 : v) & ((1 << size) - 1), size);
+}
+
+static void encode_block(bit_writer_t *bw, int32_t *blk, int tbl, int *dc_pred)
+{
+  const huff_table_t *ac = &scrj.ac[tbl];
+  const uint32_t *recip = scrj.recip[tbl];
+  const uint8_t *quant = scrj.quant[tbl];
+  /* bit k is set when ac coefficient k is not zero */
+  uint64_t nz = 0;
+  int16_t coef[64];
+  int run, last;
+  int32_t c;
+  uint32_t a;
+  int k;
+
+  fdct(blk);
+  for (k = 0; k < 64; k++) {
+    c = blk[zigzag[k]];
+    a = c < 0 ? -c : c;
+    a = ((uint64_t) (a + quant[k] * 4) * recip[k]) >> 32;
+    coef[k] = c < 0 ? -(int32_t) a : (int32_t) a;
+    nz |= (uint64_t) (a != 0) << k;
+  }
+
+  put_value(bw, &scrj.dc[tbl], 0, coef[0] - *dc_pred);
+  *dc_pred = coef[0];
+
+  /* jump from one non zero coefficient to the next one */
+  nz &= ~(uint64_t) 1;
+  for (last = 0; nz; last = k, nz &= nz - 1) {
+    k = __builtin_ctzll(nz);
+    /* zero run length limited to 15 */
+    for (run = k - last - 1; run > 15; run -= 16)
+      bw_put(bw, ac->code[0xf0], ac->size[0xf0]);
+    put_value(bw, ac, run << 4, coef[k]);
+  }
+  /* end of block */
+  if (last != 63)
+    bw_put(bw, ac->code[0x00], ac->size[0x00]);
+}
+
+/* Load a MCU with level shift. x and y give MCU position in pixels, edges are replicated */
+static void load_mcu(int32_t blk[BLOCK_NB][64], const uint8_t *src, int width, int height, int stride, int x, int y)
+{
+  const uint8_t *line;
+  int i, j, col, row;
+
+  for (i = 0; i < MCU_HEIGHT; i++) {
+    row = y + i < height ? y + i : height - 1;
+    line = src + row * stride;
+    if (x + MCU_WIDTH <= width) {
+      line += x * 2;
+      for (j = 0; j < 8; j++) {
+        blk[0][BLK(i, j)] = line[j * 2] - 128;
+        blk[1][BLK(i, j)] = line[16 + j * 2] - 128;
+        blk[2][BLK(i, j)] = line[j * 4 + 1] - 128;
+        blk[3][BLK(i, j)] = line[j * 4 + 3] - 128;
+      }
+      continue;
+    }
+    for (j = 0; j < MCU_WIDTH; j++) {
+      col = x + j < width ? x + j : width - 1;
+      blk[j / 8][BLK(i, j % 8)] = line[col * 2] - 128;
+    }
+    for (j = 0; j < 8; j++) {
+      col = x + j * 2 < width ? x + j * 2 : width - 2;
+      blk[2][BLK(i, j)] = line[col * 2 + 1] - 128;
+      blk[3][BLK(i, j)] = line[col * 2 + 3] - 128;
+    }
+  }
+}
+
+static uint8_t *put_marker(uint8_t *p, uint8_t marker, int len)
+{
+  p[0] = 0xff;
+  p[1] = marker;
+  p[2] = len >> 8;
+  p[3] = len;
+
+  return p + 4;
+}
+
+static uint8_t *put_huff_table(uint8_t *p, int class_id, const uint8_t *bits, const uint8_t *vals, int vals_nb)
+{
+  *p++ = class_id;
+  memcpy(p, bits, 16);
+  p += 16;
+  memcpy(p, vals, vals_nb);
+
+  return p + vals_nb;
+}
+
+static uint8_t *put_headers(uint8_t *p, int width, int height)
+{
+  static const uint8_t jfif[] = { 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0 };
+  int i;
+
+  /* SOI */
+  *p++ = 0xff;
+  *p++ = 0xd8;
+
+  p = put_marker(p, 0xe0, 2 + sizeof(jfif));
+  memcpy(p, jfif, sizeof(jfif));
+  p += sizeof(jfif);
+
+  p = put_marker(p, 0xdb, 2 + 2 * 65);
+  for (i = 0; i < 2; i++) {
+    *p++ = i;
+    memcpy(p, scrj.quant[i], 64);
+    p += 64;
+  }
+
+  /* SOF0 : luma is sampled 2x1, chroma 1x1 */
+  p = put_marker(p, 0xc0, 2 + 6 + 3 * 3);
+  *p++ = 8;
+  *p++ = height >> 8;
+  *p++ = height;
+  *p++ = width >> 8;
+  *p++ = width;
+  *p++ = 3;
+  for (i = 0; i < 3; i++) {
+    *p++ = i + 1;
+    *p++ = i ? 0x11 : 0x21;
+    *p++ = i ? 1 : 0;
+  }
+
+  p = put_marker(p, 0xc4, 2 + 4 * 17 + 2 * 12 + 2 * 162);
+  p = put_huff_table(p, 0x00, dc_lum_bits, dc_lum_vals, sizeof(dc_lum_vals));
+  p = put_huff_table(p, 0x10, ac_lum_bits, ac_lum_vals, sizeof(ac_lum_vals));
+  p = put_huff_table(p, 0x01, dc_chr_bits, dc_chr_vals, sizeof(dc_chr_vals));
+  p = put_huff_table(p, 0x11, ac_chr_bits, ac_chr_vals, sizeof(ac_chr_vals));
+
+  p = put_marker(p, 0xda, 2 + 1 + 3 * 2 + 3);
+  *p++ = 3;
+  for (i = 0; i < 3; i++) {
+    *p++ = i + 1;
+    *p++ = i ? 0x11 : 0x00;
+  }
+  *p++ = 0;
+  *p++ = 63;
+  *p++ = 0;
+
+  return p;
+}
+
+void SCRJ_Init(int quality)
+{
+  quality = quality < 1 ? 1 : quality;
+  quality = quality > 100 ? 100 : quality;
+  build_quant_table(0, std_lum_quant, quality);
+  build_quant_table(1, std_chr_quant, quality);
+
+  build_huff_table(&scrj.dc[0], dc_lum_bits, dc_lum_vals);
+  build_huff_table(&scrj.ac[0], ac_lum_bits, ac_lum_vals);
+  build_huff_table(&scrj.dc[1], dc_chr_bits, dc_chr_vals);
+  build_huff_table(&scrj.ac[1], ac_chr_bits, ac_chr_vals);
+}
+
+int SCRJ_EncodeYuv422(uint8_t *dst, int dst_size, const uint8_t *src, int width, int height, int stride)
+{
+  uint8_t *end = dst + dst_size;
+  int32_t blk[BLOCK_NB][64];
+  int dc_pred[3] = { 0 };
+  bit_writer_t bw;
+  int x, y;
+
+  if (width <= 0 || height <= 0 || (width & 1))
+    return -1;
+  /* also covers headers size */
+  if (dst_size < SCRJ_MCU_MAX_SIZE)
+    return -1;
+
+  bw.p = put_headers(dst, width, height);
+  bw.acc = 0;
+  bw.nbits = 0;
+
+  for (y = 0; y < height; y += MCU_HEIGHT) {
+    for (x = 0; x < width; x += MCU_WIDTH) {
+      if (end - bw.p < SCRJ_MCU_MAX_SIZE)
+        return -1;
+      load_mcu(blk, src, width, height, stride, x, y);
+      encode_block(&bw, blk[0], 0, &dc_pred[0]);
+      encode_block(&bw, blk[1], 0, &dc_pred[0]);
+      encode_block(&bw, blk[2], 1, &dc_pred[1]);
+      encode_block(&bw, blk[3], 1, &dc_pred[2]);
+    }
+  }
+  /* flush writes a byte and its stuffing byte at most, then EOI */
+  if (end - bw.p < 4)
+    return -1;
+  bw_flush(&bw);
+
+  /* EOI */
+  *bw.p++ = 0xff;
+  *bw.p++ = 0xd9;
+
+  return bw.p - dst;
+}
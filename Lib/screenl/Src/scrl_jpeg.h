@@ -0,0 +1,24 @@
+#ifndef _SCRL_JPEG_
+#define _SCRL_JPEG_
+
+#include <stdint.h>
+
+/* Baseline JPEG encoder used by usb screen for MJPEG payload. It has no hardware dependency so it can also be built
+ * on host.
+ * - Uses fixed huffman tables from jpeg specification annex K and libjpeg accurate integer dct.
+ * - quality follows libjpeg scaling of annex K quantization tables, from 1 to 100.
+ */
+#define SCRJ_QUALITY_DEFAULT 75
+/* Encoder gives up as soon as remaining output space is below this amount, so output buffer must be at least this
+ * much larger than expected encoded size. It is the worst case size of a 16x8 pixels MCU.
+ */
+#define SCRJ_MCU_MAX_SIZE 1728
+
+void SCRJ_Init(int quality);
+/* Encode a YUY2 image as a 4:2:2 JFIF. width must be even, stride is in bytes. Partial MCUs on right and bottom
+ * edges are padded by replicating last column and last row.
+ * return encoded size or -1 if it does not fit in dst_size bytes
+ */
+int SCRJ_EncodeYuv422(uint8_t *dst, int dst_size, const uint8_t *src, int width, int height, int stride);
+
+#endif
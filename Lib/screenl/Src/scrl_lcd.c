@@ -4,6 +4,7 @@
 
 #include "stm32n6570_discovery_lcd.h"
 #include "stm32_lcd.h"
+#include "scrl_trace.h"
 
 static SCRL_Layer current_layer;
 static int is_layer_rgb888[SCRL_LAYER_NB];
@@ -435,10 +436,17 @@ int SCRL_ReloadLayer(SCRL_Layer layer)
 
 int SRCL_Update(void)
 {
-  /* Nothing to do */
+  SCRL_TRACE_INSTANT(UPDATE, 0);
+  /* Nothing else to do, ltdc reloads layers on vertical blanking */
+
   return 0;
 }
 
+int SCRL_SetComposition(SCRL_Composition composition)
+{
+  return composition == SCRL_COMPOSITION_CPU ? -1 : 0;
+}
+
 HAL_StatusTypeDef MX_LTDC_ConfigLayer(LTDC_HandleTypeDef *hltdc, uint32_t LayerIndex, MX_LTDC_LayerConfig_t *Config)
 {
   assert(LayerIndex < SCRL_LAYER_NB);
@@ -0,0 +1,150 @@
+#include "scrl_raster.h"
+
+#include <string.h>
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#endif
+
+static inline void put24(uint8_t *dst, uint32_t color)
+{
+  dst[0] = color;
+  dst[1] = color >> 8;
+  dst[2] = color >> 16;
+}
+
+/* newlib nano memcpy favors size over speed. Copy a word at a time once destination is aligned. Source may be
+ * unaligned, memcpy of 4 bytes compiles to a single ldr on cortex-m55.
+ */
+static void copy_bytes(uint8_t *dst, const uint8_t *src, int n)
+{
+  uint32_t *dst32;
+  uint32_t v;
+
+#if defined(__ARM_FEATURE_MVE)
+  for (; n >= 16; n -= 16, dst += 16, src += 16)
+    vst1q_u8(dst, vld1q_u8(src));
+#endif
+  for (; n > 0 && ((uintptr_t) dst & 3); n--)
+    *dst++ = *src++;
+  dst32 = (uint32_t *) dst;
+  for (; n >= 4; n -= 4, src += 4) {
+    memcpy(&v, src, sizeof(v));
+    *dst32++ = v;
+  }
+  dst = (uint8_t *) dst32;
+  for (; n > 0; n--)
+    *dst++ = *src++;
+}
+
+void SCRR_FillSpan16(uint16_t *dst, int n, uint16_t color)
+{
+  uint32_t v = color | ((uint32_t) color << 16);
+  uint32_t *dst32;
+#if defined(__ARM_FEATURE_MVE)
+  uint16x8_t vq = vdupq_n_u16(color);
+#endif
+
+  if (n > 0 && ((uintptr_t) dst & 2)) {
+    *dst++ = color;
+    n--;
+  }
+#if defined(__ARM_FEATURE_MVE)
+  for (; n >= 8; n -= 8, dst += 8)
+    vst1q_u16(dst, vq);
+#endif
+  /* two words per iteration so compiler can emit strd */
+  dst32 = (uint32_t *) dst;
+  for (; n >= 4; n -= 4, dst32 += 2) {
+    dst32[0] = v;
+    dst32[1] = v;
+  }
+  if (n >= 2) {
+    *dst32++ = v;
+    n -= 2;
+  }
+  if (n)
+    *(uint16_t *) dst32 = color;
+}
+
+void SCRR_FillSpan24(uint8_t *dst, int n, uint32_t color)
+{
+  uint32_t c = color & 0xffffff;
+  /* four pixels fit in three words */
+  const uint32_t w0 = c | (c << 24);
+  const uint32_t w1 = (c >> 8) | (c << 16);
+  const uint32_t w2 = (c >> 16) | (c << 8);
+  uint32_t *dst32;
+
+  /* a pixel boundary meets a word boundary at most four pixels away */
+  for (; n > 0 && ((uintptr_t) dst & 3); n--, dst += 3)
+    put24(dst, c);
+  dst32 = (uint32_t *) dst;
+  for (; n >= 4; n -= 4, dst32 += 3) {
+    dst32[0] = w0;
+    dst32[1] = w1;
+    dst32[2] = w2;
+  }
+  dst = (uint8_t *) dst32;
+  for (; n > 0; n--, dst += 3)
+    put24(dst, c);
+}
+
+void SCRR_FillRect16(uint16_t *dst, int pitch, int w, int h, uint16_t color)
+{
+  int i;
+
+  /* full width rectangle is a single span */
+  if (w == pitch) {
+    SCRR_FillSpan16(dst, w * h, color);
+    return;
+  }
+
+  for (i = 0; i < h; i++, dst += pitch)
+    SCRR_FillSpan16(dst, w, color);
+}
+
+void SCRR_FillRect24(uint8_t *dst, int pitch, int w, int h, uint32_t color)
+{
+  int i;
+
+  if (w == pitch) {
+    SCRR_FillSpan24(dst, w * h, color);
+    return;
+  }
+
+  for (i = 0; i < h; i++, dst += pitch * 3)
+    SCRR_FillSpan24(dst, w, color);
+}
+
+void SCRR_VLine16(uint16_t *dst, int pitch, int h, uint16_t color)
+{
+  int i;
+
+  for (i = 0; i < h; i++, dst += pitch)
+    *dst = color;
+}
+
+void SCRR_VLine24(uint8_t *dst, int pitch, int h, uint32_t color)
+{
+  int i;
+
+  for (i = 0; i < h; i++, dst += pitch * 3)
+    put24(dst, color);
+}
+
+void SCRR_CopyRect16(uint16_t *dst, int pitch, const uint8_t *src, int src_pitch, int w, int h)
+{
+  int i;
+
+  for (i = 0; i < h; i++, dst += pitch, src += src_pitch * 2)
+    copy_bytes((uint8_t *) dst, src, w * 2);
+}
+
+void SCRR_CopyRect24(uint8_t *dst, int pitch, const uint8_t *src, int src_pitch, int w, int h)
+{
+  int i;
+
+  for (i = 0; i < h; i++, dst += pitch * 3, src += src_pitch * 3)
+    copy_bytes(dst, src, w * 3);
+}
@@ -18,6 +18,7 @@
 #include "ili9341.h"
 #include "lcd_conf.h"
 #include "scrl_common.h"
+#include "scrl_trace.h"
 
 #define container_of(ptr, type, member) (type *) ((unsigned char *)ptr - offsetof(type,member))
 
@@ -194,6 +195,7 @@ static void spi_transfert_data(struct scrl_spi_ctx *ctx)
 {
   int ret;
 
+  SCRL_TRACE_BEGIN(SPI);
   spi_transfert_data_init(ctx);
   /* Send Data */
   while (ctx->len) {
@@ -202,6 +204,7 @@ static void spi_transfert_data(struct scrl_spi_ctx *ctx)
     assert(ret == 0);
   }
   spi_transfert_data_deinit(ctx);
+  SCRL_TRACE_END(SPI);
 }
 
 static void update_thread_fct(ULONG arg)
@@ -243,6 +246,7 @@ static void spi_transfert_data(struct scrl_spi_ctx *ctx)
 {
   int ret;
 
+  SCRL_TRACE_BEGIN(SPI);
   spi_transfert_data_init(ctx);
   /* Send Data */
   while (ctx->len) {
@@ -251,6 +255,7 @@ static void spi_transfert_data(struct scrl_spi_ctx *ctx)
     assert(ret == pdTRUE);
   }
   spi_transfert_data_deinit(ctx);
+  SCRL_TRACE_END(SPI);
 }
 
 static void update_thread_fct(void *arg)
@@ -604,6 +609,7 @@ int SRCL_Update()
   struct scrl_spi_ctx *ctx = &scrl_ctx;
   int ret = 0;
 
+  SCRL_TRACE_INSTANT(UPDATE, 0);
 #ifdef SCR_LIB_USE_THREADX
   tx_semaphore_ceiling_put(&ctx->update_sem, 1);
 #elif defined(SCR_LIB_USE_FREERTOS)
@@ -615,6 +621,11 @@ int SRCL_Update()
   return ret;
 }
 
+int SCRL_SetComposition(SCRL_Composition composition)
+{
+  return composition == SCRL_COMPOSITION_CPU ? -1 : 0;
+}
+
 #ifdef SCR_LIB_USE_THREADX
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
 {
@@ -0,0 +1,25 @@
+#ifndef _SCRL_TRACE_
+#define _SCRL_TRACE_
+
+/* Trace hooks of screen library. Application may define them in scrl_conf.h, they are empty otherwise. _ev_ is one
+ * of UPDATE, DMA2D, YUV, SHOW, RELEASE, SPI, CPU_COMPOSE or JPEG. DMA2D is an async pair ended from isr.
+ */
+#include "scrl_conf.h"
+
+#ifndef SCRL_TRACE_BEGIN
+#define SCRL_TRACE_BEGIN(_ev_) do { } while (0)
+#endif
+#ifndef SCRL_TRACE_END
+#define SCRL_TRACE_END(_ev_) do { } while (0)
+#endif
+#ifndef SCRL_TRACE_INSTANT
+#define SCRL_TRACE_INSTANT(_ev_, _arg_) do { } while (0)
+#endif
+#ifndef SCRL_TRACE_ASYNC_BEGIN
+#define SCRL_TRACE_ASYNC_BEGIN(_ev_) do { } while (0)
+#endif
+#ifndef SCRL_TRACE_ASYNC_END
+#define SCRL_TRACE_ASYNC_END(_ev_) do { } while (0)
+#endif
+
+#endif
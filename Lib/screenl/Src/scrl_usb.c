@@ -16,6 +16,9 @@
 #endif
 #include "uvcl.h"
 #include "scrl_common.h"
+#include "scrl_yuv.h"
+#include "scrl_trace.h"
+#include "scrl_jpeg.h"
 
 #define container_of(ptr, type, member) (type *) ((unsigned char *)ptr - offsetof(type,member))
 
@@ -23,30 +26,27 @@
 #define MIN(a, b)  (((a) < (b)) ? (a) : (b))
 #endif /* MIN */
 
-#define CLAMP(v, v_min, v_max) do { \
-  v = v < v_min ? v_min : v; \
-  v = v > v_max ? v_max : v; \
-} while (0)
-
-#define RGB_2_Y(r, g, b, y) do { \
-  y = SCRU_RED_Y_LUT[r] + SCRU_GREEN_Y_LUT[g] + SCRU_BLUE_Y_LUT[b]; \
-  CLAMP(y, 0, 255); \
-} while(0)
-
-#define RGB_2_CR(r, g, b, cr) do { \
-  cr = SCRU_BLUE_CB_RED_CR_LUT[r] + SCRU_GREEN_CR_LUT[g] + SCRU_BLUE_CR_LUT[b] + 128; \
-  CLAMP(cr, 0, 255); \
-} while(0)
-
-#define RGB_2_CB(r, g, b, cb) do { \
-  cb = SCRU_RED_CB_LUT[r] + SCRU_GREEN_CB_LUT[g] + SCRU_BLUE_CB_RED_CR_LUT[b] + 128; \
-  CLAMP(cb, 0, 255); \
-} while(0)
+/* Number of frames composed by each method before auto mode selects the fastest one */
+#define SCRU_PROBE_NB 8
 
 struct scrl_usb_ctx {
   struct scrl_common_ctx common;
   struct uvcl_callbacks usb_cbs;
-  int is_screen_ready_to_update;
+  /* format sent on usb. In SCRL_JPEG case common screen is the SCRL_YUV422 composition buffer */
+  SCRL_Format format;
+  int frame_buffer_size;
+  /* screen buffers are used in turn. shown_nb - released_nb of them are owned by uvcl */
+  uint8_t *screen_base;
+  int screen_buffer_nb;
+  int screen_idx;
+  uint32_t shown_nb;
+  volatile uint32_t released_nb;
+  SCRL_Composition composition;
+  int is_cpu_composition;
+  uint32_t composition_start;
+  /* auto mode statistics, indexed by is_cpu_composition */
+  uint32_t probe_nb[2];
+  uint64_t probe_cycles[2];
 #ifdef SCR_LIB_USE_THREADX
   TX_SEMAPHORE update_sem;
   TX_SEMAPHORE dma2d_sem;
@@ -61,15 +61,6 @@ struct scrl_usb_ctx {
 #endif
 };
 
-static int32_t SCRU_RED_Y_LUT[256];
-static int32_t SCRU_RED_CB_LUT[256];
-static int32_t SCRU_BLUE_CB_RED_CR_LUT[256];
-static int32_t SCRU_GREEN_Y_LUT[256];
-static int32_t SCRU_GREEN_CR_LUT[256];
-static int32_t SCRU_GREEN_CB_LUT[256];
-static int32_t SCRU_BLUE_Y_LUT[256];
-static int32_t SCRU_BLUE_CR_LUT[256];
-
 static struct scrl_usb_ctx scrl_ctx;
 #ifdef SCR_LIB_USE_THREADX
 static uint8_t update_thread_stack[4096];
@@ -85,6 +76,8 @@ static int cvt_uvcl_payload_format(SCRL_Format fmt)
     return UVCL_PAYLOAD_FB_RGB565;
   case SCRL_YUV422:
     return UVCL_PAYLOAD_UNCOMPRESSED_YUY2;
+  case SCRL_JPEG:
+    return UVCL_PAYLOAD_JPEG;
   default:
     assert(0);
   }
@@ -117,88 +110,156 @@ static int get_screen_buffer_size(struct scrl_common_ctx *ctx)
   return ctx->screen.size.width * ctx->screen.size.height * get_bpp(ctx->screen.format);
 }
 
-static void SCRU_cvt_dual_pel_rgb_to_yuv(uint8_t *r, uint8_t *g, uint8_t *b, int32_t *y, int32_t *cb, int32_t *cr)
+static int SCRU_is_screen_buffer_free(struct scrl_usb_ctx *ctx)
 {
-  uint8_t red, green, blue;
+  return ctx->shown_nb - ctx->released_nb < ctx->screen_buffer_nb;
+}
 
-  RGB_2_Y(r[0], g[0], b[0], y[0]);
-  RGB_2_Y(r[1], g[1], b[1], y[1]);
+static uint8_t *SCRU_get_screen_buffer(struct scrl_usb_ctx *ctx)
+{
+  return ctx->screen_base + ctx->screen_idx * ctx->frame_buffer_size;
+}
 
-  red = (r[0] + r[1] + 1) / 2;
-  green = (g[0] + g[1] + 1) / 2;
-  blue = (b[0] + b[1] + 1) / 2;
+/* Select next free screen buffer as composition target. jpeg frames are always composed in the same buffer */
+static void SCRU_select_screen_buffer(struct scrl_usb_ctx *ctx)
+{
+  if (ctx->format != SCRL_JPEG)
+    ctx->common.screen.address = SCRU_get_screen_buffer(ctx);
+}
 
-  RGB_2_CR(red, green, blue, cr[0]);
-  RGB_2_CB(red, green, blue, cb[0]);
+static void SCRU_cvt_rgb565_to_yuv422(struct scrl_common_ctx  *ctx_common)
+{
+  /* only convert layers area */
+  int stride = ctx_common->screen.size.width * 2;
+  int height = ctx_common->layers[0].size.height;
+  uint8_t *buffer = ctx_common->screen.address;
+  int width = ctx_common->layers[0].size.width;
+  int y = ctx_common->layers[0].origin.y;
+  int x = ctx_common->layers[0].origin.x;
+  int r;
+
+  buffer += y * stride + x * 2;
+
+  for (r = 0; r < height; r++) {
+    SCRY_Rgb565ToYuv422(buffer, (uint16_t *) buffer, width);
+    buffer += stride;
+  }
+}
+
+static int SCRU_is_cpu_composition_supported(struct scrl_common_ctx *ctx_common)
+{
+  return ctx_common->screen.format == SCRL_YUV422 && ctx_common->layers[SCRL_LAYER_0].format == SCRL_RGB565 &&
+         ctx_common->layers[SCRL_LAYER_1].format == SCRL_ARGB4444;
 }
 
-static void SCRU_cvt_rgb565_to_yuv422_internal(uint8_t *p_dst, uint8_t *p_src, int width, int height)
+/* In auto mode, frames are alternatively composed by dma2d and by cpu until both have been timed SCRU_PROBE_NB
+ * times. Fastest one is then kept. Cpu is also used when dma2d is already busy with another transfer.
+ */
+static int SCRU_select_cpu_composition(struct scrl_usb_ctx *ctx)
 {
-  uint32_t *p_src_dual_rgb565 = (uint32_t *)p_src;
-  int32_t luma[2];
-  int32_t cb, cr;
-  uint8_t b[2];
-  uint8_t g[2];
-  uint8_t r[2];
-  int x, y;
+  if (!SCRU_is_cpu_composition_supported(&ctx->common))
+    return 0;
 
-  for (y = 0; y < height; y++)
-  {
-    for (x = 0; x < width; x += 2)
-    {
-      uint32_t p = p_src_dual_rgb565[x / 2];
-
-      b[0] = (p >> 0) & 0x1f;
-      b[0] = (b[0] << 3) | (b[0] >> 2);
-      g[0] = (p >> 5) & 0x3f;
-      g[0] = (g[0] << 2) | (g[0] >> 4);
-      r[0] = (p >> 11) & 0x1f;
-      r[0] = (r[0] << 3) | (r[0] >> 2);
-      b[1] = (p >> 16) & 0x1f;
-      b[1] = (b[1] << 3) | (b[1] >> 2);
-      g[1] = (p >> 21) & 0x3f;
-      g[1] = (g[1] << 2) | (g[1] >> 4);
-      r[1] = (p >> 27) & 0x1f;
-      r[1] = (r[1] << 3) | (r[1] >> 2);
-
-      SCRU_cvt_dual_pel_rgb_to_yuv(r, g, b, luma, &cb, &cr);
-      *p_dst++ = luma[0];
-      *p_dst++ = cb;
-      *p_dst++ = luma[1];
-      *p_dst++ = cr;
-    }
-    p_src_dual_rgb565 += width / 2;
+  switch (ctx->composition) {
+  case SCRL_COMPOSITION_CPU:
+    return 1;
+  case SCRL_COMPOSITION_AUTO:
+    if (DMA2D->CR & DMA2D_CR_START)
+      return 1;
+    if (ctx->probe_nb[0] < SCRU_PROBE_NB || ctx->probe_nb[1] < SCRU_PROBE_NB)
+      return ctx->probe_nb[1] < ctx->probe_nb[0];
+    return ctx->probe_cycles[1] * ctx->probe_nb[0] < ctx->probe_cycles[0] * ctx->probe_nb[1];
+  default:
+    return 0;
   }
 }
 
-static void SCRU_cvt_rgb565_to_yuv422(struct scrl_common_ctx  *ctx_common)
+static void SCRU_probe_update(struct scrl_usb_ctx *ctx)
+{
+  int is_cpu = ctx->is_cpu_composition;
+
+  if (ctx->composition != SCRL_COMPOSITION_AUTO || ctx->probe_nb[is_cpu] >= SCRU_PROBE_NB)
+    return;
+
+  ctx->probe_cycles[is_cpu] += DWT->CYCCNT - ctx->composition_start;
+  ctx->probe_nb[is_cpu]++;
+}
+
+/* Blend both layers and convert them to YUV422 straight into screen buffer */
+static void SCRU_compose_cpu(struct scrl_common_ctx *ctx_common)
 {
-  /* only convert layers area */
   int stride = ctx_common->screen.size.width * 2;
   int height = ctx_common->layers[0].size.height;
+  uint16_t *bg = ctx_common->display_address[SCRL_LAYER_0];
+  uint16_t *fg = ctx_common->display_address[SCRL_LAYER_1];
   uint8_t *buffer = ctx_common->screen.address;
   int width = ctx_common->layers[0].size.width;
   int y = ctx_common->layers[0].origin.y;
   int x = ctx_common->layers[0].origin.x;
   int r;
 
+  /* layers may have been written by a dma */
+  SCB_CleanInvalidateDCache_by_Addr(bg, width * height * 2);
+  SCB_CleanInvalidateDCache_by_Addr(fg, width * height * 2);
+
   buffer += y * stride + x * 2;
 
   for (r = 0; r < height; r++) {
-    SCRU_cvt_rgb565_to_yuv422_internal(buffer, buffer, width, 1);
+    SCRY_BlendToYuv422(buffer, bg, fg, width);
     buffer += stride;
+    bg += width;
+    fg += width;
+  }
+}
+
+/* Return 1 if composition has been started on dma2d, caller must then wait for its completion callback */
+static int SCRU_composition_start(struct scrl_usb_ctx *ctx)
+{
+  ctx->is_cpu_composition = SCRU_select_cpu_composition(ctx);
+  ctx->composition_start = DWT->CYCCNT;
+  if (!ctx->is_cpu_composition) {
+    SCRC_Composition_Start(&ctx->common, 0);
+    return 1;
   }
+
+  SCRL_TRACE_BEGIN(CPU_COMPOSE);
+  SCRU_compose_cpu(&ctx->common);
+  SCRL_TRACE_END(CPU_COMPOSE);
+
+  return 0;
 }
 
 static void SCRU_uvcl_show_frame(struct scrl_usb_ctx *ctx)
 {
+  int frame_size = ctx->frame_buffer_size;
+  uint8_t *frame = ctx->common.screen.address;
   int ret;
 
-  if (ctx->common.screen.format == SCRL_YUV422)
+  if (ctx->common.screen.format == SCRL_YUV422 && !ctx->is_cpu_composition) {
+    SCRL_TRACE_BEGIN(YUV);
     SCRU_cvt_rgb565_to_yuv422(&ctx->common);
-  ret = UVCL_ShowFrame(ctx->common.screen.address, get_screen_buffer_size(&ctx->common));
+    SCRL_TRACE_END(YUV);
+  }
+  SCRU_probe_update(ctx);
+  if (ctx->format == SCRL_JPEG) {
+    frame = SCRU_get_screen_buffer(ctx);
+    SCRL_TRACE_BEGIN(JPEG);
+    frame_size = SCRJ_EncodeYuv422(frame, ctx->frame_buffer_size, ctx->common.screen.address,
+                                   ctx->common.screen.size.width, ctx->common.screen.size.height,
+                                   ctx->common.screen.size.width * 2);
+    SCRL_TRACE_END(JPEG);
+    /* frame does not fit in screen buffer, drop it */
+    if (frame_size < 0)
+      return;
+  }
+  ret = UVCL_ShowFrame(frame, frame_size);
+  SCRL_TRACE_INSTANT(SHOW, ret);
+  /* frame has been dropped by uvcl, buffer stays free and will be reused for next one */
   if (ret)
-    ctx->is_screen_ready_to_update = 1;
+    return;
+
+  ctx->shown_nb++;
+  ctx->screen_idx = (ctx->screen_idx + 1) % ctx->screen_buffer_nb;
 }
 
 #ifdef SCR_LIB_USE_THREADX
@@ -239,13 +300,14 @@ static void update_thread_fct(ULONG arg)
     ret = tx_semaphore_get(&ctx->update_sem, TX_WAIT_FOREVER);
     assert(ret == 0);
 
-    if (!ctx->is_screen_ready_to_update)
+    if (!SCRU_is_screen_buffer_free(ctx))
       continue;
 
-    ctx->is_screen_ready_to_update = 0;
-    SCRC_Composition_Start(&ctx->common, 0);
-    ret = tx_semaphore_get(&ctx->dma2d_sem, TX_WAIT_FOREVER);
-    assert(ret == 0);
+    SCRU_select_screen_buffer(ctx);
+    if (SCRU_composition_start(ctx)) {
+      ret = tx_semaphore_get(&ctx->dma2d_sem, TX_WAIT_FOREVER);
+      assert(ret == 0);
+    }
     SCRU_uvcl_show_frame(ctx);
   }
 }
@@ -260,13 +322,14 @@ static void update_thread_fct(void *arg)
     ret = xSemaphoreTake(ctx->update_sem, portMAX_DELAY);
     assert(ret == pdTRUE);
 
-    if (!ctx->is_screen_ready_to_update)
+    if (!SCRU_is_screen_buffer_free(ctx))
       continue;
 
-    ctx->is_screen_ready_to_update = 0;
-    SCRC_Composition_Start(&ctx->common, 0);
-    ret = xSemaphoreTake(ctx->dma2d_sem, portMAX_DELAY);
-    assert(ret == pdTRUE);
+    SCRU_select_screen_buffer(ctx);
+    if (SCRU_composition_start(ctx)) {
+      ret = xSemaphoreTake(ctx->dma2d_sem, portMAX_DELAY);
+      assert(ret == pdTRUE);
+    }
 
     SCRU_uvcl_show_frame(ctx);
   }
@@ -274,11 +337,12 @@ static void update_thread_fct(void *arg)
 #else
 static int start_composition(struct scrl_usb_ctx *ctx)
 {
-  if (!ctx->is_screen_ready_to_update)
+  if (!SCRU_is_screen_buffer_free(ctx))
       return 0;
 
-  ctx->is_screen_ready_to_update = 0;
-  SCRC_Composition_Start(&ctx->common, 0);
+  SCRU_select_screen_buffer(ctx);
+  if (!SCRU_composition_start(ctx))
+    SCRU_uvcl_show_frame(ctx);
 
   return 0;
 }
@@ -288,7 +352,9 @@ static void usb_frame_release_cb(struct uvcl_callbacks *cbs, void *frame)
 {
   struct scrl_usb_ctx *ctx = container_of(cbs, struct scrl_usb_ctx, usb_cbs);
 
-  ctx->is_screen_ready_to_update = 1;
+  SCRL_TRACE_INSTANT(RELEASE, 0);
+  /* uvcl releases frames in the order they have been shown */
+  ctx->released_nb++;
 }
 
 static void SCRU_usb_init(PCD_TypeDef *pcd_instance, struct scrl_usb_ctx *ctx)
@@ -299,7 +365,9 @@ static void SCRU_usb_init(PCD_TypeDef *pcd_instance, struct scrl_usb_ctx *ctx)
   conf.streams[0].width = ctx->common.screen.size.width;
   conf.streams[0].height = ctx->common.screen.size.height;
   conf.streams[0].fps = ctx->common.screen.fps;
-  conf.streams[0].payload_type = cvt_uvcl_payload_format(ctx->common.screen.format);
+  conf.streams[0].payload_type = cvt_uvcl_payload_format(ctx->format);
+  if (ctx->format == SCRL_JPEG)
+    conf.streams[0].dwMaxVideoFrameSize = ctx->frame_buffer_size;
   conf.streams_nb = 1;
   conf.is_immediate_mode = 1;
   ret = UVCL_Init(pcd_instance, &conf, &ctx->usb_cbs);
@@ -324,6 +392,7 @@ static int is_output_format_valid(SCRL_Format fmt)
   switch (fmt) {
   case SCRL_RGB565:
   case SCRL_YUV422:
+  case SCRL_JPEG:
     return 1;
   default:
     return 0;
@@ -378,6 +447,8 @@ static int SCRU_validate_parameters(SCRL_LayerConfig *layers_config[SCRL_LAYER_N
   /* check output format */
   if (!is_output_format_valid(screen_config->format))
     return -1;
+  if (screen_config->format == SCRL_JPEG && !screen_config->composition_address)
+    return -1;
 
   return 0;
 }
@@ -414,41 +485,38 @@ static void SCRL_Init_freertos(struct scrl_usb_ctx *ctx)
 }
 #endif
 
-static void SCRL_Init_Lut()
-{
-  int i;
-
-  for (i = 0; i <= 255; i++)
-  {
-    SCRU_RED_Y_LUT[i]           = ((  ((int32_t) ((0.299 )  * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    SCRU_GREEN_Y_LUT[i]         = ((  ((int32_t) ((0.587 )  * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    SCRU_BLUE_Y_LUT[i]          = ((  ((int32_t) ((0.114 )  * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    SCRU_RED_CB_LUT[i]          = (((-((int32_t) ((0.1687 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    SCRU_GREEN_CB_LUT[i]        = (((-((int32_t) ((0.3313 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    /* BLUE_CB_LUT and RED_CR_LUT are identical */
-    SCRU_BLUE_CB_RED_CR_LUT[i]  = ((  ((int32_t) ((0.5 )    * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    SCRU_GREEN_CR_LUT[i]        = (((-((int32_t) ((0.4187 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-    SCRU_BLUE_CR_LUT[i]         = (((-((int32_t) ((0.0813 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
-  }
-}
-
 int SCRL_Init(SCRL_LayerConfig *layers_config[SCRL_LAYER_NB], SCRL_ScreenConfig *screen_config)
 {
   struct scrl_usb_ctx *ctx = &scrl_ctx;
+  SCRL_ScreenConfig composition_config;
   int ret;
 
   ret = SCRU_validate_parameters(layers_config, screen_config);
   if (ret)
     return ret;
 
-  SCRL_Init_Lut();
+  SCRY_Init();
+
+  /* common part only deals with composition buffer */
+  composition_config = *screen_config;
+  if (screen_config->format == SCRL_JPEG) {
+    composition_config.format = SCRL_YUV422;
+    composition_config.address = screen_config->composition_address;
+    SCRJ_Init(screen_config->jpeg_quality ? screen_config->jpeg_quality : SCRJ_QUALITY_DEFAULT);
+  }
 
-  ret = SCRC_Init(layers_config, screen_config, &ctx->common);
+  ret = SCRC_Init(layers_config, &composition_config, &ctx->common);
   if (ret)
     return ret;
 
+  ctx->format = screen_config->format;
+  /* uvcl default max frame size for jpeg */
+  ctx->frame_buffer_size = ctx->format == SCRL_JPEG ? screen_config->size.width * screen_config->size.height :
+                                                      get_screen_buffer_size(&ctx->common);
+
   ctx->usb_cbs.frame_release = usb_frame_release_cb;
-  ctx->is_screen_ready_to_update = 1;
+  ctx->screen_base = screen_config->address;
+  ctx->screen_buffer_nb = screen_config->buffer_nb ? screen_config->buffer_nb : 1;
 
   SCRU_usb_init(USB1_OTG_HS, ctx);
 
@@ -487,6 +555,7 @@ int SRCL_Update(void)
   struct scrl_usb_ctx *ctx = &scrl_ctx;
   int ret = 0;
 
+  SCRL_TRACE_INSTANT(UPDATE, 0);
 #ifdef SCR_LIB_USE_THREADX
   tx_semaphore_ceiling_put(&ctx->update_sem, 1);
 #elif defined(SCR_LIB_USE_FREERTOS)
@@ -498,6 +567,20 @@ int SRCL_Update(void)
   return ret;
 }
 
+int SCRL_SetComposition(SCRL_Composition composition)
+{
+  struct scrl_usb_ctx *ctx = &scrl_ctx;
+
+  if (composition == SCRL_COMPOSITION_CPU && !SCRU_is_cpu_composition_supported(&ctx->common))
+    return -1;
+
+  ctx->probe_nb[0] = ctx->probe_nb[1] = 0;
+  ctx->probe_cycles[0] = ctx->probe_cycles[1] = 0;
+  ctx->composition = composition;
+
+  return 0;
+}
+
 void HAL_PCD_MspInit(PCD_HandleTypeDef *hpcd)
 {
   assert(hpcd == &uvcl_pcd_handle);
@@ -0,0 +1,259 @@
+#include "scrl_yuv.h"
+
+#include <string.h>
+
+/* Vector path relies on gcc vector extensions. Only enable it when target has a vector unit, else gcc lowers it to
+ * scalar code that is slower than luts.
+ */
+#ifndef SCRY_USE_VECTOR
+#if defined(__ARM_FEATURE_MVE) || defined(__ARM_NEON) || defined(__SSE2__)
+#define SCRY_USE_VECTOR 1
+#else
+#define SCRY_USE_VECTOR 0
+#endif
+#endif
+
+#define COEF(_c_) ((int32_t) ((_c_) * (1L << 16)))
+#define K_RED_Y      COEF(0.299)
+#define K_GREEN_Y    COEF(0.587)
+#define K_BLUE_Y     COEF(0.114)
+#define K_RED_CB    -COEF(0.1687)
+#define K_GREEN_CB  -COEF(0.3313)
+#define K_BLUE_CB    COEF(0.5)
+#define K_RED_CR     COEF(0.5)
+#define K_GREEN_CR  -COEF(0.4187)
+#define K_BLUE_CR   -COEF(0.0813)
+#define TERM(_k_, _v_) ((((_k_) * (_v_)) + ((int32_t) 1 << (16 - 1))) >> 16)
+
+/* exact (x + 127) / 255 for x in [0, 255 * 255] */
+#define DIV255(_x_) ((((_x_) + 127) * 0x8081) >> 23)
+
+#define CLAMP(v, v_min, v_max) do { \
+  v = v < v_min ? v_min : v; \
+  v = v > v_max ? v_max : v; \
+} while (0)
+
+#define RGB_2_Y(r, g, b, y) do { \
+  y = SCRU_RED_Y_LUT[r] + SCRU_GREEN_Y_LUT[g] + SCRU_BLUE_Y_LUT[b]; \
+  CLAMP(y, 0, 255); \
+} while(0)
+
+#define RGB_2_CR(r, g, b, cr) do { \
+  cr = SCRU_BLUE_CB_RED_CR_LUT[r] + SCRU_GREEN_CR_LUT[g] + SCRU_BLUE_CR_LUT[b] + 128; \
+  CLAMP(cr, 0, 255); \
+} while(0)
+
+#define RGB_2_CB(r, g, b, cb) do { \
+  cb = SCRU_RED_CB_LUT[r] + SCRU_GREEN_CB_LUT[g] + SCRU_BLUE_CB_RED_CR_LUT[b] + 128; \
+  CLAMP(cb, 0, 255); \
+} while(0)
+
+static int32_t SCRU_RED_Y_LUT[256];
+static int32_t SCRU_RED_CB_LUT[256];
+static int32_t SCRU_BLUE_CB_RED_CR_LUT[256];
+static int32_t SCRU_GREEN_Y_LUT[256];
+static int32_t SCRU_GREEN_CR_LUT[256];
+static int32_t SCRU_GREEN_CB_LUT[256];
+static int32_t SCRU_BLUE_Y_LUT[256];
+static int32_t SCRU_BLUE_CR_LUT[256];
+
+static inline uint8_t expand5(uint32_t v)
+{
+  return (v << 3) | (v >> 2);
+}
+
+static inline uint8_t expand6(uint32_t v)
+{
+  return (v << 2) | (v >> 4);
+}
+
+static void SCRU_cvt_dual_pel_rgb_to_yuv(uint8_t *r, uint8_t *g, uint8_t *b, int32_t *y, int32_t *cb, int32_t *cr)
+{
+  uint8_t red, green, blue;
+
+  RGB_2_Y(r[0], g[0], b[0], y[0]);
+  RGB_2_Y(r[1], g[1], b[1], y[1]);
+
+  red = (r[0] + r[1] + 1) / 2;
+  green = (g[0] + g[1] + 1) / 2;
+  blue = (b[0] + b[1] + 1) / 2;
+
+  RGB_2_CR(red, green, blue, cr[0]);
+  RGB_2_CB(red, green, blue, cb[0]);
+}
+
+static inline void store_dual_pel(uint8_t *p_dst, uint8_t *r, uint8_t *g, uint8_t *b)
+{
+  int32_t luma[2];
+  int32_t cb, cr;
+
+  SCRU_cvt_dual_pel_rgb_to_yuv(r, g, b, luma, &cb, &cr);
+  p_dst[0] = luma[0];
+  p_dst[1] = cb;
+  p_dst[2] = luma[1];
+  p_dst[3] = cr;
+}
+
+static inline void blend_pel(uint16_t bg, uint16_t fg, uint8_t *r, uint8_t *g, uint8_t *b)
+{
+  uint32_t a = (fg >> 12) * 17;
+
+  *r = expand5(bg >> 11);
+  *g = expand6((bg >> 5) & 0x3f);
+  *b = expand5(bg & 0x1f);
+  /* transparent pixel keeps background as is */
+  if (!a)
+    return;
+
+  *r = expand5(DIV255(((fg >> 8) & 0xf) * 17 * a + *r * (255 - a)) >> 3);
+  *g = expand6(DIV255(((fg >> 4) & 0xf) * 17 * a + *g * (255 - a)) >> 2);
+  *b = expand5(DIV255(((fg >> 0) & 0xf) * 17 * a + *b * (255 - a)) >> 3);
+}
+
+#if SCRY_USE_VECTOR
+typedef int32_t v4si __attribute__((vector_size(16)));
+typedef uint32_t v4su __attribute__((vector_size(16)));
+
+static inline v4si v_clamp_u8(v4si v)
+{
+  v = v & ~(v < 0);
+  return (v & ~(v > 255)) | (255 & (v > 255));
+}
+
+static inline v4si v_expand(v4si v, int bits)
+{
+  return (v << (8 - bits)) | (v >> (2 * bits - 8));
+}
+
+/* blend one pixel per lane. Same arithmetic as blend_pel(), transparent lanes give back background */
+static inline void v_blend(v4si bg, v4si fg, v4si *r, v4si *g, v4si *b)
+{
+  v4si a = ((fg >> 12) & 0xf) * 17;
+  v4si na = 255 - a;
+
+  *r = v_expand(DIV255(((fg >> 8) & 0xf) * 17 * a + v_expand((bg >> 11) & 0x1f, 5) * na) >> 3, 5);
+  *g = v_expand(DIV255(((fg >> 4) & 0xf) * 17 * a + v_expand((bg >> 5) & 0x3f, 6) * na) >> 2, 6);
+  *b = v_expand(DIV255(((fg >> 0) & 0xf) * 17 * a + v_expand((bg >> 0) & 0x1f, 5) * na) >> 3, 5);
+}
+
+static inline v4si v_luma(v4si r, v4si g, v4si b)
+{
+  return v_clamp_u8(TERM(K_RED_Y, r) + TERM(K_GREEN_Y, g) + TERM(K_BLUE_Y, b));
+}
+
+static inline void v_unpack(v4si p, v4si *r, v4si *g, v4si *b)
+{
+  *r = v_expand((p >> 11) & 0x1f, 5);
+  *g = v_expand((p >> 5) & 0x3f, 6);
+  *b = v_expand(p & 0x1f, 5);
+}
+
+/* Convert one pixel pair per lane into packed YUY2. Same fixed point arithmetic as luts so result is identical */
+static inline v4su v_rgb_to_yuv422(v4si r0, v4si g0, v4si b0, v4si r1, v4si g1, v4si b1)
+{
+  v4si y0, y1, cb, cr;
+  v4si r, g, b;
+
+  y0 = v_luma(r0, g0, b0);
+  y1 = v_luma(r1, g1, b1);
+  r = (r0 + r1 + 1) >> 1;
+  g = (g0 + g1 + 1) >> 1;
+  b = (b0 + b1 + 1) >> 1;
+  cb = v_clamp_u8(TERM(K_RED_CB, r) + TERM(K_GREEN_CB, g) + TERM(K_BLUE_CB, b) + 128);
+  cr = v_clamp_u8(TERM(K_RED_CR, r) + TERM(K_GREEN_CR, g) + TERM(K_BLUE_CR, b) + 128);
+
+  return (v4su) (y0 | (cb << 8) | (y1 << 16) | (cr << 24));
+}
+
+/* convert 8 pixels. p_dst and p_src can be the same since all loads happen before store */
+static inline void v_rgb565_to_yuv422(uint8_t *p_dst, const uint16_t *p_src)
+{
+  v4si r0, g0, b0, r1, g1, b1;
+  v4su p;
+
+  memcpy(&p, p_src, sizeof(p));
+  v_unpack((v4si) (p & 0xffff), &r0, &g0, &b0);
+  v_unpack((v4si) (p >> 16), &r1, &g1, &b1);
+  p = v_rgb_to_yuv422(r0, g0, b0, r1, g1, b1);
+  memcpy(p_dst, &p, sizeof(p));
+}
+
+/* blend and convert 8 pixels, each lane holds a pixel pair */
+static inline void v_blend_to_yuv422(uint8_t *p_dst, const uint16_t *p_bg, const uint16_t *p_fg)
+{
+  v4si r0, g0, b0, r1, g1, b1;
+  v4su bg, fg;
+
+  memcpy(&bg, p_bg, sizeof(bg));
+  memcpy(&fg, p_fg, sizeof(fg));
+  v_blend((v4si) (bg & 0xffff), (v4si) (fg & 0xffff), &r0, &g0, &b0);
+  v_blend((v4si) (bg >> 16), (v4si) (fg >> 16), &r1, &g1, &b1);
+  bg = v_rgb_to_yuv422(r0, g0, b0, r1, g1, b1);
+  memcpy(p_dst, &bg, sizeof(bg));
+}
+#endif
+
+void SCRY_Init()
+{
+  int i;
+
+  for (i = 0; i <= 255; i++)
+  {
+    SCRU_RED_Y_LUT[i]           = TERM(K_RED_Y, i);
+    SCRU_GREEN_Y_LUT[i]         = TERM(K_GREEN_Y, i);
+    SCRU_BLUE_Y_LUT[i]          = TERM(K_BLUE_Y, i);
+    SCRU_RED_CB_LUT[i]          = TERM(K_RED_CB, i);
+    SCRU_GREEN_CB_LUT[i]        = TERM(K_GREEN_CB, i);
+    /* BLUE_CB_LUT and RED_CR_LUT are identical */
+    SCRU_BLUE_CB_RED_CR_LUT[i]  = TERM(K_BLUE_CB, i);
+    SCRU_GREEN_CR_LUT[i]        = TERM(K_GREEN_CR, i);
+    SCRU_BLUE_CR_LUT[i]         = TERM(K_BLUE_CR, i);
+  }
+}
+
+void SCRY_Rgb565ToYuv422(uint8_t *p_dst, const uint16_t *p_src, int width)
+{
+  uint8_t b[2];
+  uint8_t g[2];
+  uint8_t r[2];
+  uint32_t p;
+  int x = 0;
+
+#if SCRY_USE_VECTOR
+  for (; x + 8 <= width; x += 8, p_dst += 16)
+    v_rgb565_to_yuv422(p_dst, &p_src[x]);
+#endif
+  for (; x < width; x += 2)
+  {
+    memcpy(&p, &p_src[x], sizeof(p));
+
+    b[0] = expand5((p >> 0) & 0x1f);
+    g[0] = expand6((p >> 5) & 0x3f);
+    r[0] = expand5((p >> 11) & 0x1f);
+    b[1] = expand5((p >> 16) & 0x1f);
+    g[1] = expand6((p >> 21) & 0x3f);
+    r[1] = expand5((p >> 27) & 0x1f);
+
+    store_dual_pel(p_dst, r, g, b);
+    p_dst += 4;
+  }
+}
+
+void SCRY_BlendToYuv422(uint8_t *p_dst, const uint16_t *p_bg, const uint16_t *p_fg, int width)
+{
+  uint8_t b[2];
+  uint8_t g[2];
+  uint8_t r[2];
+  int x = 0;
+
+#if SCRY_USE_VECTOR
+  for (; x + 8 <= width; x += 8, p_dst += 16)
+    v_blend_to_yuv422(p_dst, &p_bg[x], &p_fg[x]);
+#endif
+  for (; x < width; x += 2, p_dst += 4)
+  {
+    blend_pel(p_bg[x], p_fg[x], &r[0], &g[0], &b[0]);
+    blend_pel(p_bg[x + 1], p_fg[x + 1], &r[1], &g[1], &b[1]);
+    store_dual_pel(p_dst, r, g, b);
+  }
+}
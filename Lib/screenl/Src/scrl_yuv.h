@@ -0,0 +1,18 @@
+#ifndef _SCRL_YUV_
+#define _SCRL_YUV_
+
+#include <stdint.h>
+
+/* RGB to YUY2 conversion used by usb screen. It has no hardware dependency so it can also be built on host.
+ * width must be even.
+ */
+void SCRY_Init(void);
+/* dst and src can be the same buffer */
+void SCRY_Rgb565ToYuv422(uint8_t *dst, const uint16_t *src, int width);
+/* Blend ARGB4444 fg over RGB565 bg and convert result to YUY2 in a single pass. Output is the same as a blend into
+ * an RGB565 buffer followed by SCRY_Rgb565ToYuv422(). Blend computes each channel as
+ * (fg * a + bg * (255 - a)) / 255 on 8 bits values, rounded to nearest, then truncates it to RGB565.
+ */
+void SCRY_BlendToYuv422(uint8_t *dst, const uint16_t *bg, const uint16_t *fg, int width);
+
+#endif
@@ -7,12 +7,18 @@ SCR_LIB_REL_DIR := $(dir $(lastword $(MAKEFILE_LIST)))
 
 ifeq ($(SCR_LIB_SCREEN_ITF), UVCL)
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_usb.c
+C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_yuv.c
+C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_jpeg.c
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_common.c
+C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_raster.c
 else ifeq ($(SCR_LIB_SCREEN_ITF), LTDC)
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_lcd.c
+C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_raster.c
 else ifeq ($(SCR_LIB_SCREEN_ITF), SPI)
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_spi.c
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_common.c
+C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_raster.c
+C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)Src/scrl_damage.c
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)ili9341/ili9341_reg.c
 C_SOURCES_SCR_LIB += $(SCR_LIB_REL_DIR)ili9341/ili9341.c
 else
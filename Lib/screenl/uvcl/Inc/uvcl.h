@@ -58,12 +58,21 @@ typedef struct uvcl_callbacks {
   void (*frame_release)(struct uvcl_callbacks *cbs, void *frame);
 } UVCL_Callbacks_t;
 
+typedef struct {
+  uint32_t delivered;   /* frames fully sent */
+  uint32_t dropped;     /* frames refused by UVCL_ShowFrame() */
+  uint32_t aborted;     /* frames released without being fully sent since streaming stopped */
+} UVCL_Stats_t;
+
 extern PCD_HandleTypeDef uvcl_pcd_handle;
 
 int UVCL_Init(PCD_TypeDef *pcd_instance, UVCL_Conf_t *conf, UVCL_Callbacks_t *cbs);
 int UVCL_Deinit(void);
 void UVCL_IRQHandler(void);
-/* return 0 if frame will be displayed. else it won't be displayed */
+/* return 0 if frame will be displayed. else it won't be displayed. Up to UVCL_FRAME_QUEUE_NB frames can be queued on
+ * top of the one being sent, frame_release() is called for each of them once sent.
+ */
 int UVCL_ShowFrame(void *frame, int frame_size);
+void UVCL_GetStats(UVCL_Stats_t *stats);
 
 #endif
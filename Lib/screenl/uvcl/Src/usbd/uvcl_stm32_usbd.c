@@ -37,6 +37,11 @@
 #define UVCL_USBD_ATTR
 #endif
 
+/* Without dma, packets are sent straight from frame buffer. Fifo is filled by cpu so frame can stay cached */
+#ifndef UVC_LIB_USE_DMA
+#define UVCL_USBD_ZERO_COPY
+#endif
+
 #define container_of(ptr, type, member) ({ \
   void *__mptr = (ptr); \
   __mptr - offsetof(type,member); \
@@ -45,6 +50,10 @@
 typedef struct {
   USBD_HandleTypeDef usbd_dev;
   UVCL_Ctx_t *p_ctx;
+  /* buffer of packet in flight, resent on iso incomplete */
+  uint8_t *tx_buffer;
+  /* frame bytes hidden by in place header of packet in flight */
+  UVCL_PacketPatch_t tx_patch;
 } UVCL_usbd_ctx_t;
 
 static uint8_t dev_qualifier_desc[USB_LEN_DEV_QUALIFIER_DESC] UVCL_USBD_ATTR;
@@ -165,10 +174,29 @@ static uint8_t UVCL_stm32_usbd_deinit(USBD_HandleTypeDef *p_dev, uint8_t cfgidx)
   return USBD_OK;
 }
 
+static void UVCL_usbd_restore_frame(UVCL_usbd_ctx_t *p_usbd_ctx)
+{
+  UVCL_PacketRestore(&p_usbd_ctx->tx_patch);
+}
+
+/* Return buffer holding header and payload of next packet. In zero copy mode, header is written in place */
+static uint8_t *UVCL_usbd_prepare_packet(UVCL_usbd_ctx_t *p_usbd_ctx, UVCL_OnFlyCtx_t *on_fly_ctx, int len)
+{
+  UVCL_Ctx_t *p_ctx = p_usbd_ctx->p_ctx;
+#ifdef UVCL_USBD_ZERO_COPY
+  const int is_in_place = 1;
+#else
+  const int is_in_place = 0;
+#endif
+
+  return UVCL_PacketPrepare(on_fly_ctx, p_ctx->packet, p_ctx->packet, len, is_in_place, &p_usbd_ctx->tx_patch);
+}
+
 static uint8_t USB_DISP_DataInImpl(USBD_HandleTypeDef *p_dev, int is_incomplete)
 {
-  UVCL_Ctx_t *p_ctx = UVCL_usbd_get_ctx_from_p_dev(p_dev);
+  UVCL_usbd_ctx_t *p_usbd_ctx = container_of(p_dev, UVCL_usbd_ctx_t, usbd_dev);
   int packet_size = is_hs(p_dev) ? UVC_ISO_HS_MPS : UVC_ISO_FS_MPS;
+  UVCL_Ctx_t *p_ctx = p_usbd_ctx->p_ctx;
   UVCL_OnFlyCtx_t *on_fly_ctx;
   int len;
 
@@ -177,16 +205,20 @@ static uint8_t USB_DISP_DataInImpl(USBD_HandleTypeDef *p_dev, int is_incomplete)
 
   if (is_incomplete) {
     len = p_ctx->on_fly_ctx ? p_ctx->on_fly_ctx->prev_len : 0;
-    USBD_LL_Transmit(p_dev, 0x81, p_ctx->packet, len);
+    USBD_LL_Transmit(p_dev, 0x81, p_usbd_ctx->tx_buffer, len);
 
     return USBD_OK;
   }
 
+  /* previous packet is gone */
+  UVCL_usbd_restore_frame(p_usbd_ctx);
+
   /* select new frame */
   if (!p_ctx->on_fly_ctx)
     p_ctx->on_fly_ctx = UVCL_StartNewFrameTransmission(p_ctx, packet_size);
 
   if (!p_ctx->on_fly_ctx) {
+    p_usbd_ctx->tx_buffer = p_ctx->packet;
     USBD_LL_Transmit(p_dev, 0x81, p_ctx->packet, 2);
 
     return USBD_OK;
@@ -194,10 +226,9 @@ static uint8_t USB_DISP_DataInImpl(USBD_HandleTypeDef *p_dev, int is_incomplete)
 
   /* Send next frame packet */
   on_fly_ctx = p_ctx->on_fly_ctx;
-  //printf("S %d\n", on_fly_ctx->packet_index);
-  len = on_fly_ctx->packet_index == (on_fly_ctx->packet_nb - 1) ? on_fly_ctx->last_packet_size + 2 : packet_size;
-  memcpy(&p_ctx->packet[2], on_fly_ctx->cursor, len - 2);
-  USBD_LL_Transmit(p_dev, 0x81, p_ctx->packet, len);
+  len = UVCL_GetPacketLen(on_fly_ctx, packet_size);
+  p_usbd_ctx->tx_buffer = UVCL_usbd_prepare_packet(p_usbd_ctx, on_fly_ctx, len);
+  USBD_LL_Transmit(p_dev, 0x81, p_usbd_ctx->tx_buffer, len);
 
   UVCL_UpdateOnFlyCtx(p_ctx, len);
 
@@ -216,15 +247,13 @@ static int UVCL_usbd_stop_streaming(void *ctx)
 
   p_ctx = UVCL_usbd_get_ctx_from_p_dev(p_dev);
   p_ctx->state = UVCL_STATUS_STOP;
+  USBD_LL_FlushEP(p_dev, 0x81);
+  UVCL_usbd_restore_frame(container_of(p_dev, UVCL_usbd_ctx_t, usbd_dev));
   if (p_ctx->on_fly_ctx)
     UVCL_AbortOnFlyCtx(p_ctx);
-  USBD_LL_FlushEP(p_dev, 0x81);
 
-  /* Also release queue frame */
-  if (p_ctx->p_frame) {
-     p_ctx->cbs->frame_release(p_ctx->cbs, p_ctx->p_frame);
-     p_ctx->p_frame = NULL;
-  }
+  /* Also release queued frames */
+  UVCL_ReleaseQueuedFrames(p_ctx);
 
   if (p_ctx->cbs->streaming_inactive)
     p_ctx->cbs->streaming_inactive(p_ctx->cbs);
@@ -248,7 +277,10 @@ static int UVCL_usbd_start_streaming(void *ctx)
   p_ctx->frame_period_in_ms = 1000 / stream_param.fps;
   p_ctx->packet[0] = 2;
   p_ctx->packet[1] = 0;
+  usbd_ctx.tx_buffer = p_ctx->packet;
   p_ctx->frame_start = HAL_GetTick() - p_ctx->frame_period_in_ms;
+  /* frames queued while streaming was stopping */
+  UVCL_ReleaseQueuedFrames(p_ctx);
   p_ctx->is_starting = 1;
   p_ctx->state = UVCL_STATUS_STREAMING;
 
@@ -65,7 +65,8 @@ static UVCL_Ctx_t *UVCL_usbx_get_ctx_from_stream(struct UX_DEVICE_CLASS_VIDEO_ST
   return UVCL_usbx_get_ctx_from_video_instance(stream->ux_device_class_video_stream_video);
 }
 
-static void UVCL_SendPacket(UVCL_Ctx_t *p_ctx, UX_DEVICE_CLASS_VIDEO_STREAM *stream, int len)
+/* Usbx owns payload buffers. Build header and copy payload straight into it so frame data is only copied once */
+static void UVCL_SendPacket(UVCL_Ctx_t *p_ctx, UX_DEVICE_CLASS_VIDEO_STREAM *stream, uint8_t *payload, int len)
 {
   ULONG buffer_length;
   UCHAR *buffer;
@@ -75,7 +76,10 @@ static void UVCL_SendPacket(UVCL_Ctx_t *p_ctx, UX_DEVICE_CLASS_VIDEO_STREAM *str
   assert(ret == UX_SUCCESS);
   assert(buffer_length >= len);
 
-  memcpy(buffer, p_ctx->packet, len);
+  buffer[0] = p_ctx->packet[0];
+  buffer[1] = p_ctx->packet[1];
+  if (len > 2)
+    memcpy(&buffer[2], payload, len - 2);
   ret = ux_device_class_video_write_payload_commit(stream, len);
   assert(ret == UX_SUCCESS);
 }
@@ -97,16 +101,14 @@ static void UVCL_DataIn(struct UX_DEVICE_CLASS_VIDEO_STREAM_STRUCT *stream)
     p_ctx->on_fly_ctx = UVCL_StartNewFrameTransmission(p_ctx, packet_size);
 
   if (!p_ctx->on_fly_ctx) {
-    UVCL_SendPacket(p_ctx, stream, 2);
+    UVCL_SendPacket(p_ctx, stream, NULL, 2);
     return ;
   }
 
   /* Send next frame packet */
   on_fly_ctx = p_ctx->on_fly_ctx;
-  //printf("S %d\n", on_fly_ctx->packet_index);
-  len = on_fly_ctx->packet_index == (on_fly_ctx->packet_nb - 1) ? on_fly_ctx->last_packet_size + 2 : packet_size;
-  memcpy(&p_ctx->packet[2], on_fly_ctx->cursor, len - 2);
-  UVCL_SendPacket(p_ctx, stream, len);
+  len = UVCL_GetPacketLen(on_fly_ctx, packet_size);
+  UVCL_SendPacket(p_ctx, stream, on_fly_ctx->cursor, len);
 
   UVCL_UpdateOnFlyCtx(p_ctx, len);
 }
@@ -119,11 +121,8 @@ static void UVCL_StopStreaming(struct UX_DEVICE_CLASS_VIDEO_STREAM_STRUCT *strea
   if (p_ctx->on_fly_ctx)
     UVCL_AbortOnFlyCtx(p_ctx);
 
-  /* Also release queue frame */
-  if (p_ctx->p_frame) {
-     p_ctx->cbs->frame_release(p_ctx->cbs, p_ctx->p_frame);
-     p_ctx->p_frame = NULL;
-  }
+  /* Also release queued frames */
+  UVCL_ReleaseQueuedFrames(p_ctx);
 
   if (p_ctx->cbs->streaming_inactive)
     p_ctx->cbs->streaming_inactive(p_ctx->cbs);
@@ -143,6 +142,8 @@ static void UVCL_StartStreaming(struct UX_DEVICE_CLASS_VIDEO_STREAM_STRUCT *stre
   p_ctx->packet[0] = 2;
   p_ctx->packet[1] = 0;
   p_ctx->frame_start = HAL_GetTick() - p_ctx->frame_period_in_ms;
+  /* frames queued while streaming was stopping */
+  UVCL_ReleaseQueuedFrames(p_ctx);
   p_ctx->is_starting = 1;
   p_ctx->state = UVCL_STATUS_STREAMING;
 
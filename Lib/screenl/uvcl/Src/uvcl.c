@@ -71,15 +71,7 @@ static int UVCL_FpsOk(UVCL_Ctx_t *p_ctx)
 static void UVCL_FillSentData(UVCL_Ctx_t *p_ctx, UVCL_OnFlyCtx_t *on_fly_ctx, uint8_t *p_frame, int fsize,
                              int packet_size)
 {
-  on_fly_ctx->packet_nb = (fsize + packet_size - 1) / (packet_size - 2);
-  on_fly_ctx->last_packet_size = fsize % (packet_size - 2);
-  if (!on_fly_ctx->last_packet_size)
-  {
-    on_fly_ctx->packet_nb--;
-    on_fly_ctx->last_packet_size = packet_size - 2;
-  }
-  on_fly_ctx->p_frame = p_frame;
-  on_fly_ctx->cursor = p_frame;
+  UVCL_PacketStart(on_fly_ctx, p_frame, fsize, packet_size);
   p_ctx->packet[1] ^= 1;
 
   p_ctx->is_starting = 0;
@@ -88,13 +80,14 @@ static void UVCL_FillSentData(UVCL_Ctx_t *p_ctx, UVCL_OnFlyCtx_t *on_fly_ctx, ui
 
 static UVCL_OnFlyCtx_t *UVCL_StartSelectedRaw(UVCL_Ctx_t *p_ctx, int packet_size)
 {
+  UVCL_QueuedFrame_t *frame = &p_ctx->frames[p_ctx->frame_tail % UVCL_FRAME_QUEUE_NB];
   UVCL_OnFlyCtx_t *on_fly_ctx = &p_ctx->on_fly_storage_ctx;
 
   on_fly_ctx->frame_index = -1;
-  UVCL_FillSentData(p_ctx, on_fly_ctx, p_ctx->p_frame, p_ctx->frame_size, packet_size);
+  UVCL_FillSentData(p_ctx, on_fly_ctx, frame->p_frame, frame->frame_size, packet_size);
 
   __DMB();
-  p_ctx->p_frame = NULL;
+  p_ctx->frame_tail++;
 
   return on_fly_ctx;
 }
@@ -442,7 +435,7 @@ UVCL_OnFlyCtx_t *UVCL_StartNewFrameTransmission(UVCL_Ctx_t *p_ctx, int packet_si
   if (p_ctx->is_starting == 0 && !is_fps_ok)
     return NULL;
 
-  if (!p_ctx->p_frame)
+  if (p_ctx->frame_tail == p_ctx->frame_head)
     return NULL;
 
   return UVCL_StartSelectedRaw(p_ctx, packet_size);
@@ -470,15 +463,12 @@ void UVCL_UpdateOnFlyCtx(UVCL_Ctx_t *p_ctx, int len)
 
   assert(on_fly_ctx);
 
-  on_fly_ctx->packet_index = (on_fly_ctx->packet_index + 1) % on_fly_ctx->packet_nb;
-  on_fly_ctx->cursor += len - 2;
-  on_fly_ctx->prev_len = len;
-
-  if (on_fly_ctx->packet_index)
+  if (!UVCL_PacketNext(on_fly_ctx, len))
     return ;
 
   /* Once displayed we can make frame free */
   assert(on_fly_ctx->p_frame);
+  p_ctx->delivered_nb++;
   p_ctx->cbs->frame_release(p_ctx->cbs, on_fly_ctx->p_frame);
 
   /* We reach last packet */
@@ -491,10 +481,25 @@ void UVCL_AbortOnFlyCtx(UVCL_Ctx_t *p_ctx)
 
   assert(on_fly_ctx);
 
+  p_ctx->aborted_nb++;
   p_ctx->cbs->frame_release(p_ctx->cbs, on_fly_ctx->p_frame);
   p_ctx->on_fly_ctx = NULL;
 }
 
+/* Release frames that were queued but never started. Only call from usb stack context */
+void UVCL_ReleaseQueuedFrames(UVCL_Ctx_t *p_ctx)
+{
+  UVCL_QueuedFrame_t *frame;
+
+  while (p_ctx->frame_tail != p_ctx->frame_head) {
+    frame = &p_ctx->frames[p_ctx->frame_tail % UVCL_FRAME_QUEUE_NB];
+    __DMB();
+    p_ctx->frame_tail++;
+    p_ctx->aborted_nb++;
+    p_ctx->cbs->frame_release(p_ctx->cbs, frame->p_frame);
+  }
+}
+
 uint32_t UVCL_ComputedwMaxVideoFrameSize(UVCL_Ctx_t *ctx, int format_idx, int frame_idx)
 {
   UVCL_Conf_t *conf = &ctx->conf;
@@ -623,24 +628,33 @@ void UVCL_IRQHandler()
 int UVCL_ShowFrame(void *frame, int frame_size)
 {
   UVCL_Ctx_t *p_ctx = p_ctx_single;
+  UVCL_QueuedFrame_t *slot;
 
-  if (p_ctx->state != UVCL_STATUS_STREAMING)
-    return -1;
-  if (p_ctx->p_frame)
-    return -1;
   if (!frame)
     return -1;
   if (!frame_size)
     return -1;
+  if (p_ctx->state != UVCL_STATUS_STREAMING || p_ctx->frame_head - p_ctx->frame_tail >= UVCL_FRAME_QUEUE_NB) {
+    p_ctx->dropped_nb++;
+    return -1;
+  }
 
-  p_ctx->frame_size = frame_size;
+  slot = &p_ctx->frames[p_ctx->frame_head % UVCL_FRAME_QUEUE_NB];
+  slot->p_frame = frame;
+  slot->frame_size = frame_size;
   __DMB();
-  p_ctx->p_frame = frame;
+  p_ctx->frame_head++;
 
-  if (p_ctx->state == UVCL_STATUS_STOP) {
-    p_ctx->p_frame = NULL;
-    return -1;
-  }
+  /* If streaming stopped meanwhile, frame is released on next streaming start */
 
   return 0;
 }
+
+void UVCL_GetStats(UVCL_Stats_t *stats)
+{
+  UVCL_Ctx_t *p_ctx = p_ctx_single;
+
+  stats->delivered = p_ctx ? p_ctx->delivered_nb : 0;
+  stats->dropped = p_ctx ? p_ctx->dropped_nb : 0;
+  stats->aborted = p_ctx ? p_ctx->aborted_nb : 0;
+}
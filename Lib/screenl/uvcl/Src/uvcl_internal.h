@@ -22,6 +22,7 @@
 
 #include "cmsis_compiler.h"
 #include "uvcl.h"
+#include "uvcl_packet.h"
 
 #ifndef MAX
 #define MAX(a,b) ((a)>(b)?(a):(b))
@@ -41,6 +42,11 @@
 #define UVC_MAX_STRING_LEN                              512
 #define UVC_MAX_LANGID_LEN                              2
 
+/* Number of frames UVCL_ShowFrame() can queue while a frame is being sent */
+#ifndef UVCL_FRAME_QUEUE_NB
+#define UVCL_FRAME_QUEUE_NB 2
+#endif
+
 #define UVC_ISO_FS_MPS                                  1023
 #define UVC_ISO_HS_MPS                                  (USBL_PACKET_PER_MICRO_FRAME * 1024)
 
@@ -134,14 +140,9 @@ typedef struct {
 } UVCL_SetupReq_t;
 
 typedef struct {
-  int frame_index;
-  uint8_t *cursor;
-  int packet_nb;
-  int packet_index;
-  int last_packet_size;
-  int prev_len;
   uint8_t *p_frame;
-} UVCL_OnFlyCtx_t;
+  int frame_size;
+} UVCL_QueuedFrame_t;
 
 typedef struct {
   uint8_t bFormatIndex;
@@ -158,8 +159,13 @@ typedef struct {
   uint32_t frame_start;
   int frame_period_in_ms;
   int is_starting;
-  uint8_t *p_frame;
-  int frame_size;
+  /* single producer UVCL_ShowFrame() / single consumer usb stack queue */
+  UVCL_QueuedFrame_t frames[UVCL_FRAME_QUEUE_NB];
+  volatile uint32_t frame_head;
+  volatile uint32_t frame_tail;
+  volatile uint32_t delivered_nb;
+  volatile uint32_t dropped_nb;
+  volatile uint32_t aborted_nb;
   UVCL_OnFlyCtx_t on_fly_storage_ctx;
   UVCL_OnFlyCtx_t *on_fly_ctx;
   UVC_VideoControlTypeDef UVC_VideoCommitControl;
@@ -171,6 +177,7 @@ typedef struct {
 UVCL_OnFlyCtx_t *UVCL_StartNewFrameTransmission(UVCL_Ctx_t *p_ctx, int packet_size);
 void UVCL_UpdateOnFlyCtx(UVCL_Ctx_t *p_ctx, int len);
 void UVCL_AbortOnFlyCtx(UVCL_Ctx_t *p_ctx);
+void UVCL_ReleaseQueuedFrames(UVCL_Ctx_t *p_ctx);
 int UVCL_handle_setup_request(UVCL_Ctx_t *p_ctx, UVCL_SetupReq_t *req);
 uint32_t UVCL_ComputedwMaxVideoFrameSize(UVCL_Ctx_t *ctx, int format_idx, int frame_idx);
 void UVCL_SetupStreamingStream(UVCL_Ctx_t *ctx, UVCL_StreamConf_t *stream);
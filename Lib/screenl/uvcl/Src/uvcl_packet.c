@@ -0,0 +1,80 @@
+/**
+ ******************************************************************************
+ * @file    uvcl_packet.c
+ * @author  MDG Application Team
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "uvcl_packet.h"
+
+#include <stddef.h>
+#include <string.h>
+
+void UVCL_PacketStart(UVCL_OnFlyCtx_t *on_fly_ctx, uint8_t *p_frame, int fsize, int packet_size)
+{
+  /* each packet carries packet_size - 2 bytes of payload, last one carries what remains */
+  on_fly_ctx->packet_nb = (fsize + packet_size - 3) / (packet_size - 2);
+  on_fly_ctx->last_packet_size = fsize - (on_fly_ctx->packet_nb - 1) * (packet_size - 2);
+  /* an aborted frame may have left it anywhere */
+  on_fly_ctx->packet_index = 0;
+  on_fly_ctx->p_frame = p_frame;
+  on_fly_ctx->cursor = p_frame;
+}
+
+int UVCL_GetPacketLen(UVCL_OnFlyCtx_t *on_fly_ctx, int packet_size)
+{
+  return on_fly_ctx->packet_index == (on_fly_ctx->packet_nb - 1) ? on_fly_ctx->last_packet_size + 2 : packet_size;
+}
+
+/* In place header overwrites the two frame bytes in front of the payload. They belong to the previous packet that is
+ * already sent, and they are restored on next packet. First packet has no room in front of it. Last packet would keep
+ * frame in use after its release. Both go through bounce buffer.
+ */
+uint8_t *UVCL_PacketPrepare(UVCL_OnFlyCtx_t *on_fly_ctx, const uint8_t *header, uint8_t *bounce, int len,
+                            int is_in_place, UVCL_PacketPatch_t *patch)
+{
+  uint8_t *buffer;
+
+  if (is_in_place && on_fly_ctx->packet_index && on_fly_ctx->packet_index != on_fly_ctx->packet_nb - 1) {
+    buffer = on_fly_ctx->cursor - 2;
+    patch->saved[0] = buffer[0];
+    patch->saved[1] = buffer[1];
+    patch->patched = buffer;
+  } else {
+    buffer = bounce;
+    memcpy(&buffer[2], on_fly_ctx->cursor, len - 2);
+  }
+  buffer[0] = header[0];
+  buffer[1] = header[1];
+
+  return buffer;
+}
+
+void UVCL_PacketRestore(UVCL_PacketPatch_t *patch)
+{
+  if (!patch->patched)
+    return;
+
+  patch->patched[0] = patch->saved[0];
+  patch->patched[1] = patch->saved[1];
+  patch->patched = NULL;
+}
+
+int UVCL_PacketNext(UVCL_OnFlyCtx_t *on_fly_ctx, int len)
+{
+  on_fly_ctx->packet_index = (on_fly_ctx->packet_index + 1) % on_fly_ctx->packet_nb;
+  on_fly_ctx->cursor += len - 2;
+  on_fly_ctx->prev_len = len;
+
+  return on_fly_ctx->packet_index == 0;
+}
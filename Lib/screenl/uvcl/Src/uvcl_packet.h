@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file    uvcl_packet.h
+ * @author  MDG Application Team
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2024 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#ifndef UVCL_PACKET_H
+#define UVCL_PACKET_H
+
+#include <stdint.h>
+
+/* Split of frames into iso packets. It has no hardware dependency so it can also be built on host.
+ * Each packet starts with a two bytes header and carries up to packet_size - 2 bytes of frame.
+ */
+
+typedef struct {
+  int frame_index;
+  uint8_t *cursor;
+  int packet_nb;
+  int packet_index;
+  int last_packet_size;
+  int prev_len;
+  uint8_t *p_frame;
+} UVCL_OnFlyCtx_t;
+
+/* Frame bytes overwritten by an in place header */
+typedef struct {
+  uint8_t *patched;
+  uint8_t saved[2];
+} UVCL_PacketPatch_t;
+
+void UVCL_PacketStart(UVCL_OnFlyCtx_t *on_fly_ctx, uint8_t *p_frame, int fsize, int packet_size);
+/* Length of next packet including its two bytes header */
+int UVCL_GetPacketLen(UVCL_OnFlyCtx_t *on_fly_ctx, int packet_size);
+/* Return buffer holding header and payload of next packet of len bytes. When is_in_place is set, header overwrites
+ * the two frame bytes in front of the payload when possible, and patch keeps them until UVCL_PacketRestore(). Else
+ * header and payload are copied into bounce buffer.
+ */
+uint8_t *UVCL_PacketPrepare(UVCL_OnFlyCtx_t *on_fly_ctx, const uint8_t *header, uint8_t *bounce, int len,
+                            int is_in_place, UVCL_PacketPatch_t *patch);
+/* Give back frame bytes hidden by in place header once packet is sent */
+void UVCL_PacketRestore(UVCL_PacketPatch_t *patch);
+/* Move to next packet after a packet of len bytes is sent. Return 1 when it was the last packet of the frame */
+int UVCL_PacketNext(UVCL_OnFlyCtx_t *on_fly_ctx, int len);
+
+#endif
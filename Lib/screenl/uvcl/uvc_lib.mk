@@ -20,6 +20,7 @@ endif
 
 C_SOURCES_UVC_LIB += $(UVC_LIB_REL_DIR)/Src/uvcl.c
 C_SOURCES_UVC_LIB += $(UVC_LIB_REL_DIR)/Src/uvcl_desc.c
+C_SOURCES_UVC_LIB += $(UVC_LIB_REL_DIR)/Src/uvcl_packet.c
 
 C_INCLUDES_UVC_LIB += -I$(UVC_LIB_REL_DIR)/Inc
 C_INCLUDES_UVC_LIB += -I$(UVC_LIB_REL_DIR)/Src
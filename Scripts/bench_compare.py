@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Extract benchmark reports printed by the application when USE_BENCHMARK is defined and compare them.
+
+Report lines have the form 'bench,{json}'. With a single log, reports are printed as a json list. With two logs,
+the median of each metric over all reports of each log is compared and the script exits with status 1 when the
+candidate regresses more than the threshold.
+
+Examples:
+    bench_compare.py console.log > bench.json
+    bench_compare.py baseline.log candidate.log --threshold 5
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+# metric name, higher is better
+METRICS = [
+    ('fps', True),
+    ('detections_per_s', True),
+    ('cpu_load', False),
+]
+STAGE_METRICS = ('p50', 'p99')
+
+
+def read_reports(path):
+    reports = []
+    with open(path, 'r', errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith('bench,{'):
+                continue
+            try:
+                reports.append(json.loads(line[len('bench,'):]))
+            except ValueError:
+                # truncated line
+                continue
+    return reports
+
+
+def summarize(reports):
+    res = {}
+    for name, _ in METRICS:
+        res[name] = statistics.median(r[name] for r in reports)
+    for stage in reports[0]['latency_us']:
+        for m in STAGE_METRICS:
+            values = [r['latency_us'][stage][m] for r in reports if r['latency_us'][stage]['n']]
+            if values:
+                res['%s_%s_us' % (stage, m)] = statistics.median(values)
+    for queue in reports[0]['drops']:
+        res['drops_%s' % queue] = sum(r['drops'][queue] for r in reports)
+    return res
+
+
+def higher_is_better(name):
+    for metric, hib in METRICS:
+        if metric == name:
+            return hib
+    # latencies and drops
+    return False
+
+
+def compare(base, cand, threshold, out):
+    is_regression = False
+    out.write('%-28s %12s %12s %9s\n' % ('metric', 'baseline', 'candidate', 'delta %'))
+    for name in base:
+        if name not in cand:
+            continue
+        b = base[name]
+        c = cand[name]
+        delta = 100.0 * (c - b) / b if b else (0.0 if c == b else float('inf'))
+        worse = delta < -threshold if higher_is_better(name) else delta > threshold
+        # drop counters are only regressions when they appear
+        if name.startswith('drops_'):
+            worse = c > b
+        is_regression |= worse
+        out.write('%-28s %12.2f %12.2f %9.1f%s\n' % (name, b, c, delta, '  <- regression' if worse else ''))
+    return is_regression
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('baseline', help='console log holding baseline reports')
+    parser.add_argument('candidate', nargs='?', help='console log holding candidate reports')
+    parser.add_argument('--threshold', type=float, default=5.0, help='tolerated degradation in percent (default 5)')
+    args = parser.parse_args()
+
+    base = read_reports(args.baseline)
+    if not base:
+        sys.exit('no benchmark report found in %s' % args.baseline)
+    if not args.candidate:
+        json.dump(base, sys.stdout, indent=2)
+        sys.stdout.write('\n')
+        return
+
+    cand = read_reports(args.candidate)
+    if not cand:
+        sys.exit('no benchmark report found in %s' % args.candidate)
+    if compare(summarize(base), summarize(cand), args.threshold, sys.stdout):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Check and measure screen damage tracking of Lib/screenl/Src/scrl_damage.c.
+
+Lib/screenl/Src/scrl_damage.c is compiled with the host C compiler and driven through ctypes. Random damage sets,
+rectangles partly or fully off screen included, are added to a damage region, as changed areas reported between two
+updates would be.
+
+--check verifies for every set that:
+    - every damaged pixel is covered,
+    - there are at most SCRD_RECT_NB rectangles, all on screen, and a full screen one once damage is full,
+    - SCRD_NextChunk() chunks are at most max_len bytes and cover the bytes of each rectangle exactly, in order.
+
+Default mode gives, for sets of --rects rectangles on a screen of --width x --height:
+    rects       rectangles left after merge
+    sent        sent pixels over damaged pixels
+    full        share of sets sent as full screen
+    us/add      host time of one SCRD_Add() call, ctypes call overhead removed
+
+Examples:
+    damage_check.py
+    damage_check.py --check                      # 20000 random sets, non zero exit on failure
+    damage_check.py --rects 1,4,16 --max-size 40
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+import time
+
+import hostbuild
+
+# Keep in sync with Lib/screenl/Src/scrl_damage.h
+SCRD_RECT_NB = 8
+
+
+# Keep in sync with Lib/screenl/Inc/scrl.h and Lib/screenl/Src/scrl_damage.h
+class Point(ctypes.Structure):
+    _fields_ = [('x', ctypes.c_uint16), ('y', ctypes.c_uint16)]
+
+
+class Size(ctypes.Structure):
+    _fields_ = [('width', ctypes.c_uint16), ('height', ctypes.c_uint16)]
+
+
+class Rect(ctypes.Structure):
+    _fields_ = [('origin', Point), ('size', Size)]
+
+
+class Damage(ctypes.Structure):
+    _fields_ = [('screen', Size), ('rects', Rect * SCRD_RECT_NB), ('nb', ctypes.c_int), ('is_full', ctypes.c_int)]
+
+
+def build_damage(build):
+    lib = build.lib('scrd', ['Lib/screenl/Src/scrl_damage.c'], includes=['Lib/screenl/Inc'])
+    lib.SCRD_Init.argtypes = [ctypes.POINTER(Damage), Size]
+    lib.SCRD_Add.argtypes = [ctypes.POINTER(Damage), ctypes.POINTER(Rect)]
+    lib.SCRD_NextChunk.argtypes = [ctypes.POINTER(Rect), Size, ctypes.c_int, ctypes.c_int,
+                                   ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]
+    return lib
+
+
+def random_rect(width, height, max_size, rnd):
+    """(x, y, w, h), origin may be off screen"""
+    return (rnd.randint(0, width + 4), rnd.randint(0, height + 4), rnd.randint(0, max_size), rnd.randint(0, max_size))
+
+
+def add_set(lib, width, height, rects):
+    damage = Damage()
+    lib.SCRD_Init(ctypes.byref(damage), Size(width, height))
+    for x, y, w, h in rects:
+        lib.SCRD_Add(ctypes.byref(damage), ctypes.byref(Rect(Point(x, y), Size(w, h))))
+    return damage
+
+
+def row_masks(width, height, rects):
+    """One int bit mask per row of pixels covered by rects, clipped to screen"""
+    masks = [0] * height
+    for x, y, w, h in rects:
+        x1, y1 = min(x + w, width), min(y + h, height)
+        if x1 <= x or y1 <= y:
+            continue
+        bits = ((1 << (x1 - x)) - 1) << x
+        for row in range(y, y1):
+            masks[row] |= bits
+    return masks
+
+
+def chunks(lib, rect, screen, bpp, max_len):
+    pos, offset = ctypes.c_int(0), ctypes.c_int(0)
+    out = []
+    while True:
+        length = lib.SCRD_NextChunk(ctypes.byref(rect), screen, bpp, max_len, ctypes.byref(pos),
+                                    ctypes.byref(offset))
+        if not length:
+            return out
+        out.append((offset.value, length))
+
+
+def merge_ranges(ranges):
+    """Concatenate contiguous (offset, len) ranges"""
+    out = []
+    for offset, length in ranges:
+        if out and out[-1][0] + out[-1][1] == offset:
+            out[-1] = (out[-1][0], out[-1][1] + length)
+        else:
+            out.append((offset, length))
+    return out
+
+
+def check_set(lib, width, height, rects, bpp, max_len):
+    """Return list of failures for one damage set"""
+    damage = add_set(lib, width, height, rects)
+    out = [(r.origin.x, r.origin.y, r.size.width, r.size.height) for r in damage.rects[:damage.nb]]
+    errors = []
+    if damage.nb > SCRD_RECT_NB:
+        errors.append('too many rectangles')
+    if any(w <= 0 or h <= 0 or x + w > width or y + h > height for x, y, w, h in out):
+        errors.append('rectangle off screen')
+    if damage.is_full and out != [(0, 0, width, height)]:
+        errors.append('full damage is not a full screen rectangle')
+    covered = row_masks(width, height, out)
+    if any(d & ~c for d, c in zip(row_masks(width, height, rects), covered)):
+        errors.append('damaged pixel not covered')
+    screen = Size(width, height)
+    for r, (x, y, w, h) in zip(damage.rects[:damage.nb], out):
+        got = chunks(lib, r, screen, bpp, max_len)
+        expected = merge_ranges([(((y + row) * width + x) * bpp, w * bpp) for row in range(h)])
+        if any(length > max_len for _, length in got) or merge_ranges(got) != expected:
+            errors.append('chunks do not cover rectangle')
+    return errors
+
+
+def check(lib, sets, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    errors = {}
+    for i in range(sets):
+        # mostly small screens so sets are dense, some ILI9341 sized ones
+        width, height = (240, 320) if i % 10 == 0 else (rnd.randint(1, 96), rnd.randint(1, 96))
+        max_size = rnd.choice((4, 16, max(width, height)))
+        rects = [random_rect(width, height, max_size, rnd) for _ in range(rnd.randint(1, 24))]
+        bpp = rnd.choice((2, 3))
+        # chunks split pixels and rows, or hold several full width rows
+        max_len = rnd.choice((width * bpp - 1, width * bpp, 63 * 1024) + ((1, 7) if i % 10 else (500,)))
+        for error in check_set(lib, width, height, rects, bpp, max_len):
+            if error not in errors:
+                print('  %s: screen %dx%d bpp %d max_len %d rects %s' % (error, width, height, bpp, max_len, rects))
+            errors[error] = errors.get(error, 0) + 1
+    for error, name in (('damaged pixel not covered', 'damaged pixels covered'),
+                        ('too many rectangles', 'at most %d rectangles' % SCRD_RECT_NB),
+                        ('rectangle off screen', 'rectangles on screen'),
+                        ('full damage is not a full screen rectangle', 'full damage is whole screen'),
+                        ('chunks do not cover rectangle', 'chunks cover rectangles exactly')):
+        expect('%s on %d random sets' % (name, sets), error not in errors)
+
+    # nothing on screen gives no damage
+    damage = add_set(lib, 240, 320, [(240, 0, 10, 10), (0, 320, 10, 10), (5, 5, 0, 10)])
+    expect('off screen and empty rectangles are ignored', damage.nb == 0 and not damage.is_full)
+    damage = add_set(lib, 240, 320, [(0, 0, 240, 320)])
+    expect('whole screen damage is full', damage.is_full and damage.nb == 1)
+
+    return checker.ok()
+
+
+def call_overhead(lib, loops):
+    damage = Damage()
+    lib.SCRD_Init(ctypes.byref(damage), Size(16, 16))
+    damage.is_full = 1
+    rect = Rect(Point(0, 0), Size(1, 1))
+    start = time.perf_counter()
+    for _ in range(loops):
+        lib.SCRD_Add(ctypes.byref(damage), ctypes.byref(rect))
+    return (time.perf_counter() - start) / loops
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run random set checks instead of measure')
+    parser.add_argument('--sets', type=int, default=20000, help='random sets (default: 20000 in check, 2000 else)')
+    parser.add_argument('--width', type=int, default=240, help='screen width (default: 240)')
+    parser.add_argument('--height', type=int, default=320, help='screen height (default: 320)')
+    parser.add_argument('--rects', default='1,2,4,8,16',
+                        help='comma separated rectangles per set (default: 1,2,4,8,16)')
+    parser.add_argument('--max-size', type=int, default=60, help='largest rectangle side (default: 60)')
+    hostbuild.add_arguments(parser)
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build_damage(build)
+        if args.check:
+            sys.exit(0 if check(lib, args.sets, args.seed) else 1)
+
+        sets = min(args.sets, 2000)
+        overhead = call_overhead(lib, 20000)
+        width, height = args.width, args.height
+        out = sys.stdout
+        out.write('%6s %6s %6s %6s %8s\n' % ('added', 'rects', 'sent', 'full', 'us/add'))
+        for nb in [int(v) for v in args.rects.split(',')]:
+            rnd = random.Random(args.seed)
+            rect_nb = full = 0
+            sent = damaged = 0
+            add_s = 0.0
+            for _ in range(sets):
+                rects = [(rnd.randint(0, width - 1), rnd.randint(0, height - 1), rnd.randint(1, args.max_size),
+                          rnd.randint(1, args.max_size)) for _ in range(nb)]
+                start = time.perf_counter()
+                damage = add_set(lib, width, height, rects)
+                add_s += time.perf_counter() - start
+                rect_nb += damage.nb
+                full += damage.is_full
+                sent += sum(r.size.width * r.size.height for r in damage.rects[:damage.nb])
+                damaged += sum(bin(m).count('1') for m in row_masks(width, height, rects))
+            # add_set() also does an init, counted as one more call
+            us = max(0, add_s / (sets * nb) - overhead * (nb + 1) / nb) * 1e6
+            out.write('%6d %6.2f %6.2f %5.1f%% %8.2f\n' % (nb, rect_nb / sets, sent / damaged, 100.0 * full / sets, us))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Replay nn deadline accounting on host against inference durations.
+
+Src/deadline.c is compiled with the host C compiler and driven through ctypes, so replayed accounting is the one
+running on target. Durations come from a console log, either the nn_run events of trace dumps (USE_TRACE) or the
+inf_ms column of gov,... lines (USE_GOVERNOR), or are drawn around --inf-ms when no log is given. Failed inferences
+are not in these logs, so replay only accounts late ones.
+
+Reported for each budget:
+    misses       late inferences
+    degraded     share of inferences run in degraded mode
+    entries      number of times degraded mode was entered
+    histogram    dl_hist_bound() buckets, as printed by the firmware report
+
+Examples:
+    deadline_check.py
+    deadline_check.py --inf-ms 480 --jitter 0.1 --budget 450,500,550
+    deadline_check.py --replay console.log --window 16 --degrade 4 --recover 1
+    deadline_check.py --check           # accounting checks against a python model, non zero exit on failure
+"""
+
+import argparse
+import collections
+import ctypes
+import random
+import sys
+
+import hostbuild
+import trace2chrome
+
+DL_HIST_NB = 8
+DL_WINDOW_MAX = 32
+
+
+# Keep in sync with Inc/deadline.h
+class DlConf(ctypes.Structure):
+    _fields_ = [('budget_ms', ctypes.c_uint32), ('window', ctypes.c_int), ('degrade_nb', ctypes.c_int),
+                ('recover_nb', ctypes.c_int)]
+
+
+class DlStats(ctypes.Structure):
+    _fields_ = [('run_nb', ctypes.c_uint32), ('miss_nb', ctypes.c_uint32), ('error_nb', ctypes.c_uint32),
+                ('error', ctypes.c_uint32), ('error_run', ctypes.c_uint32), ('last_ms', ctypes.c_uint32),
+                ('worst_ms', ctypes.c_uint32), ('hist', ctypes.c_uint32 * DL_HIST_NB),
+                ('window_miss_nb', ctypes.c_int), ('is_degraded', ctypes.c_int), ('degrade_nb', ctypes.c_uint32)]
+
+
+class DlCtx(ctypes.Structure):
+    _fields_ = [('cfg', DlConf), ('window', ctypes.c_uint32), ('st', DlStats)]
+
+
+def build_deadline(build):
+    lib = build.lib('deadline', ['Src/deadline.c'], includes=['Inc'])
+    lib.dl_init.argtypes = [ctypes.POINTER(DlCtx), ctypes.POINTER(DlConf)]
+    lib.dl_update.argtypes = [ctypes.POINTER(DlCtx), ctypes.c_uint32, ctypes.c_uint32]
+    lib.dl_hist_bound.argtypes = [ctypes.POINTER(DlCtx), ctypes.c_int]
+    lib.dl_hist_bound.restype = ctypes.c_uint32
+    return lib
+
+
+def dl_new(lib, budget_ms, window, degrade_nb, recover_nb):
+    """Return initialized context, None when dl_init() rejects configuration"""
+    ctx = DlCtx()
+    cfg = DlConf(budget_ms, window, degrade_nb, recover_nb)
+    return None if lib.dl_init(ctypes.byref(ctx), ctypes.byref(cfg)) else ctx
+
+
+class RefDeadline:
+    """Python model of Src/deadline.c, written from its header comments"""
+
+    def __init__(self, budget_ms, window, degrade_nb, recover_nb):
+        self.budget_ms, self.degrade_nb, self.recover_nb = budget_ms, degrade_nb, recover_nb
+        self.last = collections.deque(maxlen=window)
+        self.run_nb = self.miss_nb = self.error_nb = self.degrade_count = 0
+        self.is_degraded = 0
+
+    def update(self, ms, error):
+        self.run_nb += 1
+        is_miss = bool(error) or ms > self.budget_ms
+        self.miss_nb += is_miss
+        self.error_nb += bool(error)
+        self.last.append(is_miss)
+        window_miss_nb = sum(self.last)
+        if not self.is_degraded and window_miss_nb >= self.degrade_nb:
+            self.is_degraded = 1
+            self.degrade_count += 1
+            return 1
+        if self.is_degraded and window_miss_nb <= self.recover_nb:
+            self.is_degraded = 0
+            return 1
+        return 0
+
+
+def check(lib, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+
+    expect('init rejects null budget', dl_new(lib, 0, 8, 4, 1) is None)
+    expect('init rejects window out of 1..DL_WINDOW_MAX',
+           dl_new(lib, 100, 0, 1, 0) is None and dl_new(lib, 100, DL_WINDOW_MAX + 1, 4, 1) is None)
+    expect('init rejects degrade above window', dl_new(lib, 100, 8, 9, 1) is None)
+    expect('init rejects recover not below degrade', dl_new(lib, 100, 8, 4, 4) is None)
+    expect('init accepts full window', dl_new(lib, 100, DL_WINDOW_MAX, DL_WINDOW_MAX, 0) is not None)
+
+    ctx = dl_new(lib, 400, 8, 4, 1)
+    bounds = [lib.dl_hist_bound(ctypes.byref(ctx), i) for i in range(DL_HIST_NB)]
+    expect('histogram bounds increase up to UINT32_MAX',
+           all(a < b for a, b in zip(bounds, bounds[1:])) and bounds[-1] == 0xffffffff and 400 in bounds)
+    for ms in (0, 199, 200, 400, 401, 1199, 1200, 100000):
+        lib.dl_update(ctypes.byref(ctx), ms, 0)
+    hist = list(ctx.st.hist)
+    expect('each duration lands in its bucket', hist == [
+        sum(1 for ms in (0, 199, 200, 400, 401, 1199, 1200, 100000) if ms < b and (i == 0 or ms >= bounds[i - 1]))
+        for i, b in enumerate(bounds)])
+    expect('on budget is not a miss, one above is', ctx.st.miss_nb == 4 and ctx.st.worst_ms == 100000)
+
+    # random sequences, misses and errors in bursts so mode toggles
+    bad = 0
+    for _ in range(300):
+        window = rnd.choice([1, 2, 5, 8, 16, 31, DL_WINDOW_MAX])
+        degrade_nb = rnd.randint(1, window)
+        recover_nb = rnd.randint(0, degrade_nb - 1)
+        ctx = dl_new(lib, 100, window, degrade_nb, recover_nb)
+        ref = RefDeadline(100, window, degrade_nb, recover_nb)
+        late = 0.5
+        for _ in range(200):
+            if rnd.random() < 0.05:
+                late = rnd.random()
+            ms = rnd.randint(101, 300) if rnd.random() < late else rnd.randint(0, 100)
+            error = rnd.getrandbits(32) or 1 if rnd.random() < 0.05 else 0
+            changed = lib.dl_update(ctypes.byref(ctx), ms, error)
+            st = ctx.st
+            if (changed != ref.update(ms, error) or st.is_degraded != ref.is_degraded or
+                    st.window_miss_nb != sum(ref.last) or st.degrade_nb != ref.degrade_count or
+                    (error and (st.error != error or st.error_run != st.run_nb))):
+                bad += 1
+                break
+        st = ctx.st
+        bad += (st.run_nb, st.miss_nb, st.error_nb, sum(st.hist)) != (ref.run_nb, ref.miss_nb, ref.error_nb, 200)
+    expect('300 random sequences match python model', bad == 0)
+
+    ctx = dl_new(lib, 100, 8, 4, 1)
+    changes = [lib.dl_update(ctypes.byref(ctx), ms, 0) for ms in [200] * 4 + [50] * 7]
+    expect('degrades at 4 misses, recovers once 1 is left', changes == [0, 0, 0, 1] + [0] * 6 + [1])
+    ctx = dl_new(lib, 100, 8, 4, 1)
+    changes = [lib.dl_update(ctypes.byref(ctx), ms, 0) for ms in [200, 50] * 4]
+    expect('every other inference late degrades', changes == [0] * 6 + [1, 0] and ctx.st.is_degraded)
+
+    return checker.ok()
+
+
+def parse_durations(lines):
+    """Return inference durations in ms of trace dumps, else of gov,... lines"""
+    lines = list(lines)
+    durations = []
+    for dump in trace2chrome.parse_dumps(lines):
+        ids = [i for i, name in dump['names'].items() if name == 'nn_run']
+        start = None
+        for ts, _, evt_id, evt_type, _ in dump['events']:
+            if evt_id not in ids:
+                continue
+            if evt_type == trace2chrome.TYPE_BEGIN:
+                start = ts
+            elif evt_type == trace2chrome.TYPE_END and start is not None:
+                durations.append(round(((ts - start) & 0xffffffff) * 1000 / dump['cpu_hz']))
+                start = None
+    if durations:
+        return durations
+    for line in lines:
+        items = line.strip().split(',')
+        if len(items) > 4 and items[0] == 'gov' and items[1].isdigit():
+            durations.append(int(items[4]))
+    return durations
+
+
+def replay(lib, durations, budget_ms, args):
+    ctx = dl_new(lib, budget_ms, args.window, args.degrade, args.recover)
+    if ctx is None:
+        sys.exit('dl_init rejects budget %d window %d degrade %d recover %d' % (budget_ms, args.window,
+                                                                                 args.degrade, args.recover))
+    degraded_nb = 0
+    for ms in durations:
+        lib.dl_update(ctypes.byref(ctx), ms, 0)
+        degraded_nb += ctx.st.is_degraded
+    bounds = [lib.dl_hist_bound(ctypes.byref(ctx), i) for i in range(DL_HIST_NB - 1)]
+    hist = ' '.join(['<%d:%d' % (b, n) for b, n in zip(bounds, ctx.st.hist)] + ['more:%d' % ctx.st.hist[-1]])
+    return ctx.st.miss_nb, degraded_nb / len(durations), ctx.st.degrade_nb, hist
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run accounting checks instead of replay')
+    parser.add_argument('--replay', metavar='LOG', help='console log with trace dumps or gov lines')
+    parser.add_argument('--budget', default='500', help='comma separated DEADLINE_BUDGET_MS (default: 500)')
+    parser.add_argument('--window', type=int, default=32, help='DEADLINE_WINDOW_NB (default: 32)')
+    parser.add_argument('--degrade', type=int, default=8, help='DEADLINE_DEGRADE_NB (default: 8)')
+    parser.add_argument('--recover', type=int, default=2, help='DEADLINE_RECOVER_NB (default: 2)')
+    parser.add_argument('--inf-ms', type=float, default=450, help='mean synthetic inference ms (default: 450)')
+    parser.add_argument('--jitter', type=float, default=0.08, help='relative synthetic jitter (default: 0.08)')
+    parser.add_argument('--runs', type=int, default=3000, help='synthetic inferences (default: 3000)')
+    hostbuild.add_arguments(parser)
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build_deadline(build)
+        if args.check:
+            sys.exit(0 if check(lib, args.seed) else 1)
+
+        if args.replay:
+            with open(args.replay) as f:
+                durations = parse_durations(f)
+            if not durations:
+                sys.exit('no nn_run trace event nor gov line in %s' % args.replay)
+        else:
+            rnd = random.Random(args.seed)
+            durations = [max(0, round(rnd.gauss(args.inf_ms, args.inf_ms * args.jitter))) for _ in range(args.runs)]
+
+        out = sys.stdout
+        out.write('%d inferences, mean %.0f ms, worst %d ms\n' % (len(durations), sum(durations) / len(durations),
+                                                                   max(durations)))
+        out.write('%6s %7s %8s %7s  %s\n' % ('budget', 'misses', 'degraded', 'entries', 'histogram'))
+        for budget_ms in [int(b) for b in args.budget.split(',')]:
+            miss_nb, degraded, entries, hist = replay(lib, durations, budget_ms, args)
+            out.write('%6d %7d %7.1f%% %7d  %s\n' % (budget_ms, miss_nb, degraded * 100, entries, hist))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,395 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Replay governor policies on host against a synthetic scene where people come and go, or against a firmware log.
+
+Src/governor.c is compiled with the host C compiler and driven through ctypes, so simulated policies are the ones
+running on target. The nn thread runs an inference of --inf-ms, or --idle-inf-ms in idle mode, then waits for the
+governor nn period and for next camera frame. The pp thread makes each result visible --pp-ms later. Leaving idle
+mode wakes the nn thread up as on target.
+
+Reported for each policy:
+    nn cpu       share of cpu spent in inference and post process, over whole run and while scene is empty
+    idle         share of time spent in idle mode
+    detect       delay from someone entering the scene to first detection
+    switch       delay from someone entering the scene to first inference at active rate
+    idle entry   delay from scene becoming empty to idle mode
+
+--replay feeds the samples of a console log, the gov,... csv lines printed by the firmware governor, to each policy
+with the configuration of the log. Samples are replayed open loop, as recorded. Reported for each policy:
+    nn period    mean and max minimum period between two inferences
+    conf         mean and max confidence threshold
+    boxes        mean and min max boxes
+    idle         share of samples in idle mode
+    match        share of samples where setpoint is the one recorded by the firmware, which runs presence
+
+Examples:
+    governor_sim.py
+    governor_sim.py --inf-ms 520 --pp-ms 12 --presence 60-90,300-320 --duration 600
+    governor_sim.py --idle-inf-ms 40    # firmware running a smaller model in idle mode
+    governor_sim.py --replay console.log --policy aimd --policy presence
+    governor_sim.py --check             # post process knob and log replay checks, non zero exit on failure
+"""
+
+import argparse
+import ctypes
+import math
+import sys
+
+import hostbuild
+
+
+# Keep in sync with Inc/governor.h
+class GovConf(ctypes.Structure):
+    _fields_ = [('cpu_budget', ctypes.c_float), ('pp_latency_ms', ctypes.c_uint32),
+                ('nn_period_min_ms', ctypes.c_uint32), ('nn_period_max_ms', ctypes.c_uint32),
+                ('conf_min', ctypes.c_float), ('conf_max', ctypes.c_float), ('conf_step', ctypes.c_float),
+                ('max_boxes_min', ctypes.c_int), ('max_boxes_max', ctypes.c_int), ('disp_divider_max', ctypes.c_int),
+                ('idle_delay_ms', ctypes.c_uint32), ('idle_nn_period_ms', ctypes.c_uint32)]
+
+
+class GovSample(ctypes.Structure):
+    _fields_ = [('ts_ms', ctypes.c_uint32), ('cpu_load', ctypes.c_float), ('nn_period_ms', ctypes.c_uint32),
+                ('inf_ms', ctypes.c_uint32), ('pp_ms', ctypes.c_uint32), ('disp_ms', ctypes.c_uint32),
+                ('nb_detect', ctypes.c_int), ('nb_candidates', ctypes.c_int), ('nb_tracks', ctypes.c_int),
+                ('nb_lost', ctypes.c_int)]
+
+
+class GovSetpoint(ctypes.Structure):
+    _fields_ = [('nn_period_ms', ctypes.c_uint32), ('conf_threshold', ctypes.c_float), ('max_boxes', ctypes.c_int),
+                ('disp_divider', ctypes.c_int), ('is_idle', ctypes.c_int)]
+
+
+class GovPresence(ctypes.Structure):
+    _fields_ = [('last_seen_ms', ctypes.c_uint32), ('nn_period_ms', ctypes.c_uint32)]
+
+
+class GovCtx(ctypes.Structure):
+    _fields_ = [('cfg', GovConf), ('policy', ctypes.c_void_p), ('priv', ctypes.c_void_p), ('sp', GovSetpoint)]
+
+
+CONF_FIELDS = [f for f, _ in GovConf._fields_]
+SAMPLE_FIELDS = [f for f, _ in GovSample._fields_]
+SETPOINT_FIELDS = [f for f, _ in GovSetpoint._fields_]
+
+
+def new_ctx(lib, policy, cfg):
+    """Return (ctx, priv) running policy, priv must outlive ctx"""
+    ctx = GovCtx()
+    priv = GovPresence()
+    policy_addr = ctypes.addressof(ctypes.c_char.in_dll(lib, 'gov_policy_' + policy))
+    if lib.gov_init(ctypes.byref(ctx), ctypes.byref(cfg), ctypes.c_void_p(policy_addr), ctypes.byref(priv)):
+        sys.exit('gov_init failed for %s' % policy)
+    return ctx, priv
+
+
+def from_values(struct, values):
+    return struct(*[v if t == ctypes.c_float else int(v) for (_, t), v in zip(struct._fields_, values)])
+
+
+def parse_log(lines):
+    """Return (GovConf, [(GovSample, recorded setpoint tuple)]) from gov,... lines of a console log. Other lines
+    are ignored, so a raw capture of the console can be given as is.
+    """
+    cfg = None
+    samples = []
+    for line in lines:
+        items = line.strip().split(',')
+        if items[0] != 'gov' or len(items) < 2 or items[1] == 'ts_ms':
+            continue
+        try:
+            values = [float(v) for v in items[2:] if items[1] == 'cfg'] or [float(v) for v in items[1:]]
+        except ValueError:
+            continue
+        if items[1] == 'cfg' and len(values) == len(CONF_FIELDS):
+            cfg = from_values(GovConf, values)
+        elif len(values) == len(SAMPLE_FIELDS) + len(SETPOINT_FIELDS):
+            samples.append((from_values(GovSample, values), tuple(values[len(SAMPLE_FIELDS):])))
+    if cfg is None:
+        sys.exit('no gov,cfg line in log')
+    return cfg, samples
+
+
+def format_log(cfg, records):
+    """Lines printed by the firmware for cfg and [(sample, setpoint)]. Keep in sync with gov_log_*() of Src/app.c"""
+    lines = ['gov,cfg,%.1f,%d,%d,%d,%.2f,%.2f,%.2f,%d,%d,%d,%d,%d' % tuple(getattr(cfg, f) for f in CONF_FIELDS),
+             'gov,ts_ms,' + ','.join(SAMPLE_FIELDS[1:] + ['sp_' + f for f in SETPOINT_FIELDS])]
+    for s, sp in records:
+        lines.append('gov,%d,%.2f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.2f,%d,%d,%d' % (
+            tuple(getattr(s, f) for f in SAMPLE_FIELDS) + tuple(getattr(sp, f) for f in SETPOINT_FIELDS)))
+    return lines
+
+
+def replay(lib, policy, cfg, samples):
+    """Return setpoint tuples chosen by policy on recorded samples"""
+    ctx, priv = new_ctx(lib, policy, cfg)
+    out = []
+    for s, _ in samples:
+        lib.gov_update(ctypes.byref(ctx), ctypes.byref(s))
+        out.append(tuple(getattr(ctx.sp, f) for f in SETPOINT_FIELDS))
+    return out
+
+
+def is_same_setpoint(a, b):
+    # confidence threshold is printed with two decimals
+    return all(abs(x - y) < 0.006 for x, y in zip(a, b))
+
+
+def parse_presence(text):
+    """'60-90,200-215' -> [(60000, 90000), (200000, 215000)] in ms"""
+    intervals = []
+    for item in filter(None, text.split(',')):
+        start, end = item.split('-')
+        intervals.append((int(float(start) * 1000), int(float(end) * 1000)))
+    return sorted(intervals)
+
+
+class Stats:
+    def __init__(self, presence, duration_ms):
+        self.presence = presence
+        self.duration_ms = duration_ms
+        self.nn_ms = 0.0
+        self.quiet_nn_ms = 0.0
+        self.inferences = 0
+        self.idle_ms = 0.0
+        self.detect = [None] * len(presence)
+        self.switch = [None] * len(presence)
+        self.idle_entry = [None] * len(presence)
+
+    def quiet_ms(self):
+        return self.duration_ms - sum(min(end, self.duration_ms) - start for start, end in self.presence)
+
+
+def is_present(presence, t):
+    return any(start <= t < end for start, end in presence)
+
+
+def simulate(lib, policy, args):
+    frame_ms = 1000.0 / args.fps
+    presence = parse_presence(args.presence)
+    cfg = GovConf(cpu_budget=args.cpu_budget, pp_latency_ms=args.pp_latency_ms, nn_period_min_ms=int(frame_ms),
+                  nn_period_max_ms=args.nn_period_max_ms, conf_min=0.5, conf_max=0.85, conf_step=0.05,
+                  max_boxes_min=1, max_boxes_max=10, disp_divider_max=4, idle_delay_ms=args.idle_delay_ms,
+                  idle_nn_period_ms=args.idle_period_ms)
+    ctx, priv = new_ctx(lib, policy, cfg)
+
+    stats = Stats(presence, args.duration * 1000)
+    busy = []            # (start, end) of nn and pp cpu usage
+    results = []         # (visible_ts, nb_detect, inf_ms)
+    published = {'nb_detect': 0, 'inf_ms': 0}
+    gov_ts = args.gov_period_ms
+    was_idle = 0
+    idle_since = None
+    sp = ctx.sp
+    start = 0.0
+
+    def align(t):
+        return math.ceil(t / frame_ms) * frame_ms
+
+    def gov_tick(ts):
+        nonlocal was_idle, idle_since
+        while results and results[0][0] <= ts:
+            _, published['nb_detect'], published['inf_ms'] = results.pop(0)
+        load = sum(max(0.0, min(end, ts) - max(begin, ts - args.gov_period_ms)) for begin, end in busy)
+        busy[:] = [b for b in busy if b[1] > ts - args.gov_period_ms]
+        s = GovSample(ts_ms=int(ts), cpu_load=min(100.0, args.base_load + 100.0 * load / args.gov_period_ms),
+                      nn_period_ms=int(sp.nn_period_ms), inf_ms=int(published['inf_ms']), pp_ms=int(args.pp_ms),
+                      disp_ms=0, nb_detect=published['nb_detect'], nb_candidates=published['nb_detect'],
+                      nb_tracks=-1, nb_lost=-1)
+        lib.gov_update(ctypes.byref(ctx), ctypes.byref(s))
+        woken = was_idle and not sp.is_idle
+        if sp.is_idle and not was_idle:
+            idle_since = ts
+            for i, (_, end) in enumerate(presence):
+                nxt = presence[i + 1][0] if i + 1 < len(presence) else stats.duration_ms
+                if stats.idle_entry[i] is None and end <= ts < nxt:
+                    stats.idle_entry[i] = ts - end
+        if not sp.is_idle and was_idle:
+            stats.idle_ms += ts - idle_since
+        was_idle = sp.is_idle
+        return woken
+
+    while start < stats.duration_ms:
+        is_idle = sp.is_idle
+        inf_ms = args.idle_inf_ms if (is_idle and args.idle_inf_ms) else args.inf_ms
+        end_inf = start + inf_ms
+        detected = is_present(presence, start)
+        busy.append((start, end_inf))
+        busy.append((end_inf, end_inf + args.pp_ms))
+        results.append((end_inf + args.pp_ms, 1 if detected else 0, inf_ms))
+        stats.inferences += 1
+        stats.nn_ms += inf_ms + args.pp_ms
+        if not detected:
+            stats.quiet_nn_ms += inf_ms + args.pp_ms
+        for i, (begin, end) in enumerate(presence):
+            if begin <= start < end:
+                if detected and stats.detect[i] is None:
+                    stats.detect[i] = end_inf + args.pp_ms - begin
+                if not is_idle and stats.switch[i] is None:
+                    stats.switch[i] = start - begin
+
+        while gov_ts < end_inf:
+            gov_tick(gov_ts)
+            gov_ts += args.gov_period_ms
+        # nn thread measures its period from loop start, then waits next camera frame
+        nxt = align(max(end_inf, start + sp.nn_period_ms))
+        while gov_ts < nxt:
+            if gov_tick(gov_ts):
+                nxt = align(gov_ts)
+            gov_ts += args.gov_period_ms
+        start = nxt
+
+    if was_idle:
+        stats.idle_ms += stats.duration_ms - idle_since
+    return stats
+
+
+def fmt_latency(values):
+    values = [v for v in values if v is not None]
+    if not values:
+        return '%17s' % '-'
+    return '%8.0f /%7.0f' % (sum(values) / len(values), max(values))
+
+
+def check(lib):
+    """Drive aimd policy with crafted samples. Post process cost is a base cost plus a cost per candidate above
+    threshold, candidates being the raw scores of a synthetic scene.
+    """
+    checker = hostbuild.Checker(60)
+    expect = checker.expect
+
+    cfg = GovConf(cpu_budget=85.0, pp_latency_ms=20, nn_period_min_ms=33, nn_period_max_ms=2000, conf_min=0.6,
+                  conf_max=0.85, conf_step=0.05, max_boxes_min=1, max_boxes_max=10, disp_divider_max=4,
+                  idle_delay_ms=0, idle_nn_period_ms=1000)
+
+    def run(ctx, steps, inf_ms, scores, ms_per_candidate, cpu_load=95.0):
+        for step in range(steps):
+            candidates = sum(1 for v in scores if v >= ctx.sp.conf_threshold)
+            s = GovSample(ts_ms=step * 250, cpu_load=cpu_load, nn_period_ms=ctx.sp.nn_period_ms, inf_ms=inf_ms,
+                          pp_ms=int(2 + ms_per_candidate * candidates), disp_ms=0,
+                          nb_detect=min(candidates, ctx.sp.max_boxes), nb_candidates=candidates, nb_tracks=-1,
+                          nb_lost=-1)
+            lib.gov_update(ctypes.byref(ctx), ctypes.byref(s))
+        return ctx.sp
+
+    def aimd_ctx():
+        return new_ctx(lib, 'aimd', cfg)[0]
+
+    crowd = [0.6 + 0.3 * i / 40 for i in range(40)]
+    quiet = [0.9, 0.92, 0.95]
+
+    # inference slower than any latency target, cheap post process on a crowded scene
+    sp = run(aimd_ctx(), 200, 1500, crowd, 0.1)
+    expect('slow inference leaves post process settings alone', sp.max_boxes == 10 and sp.conf_threshold < 0.61)
+    expect('slow inference raises nn period', sp.nn_period_ms >= 1500)
+
+    # expensive post process on a crowded scene
+    ctx = aimd_ctx()
+    sp = run(ctx, 40, 1500, crowd, 1.0)
+    candidates = sum(1 for v in crowd if v >= sp.conf_threshold)
+    expect('busy post process tightens threshold', sp.conf_threshold > 0.61)
+    expect('busy post process gets below target', 2 + candidates <= 20)
+
+    # same context, scene empties while inference stays slow and output stays capped
+    sp = run(ctx, 40, 1500, quiet, 1.0)
+    expect('quiet scene restores threshold', sp.conf_threshold < 0.61)
+    expect('quiet scene restores max boxes', sp.max_boxes == 10)
+
+    # more candidates than max boxes but post process within target
+    sp = run(aimd_ctx(), 40, 30, crowd[:25], 0.5, cpu_load=50.0)
+    expect('capped output alone does not tighten', sp.max_boxes == 10 and sp.conf_threshold < 0.61)
+
+    # log printed by firmware running presence on a busy then empty scene, replayed through its csv lines
+    log_cfg = GovConf.from_buffer_copy(cfg)
+    log_cfg.idle_delay_ms = 2000
+    ctx, priv = new_ctx(lib, 'presence', log_cfg)
+    records = []
+    for step in range(120):
+        candidates = 30 if step < 60 else 0
+        s = GovSample(ts_ms=step * 250, cpu_load=95.0 - step * 0.37, nn_period_ms=ctx.sp.nn_period_ms,
+                      inf_ms=400, pp_ms=2 + candidates, disp_ms=5, nb_detect=min(candidates, ctx.sp.max_boxes),
+                      nb_candidates=candidates, nb_tracks=-1, nb_lost=-1)
+        lib.gov_update(ctypes.byref(ctx), ctypes.byref(s))
+        records.append((s, GovSetpoint(*[getattr(ctx.sp, f) for f in SETPOINT_FIELDS])))
+    lines = ['boot', 'gov: idle mode', 'tlm,0,nn,3,500,100,10'] + format_log(log_cfg, records)
+    parsed_cfg, samples = parse_log(lines)
+    expect('log keeps configuration and every sample', len(samples) == len(records) and
+           all(abs(getattr(parsed_cfg, f) - getattr(log_cfg, f)) < 1e-3 for f in CONF_FIELDS))
+    out = replay(lib, 'presence', parsed_cfg, samples)
+    expect('presence replay of its own log matches every setpoint',
+           all(is_same_setpoint(a, b) for a, (_, b) in zip(out, samples)))
+    expect('replayed log goes idle once scene is empty', out[59][-1] == 0 and out[-1][-1] == 1)
+
+    return checker.ok()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run post process knob checks instead of simulation')
+    parser.add_argument('--replay', metavar='LOG', help='replay gov,... csv lines of a firmware console log')
+    parser.add_argument('--policy', action='append', choices=['fixed', 'aimd', 'presence'],
+                        help='policy to simulate, may be repeated (default: aimd and presence, all with --replay)')
+    parser.add_argument('--duration', type=int, default=600, help='simulated time in seconds (default: 600)')
+    parser.add_argument('--presence', default='60.4-90,240.7-250,400.2-460',
+                        help='comma separated start-end seconds where someone is in the scene')
+    parser.add_argument('--inf-ms', type=float, default=400, help='inference time (default: 400)')
+    parser.add_argument('--idle-inf-ms', type=float, default=0,
+                        help='inference time in idle mode, 0 for same model (default: 0)')
+    parser.add_argument('--pp-ms', type=float, default=10, help='post process time (default: 10)')
+    parser.add_argument('--fps', type=float, default=30, help='camera frame rate (default: 30)')
+    parser.add_argument('--base-load', type=float, default=15, help='cpu load of other threads in %% (default: 15)')
+    parser.add_argument('--cpu-budget', type=float, default=85.0, help='GOVERNOR_CPU_BUDGET (default: 85)')
+    parser.add_argument('--pp-latency-ms', type=int, default=20, help='GOVERNOR_PP_LATENCY_MS (default: 20)')
+    parser.add_argument('--nn-period-max-ms', type=int, default=2000, help='GOVERNOR_NN_PERIOD_MAX_MS (default: 2000)')
+    parser.add_argument('--gov-period-ms', type=int, default=250, help='GOVERNOR_PERIOD_MS (default: 250)')
+    parser.add_argument('--idle-delay-ms', type=int, default=10000,
+                        help='GOVERNOR_IDLE_DELAY_MS, 0 in firmware by default (default: 10000)')
+    parser.add_argument('--idle-period-ms', type=int, default=1000,
+                        help='GOVERNOR_IDLE_NN_PERIOD_MS (default: 1000)')
+    hostbuild.add_arguments(parser, seed=False)
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build.lib('governor', ['Src/governor.c'], includes=['Inc'])
+        if args.check:
+            sys.exit(0 if check(lib) else 1)
+
+        out = sys.stdout
+        if args.replay:
+            with open(args.replay, 'r', errors='replace') as f:
+                cfg, samples = parse_log(f)
+            if not samples:
+                sys.exit('no gov samples in %s' % args.replay)
+            out.write('%-9s %17s %11s %13s %6s %6s\n' % ('policy', 'nn period avg/max', 'conf avg/max',
+                                                        'boxes avg/min', 'idle', 'match'))
+            for policy in args.policy or ['fixed', 'aimd', 'presence']:
+                sps = replay(lib, policy, cfg, samples)
+                nb = len(sps)
+                out.write('%-9s %8.0f /%7d %5.2f /%4.2f %7.1f /%4d %5.1f%% %5.1f%%\n' % (
+                    policy, sum(sp[0] for sp in sps) / nb, max(sp[0] for sp in sps), sum(sp[1] for sp in sps) / nb,
+                    max(sp[1] for sp in sps), sum(sp[2] for sp in sps) / nb, min(sp[2] for sp in sps),
+                    100.0 * sum(sp[4] for sp in sps) / nb,
+                    100.0 * sum(is_same_setpoint(a, b) for a, (_, b) in zip(sps, samples)) / nb))
+            out.write('%d samples, nn period in ms\n' % nb)
+            return
+
+        out.write('%-9s %7s %9s %6s %8s %17s %17s %17s\n' % ('policy', 'nn cpu', 'quiet cpu', 'idle', 'inf/s',
+                                                            'detect avg/max', 'switch avg/max', 'idle entry avg/max'))
+        for policy in args.policy or ['aimd', 'presence']:
+            st = simulate(lib, policy, args)
+            quiet_ms = st.quiet_ms()
+            out.write('%-9s %6.1f%% %8.1f%% %5.1f%% %8.2f %s %s %s\n' % (
+                policy, 100.0 * st.nn_ms / st.duration_ms, 100.0 * st.quiet_nn_ms / quiet_ms if quiet_ms else 0,
+                100.0 * st.idle_ms / st.duration_ms, 1000.0 * st.inferences / st.duration_ms,
+                fmt_latency(st.detect), fmt_latency(st.switch), fmt_latency(st.idle_entry)))
+        out.write('latencies in ms\n')
+
+
+if __name__ == '__main__':
+    main()
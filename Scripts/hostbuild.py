@@ -0,0 +1,90 @@
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Build firmware sources with the host C compiler and load them through ctypes.
+
+Shared by the host checks of Scripts/. Modules under test have no rtos or hal dependency, so they are compiled
+unchanged into a shared library, with an optional reference implementation given as C source text. Each script only
+keeps its ctypes declarations, checks and measures:
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build.lib('governor', ['Src/governor.c'], includes=['Inc'])
+        if args.check:
+            sys.exit(0 if check(lib) else 1)
+"""
+
+import ctypes
+import os
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+
+def add_arguments(parser, seed=True, cflags=None):
+    """Add --seed, --cc and, when cflags gives its default, --cflags"""
+    if seed:
+        parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--cc', default=os.environ.get('CC', 'cc'), help='host C compiler (default: $CC or cc)')
+    if cflags is not None:
+        parser.add_argument('--cflags', default=cflags, help='host compiler flags (default: %s)' % cflags)
+
+
+class HostBuild:
+    """Temporary directory holding the shared libraries built for one run"""
+
+    def __init__(self, cc, cflags='-O2'):
+        self.cc = cc
+        self.cflags = cflags.split()
+        self.tmp = None
+
+    def __enter__(self):
+        self.tmp = tempfile.TemporaryDirectory()
+        return self
+
+    def __exit__(self, *exc):
+        self.tmp.cleanup()
+
+    def lib(self, name, sources, includes=(), defines=(), code=None, libs=(), missing=None):
+        """Build sources, relative to repository root, and code, C source text, into lib<name>.so and load it.
+        Exit with missing as message when build fails, else build errors are raised.
+        """
+        out = os.path.join(self.tmp.name, 'lib%s.so' % name)
+        cmd = [self.cc, '-shared', '-fPIC'] + self.cflags + ['-D%s' % d for d in defines]
+        for inc in includes:
+            cmd += ['-I', os.path.join(ROOT, inc)]
+        cmd += [os.path.join(ROOT, src) for src in sources]
+        if code is not None:
+            ref = os.path.join(self.tmp.name, '%s_ref.c' % name)
+            with open(ref, 'w') as f:
+                f.write(code)
+            cmd.append(ref)
+        cmd += ['-o', out] + ['-l%s' % lib for lib in libs]
+        if missing is not None:
+            if subprocess.run(cmd).returncode:
+                sys.exit(missing)
+        else:
+            subprocess.run(cmd, check=True)
+        return ctypes.CDLL(out)
+
+
+class Checker:
+    """Print one line per expectation and remember failures"""
+
+    def __init__(self, width=52):
+        self.fmt = '%%-%ds %%s' % width
+        self.failed = []
+
+    def expect(self, name, cond):
+        print(self.fmt % (name, 'ok' if cond else 'FAILED'))
+        if not cond:
+            self.failed.append(name)
+
+    def ok(self):
+        return not self.failed
@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Check and benchmark the baseline jpeg encoder of Lib/screenl/Src/scrl_jpeg.c.
+
+Lib/screenl/Src/scrl_jpeg.c is compiled twice with the host C compiler, once with its vector dct and once with its
+scalar dct, and driven through ctypes. Encoded frames are decoded back by libjpeg, so libjpeg development files are
+required (libjpeg-dev or libjpeg-turbo-devel). The decoder keeps YCbCr output and replicates chroma, so planes are
+compared with the YUY2 source without color conversion.
+
+The encoder uses the same tables, quality scaling and dct as libjpeg, so --check expects its frames to decode exactly
+as frames encoded by libjpeg itself from the same source. It also checks that a too small output buffer gives -1
+without writing past its end, and that vector and scalar paths give the same bytes.
+
+The source is a synthetic scene: gradients, flat boxes with sharp edges, fine stripes and some noise.
+
+Columns:
+    size        encoded frame size
+    Y / Cb / Cr psnr in dB of decoded planes against source
+    ms/frame    host time of one SCRJ_EncodeYuv422() call, or of libjpeg encode with YUY2 unpacking
+
+Examples:
+    jpeg_bench.py
+    jpeg_bench.py --check                        # decode, psnr and truncation checks, non zero exit on failure
+    jpeg_bench.py --width 320 --height 240 --quality 50,75,90
+"""
+
+import argparse
+import ctypes
+import math
+import random
+import sys
+import time
+
+import hostbuild
+
+# Keep in sync with Lib/screenl/Src/scrl_jpeg.h
+SCRJ_MCU_MAX_SIZE = 1728
+
+# libjpeg reference encoder from YUY2 and decoder into interleaved YCbCr without fancy upsampling
+REF_SRC = r'''
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jpeglib.h>
+
+struct ref_error {
+  struct jpeg_error_mgr pub;
+  jmp_buf jmp;
+};
+
+static void ref_error_exit(j_common_ptr cinfo)
+{
+  longjmp(((struct ref_error *) cinfo->err)->jmp, 1);
+}
+
+static void ref_output_message(j_common_ptr cinfo)
+{
+}
+
+/* 4:2:2 baseline with default tables and accurate integer dct. return encoded size or -1 */
+int REF_Encode(uint8_t *dst, int dst_size, const uint8_t *src, int width, int height, int stride, int quality)
+{
+  struct jpeg_compress_struct cinfo;
+  unsigned long out_size = 0;
+  unsigned char *out = NULL;
+  struct ref_error err;
+  JSAMPROW row;
+  int ret = -1;
+  int x;
+
+  row = malloc(width * 3);
+  cinfo.err = jpeg_std_error(&err.pub);
+  err.pub.error_exit = ref_error_exit;
+  err.pub.output_message = ref_output_message;
+  if (setjmp(err.jmp)) {
+    jpeg_destroy_compress(&cinfo);
+    free(row);
+    free(out);
+    return -1;
+  }
+  jpeg_create_compress(&cinfo);
+  jpeg_mem_dest(&cinfo, &out, &out_size);
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_YCbCr;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+  cinfo.dct_method = JDCT_ISLOW;
+  cinfo.comp_info[0].h_samp_factor = 2;
+  cinfo.comp_info[0].v_samp_factor = 1;
+  jpeg_start_compress(&cinfo, TRUE);
+  while (cinfo.next_scanline < cinfo.image_height) {
+    const uint8_t *s = src + cinfo.next_scanline * stride;
+
+    /* chroma is replicated, so libjpeg downsampling gives it back as is */
+    for (x = 0; x < width; x++) {
+      row[3 * x + 0] = s[2 * x];
+      row[3 * x + 1] = s[(x & ~1) * 2 + 1];
+      row[3 * x + 2] = s[(x & ~1) * 2 + 3];
+    }
+    jpeg_write_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  if ((int) out_size <= dst_size) {
+    memcpy(dst, out, out_size);
+    ret = out_size;
+  }
+  jpeg_destroy_compress(&cinfo);
+  free(row);
+  free(out);
+
+  return ret;
+}
+
+/* return 0 on success, decoded size in *width and *height. dst holds dst_size bytes */
+int REF_Decode(const uint8_t *src, int src_size, uint8_t *dst, int dst_size, int *width, int *height)
+{
+  struct jpeg_decompress_struct cinfo;
+  struct ref_error err;
+  JSAMPROW row;
+
+  cinfo.err = jpeg_std_error(&err.pub);
+  err.pub.error_exit = ref_error_exit;
+  err.pub.output_message = ref_output_message;
+  if (setjmp(err.jmp)) {
+    jpeg_destroy_decompress(&cinfo);
+    return -1;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, (unsigned char *) src, src_size);
+  jpeg_read_header(&cinfo, TRUE);
+  cinfo.out_color_space = JCS_YCbCr;
+  cinfo.do_fancy_upsampling = FALSE;
+  jpeg_start_decompress(&cinfo);
+  *width = cinfo.output_width;
+  *height = cinfo.output_height;
+  if ((int) (cinfo.output_width * cinfo.output_height * 3) > dst_size) {
+    jpeg_destroy_decompress(&cinfo);
+    return -1;
+  }
+  while (cinfo.output_scanline < cinfo.output_height) {
+    row = dst + cinfo.output_scanline * cinfo.output_width * 3;
+    jpeg_read_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+
+  return 0;
+}
+'''
+
+P, I = ctypes.c_void_p, ctypes.c_int
+PATHS = ('vector', 'scalar')
+
+
+def build_jpeg(build):
+    """Return {path name: encoder lib} and decoder lib"""
+    libs = {}
+    for path in PATHS:
+        lib = build.lib('scrj_%s' % path, ['Lib/screenl/Src/scrl_jpeg.c'],
+                        defines=['SCRJ_USE_VECTOR=%d' % (path == 'vector')])
+        lib.SCRJ_EncodeYuv422.argtypes = [P, I, P, I, I, I]
+        libs[path] = lib
+
+    ref = build.lib('jpeg', [], code=REF_SRC, libs=['jpeg'],
+                    missing='cannot build libjpeg reference decoder, install libjpeg development files')
+    ref.REF_Decode.argtypes = [P, I, P, I, ctypes.POINTER(I), ctypes.POINTER(I)]
+    ref.REF_Encode.argtypes = [P, I, P, I, I, I, I]
+    return libs, ref
+
+
+def make_scene(width, height, stride, rnd):
+    """Return YUY2 bytes of a synthetic scene"""
+    boxes = []
+    for _ in range(12):
+        w, h = rnd.randint(1, max(1, width // 3)), rnd.randint(1, max(1, height // 3))
+        x, y = rnd.randint(0, width - w), rnd.randint(0, height - h)
+        boxes.append((x, y, x + w, y + h, rnd.randint(16, 235), rnd.randint(16, 240), rnd.randint(16, 240)))
+    img = bytearray(stride * height)
+    for y in range(height):
+        row = y * stride
+        for x in range(0, width, 2):
+            luma = [16 + 200 * (x + i) // width for i in (0, 1)]
+            cb, cr = 128 + 60 * y // height - 30, 128 - 60 * x // width + 30
+            for x0, y0, x1, y1, by, bcb, bcr in boxes:
+                if x0 <= x < x1 and y0 <= y < y1:
+                    luma = [by, by]
+                    cb, cr = bcb, bcr
+            # fine stripes in a band
+            if height // 2 <= y < height // 2 + 16:
+                luma = [40 if (x // 2 + y) & 1 else 220] * 2
+            luma = [max(0, min(255, v + rnd.randint(-4, 4))) for v in luma]
+            img[row + 2 * x:row + 2 * x + 4] = bytes((luma[0], cb, luma[1], cr))
+    return bytes(img)
+
+
+def encode(lib, src, width, height, stride, dst_size, guard=16):
+    """Return (encoded bytes or None, True when bytes past dst_size are untouched)"""
+    dst = ctypes.create_string_buffer(b'\x5a' * (dst_size + guard), dst_size + guard)
+    size = lib.SCRJ_EncodeYuv422(dst, dst_size, src, width, height, stride)
+    intact = dst.raw[dst_size:] == b'\x5a' * guard
+    return (dst.raw[:size] if size >= 0 else None), intact
+
+
+def decode(ref, jpg, width, height):
+    out = ctypes.create_string_buffer(width * height * 3)
+    w, h = I(), I()
+    if ref.REF_Decode(jpg, len(jpg), out, len(out), ctypes.byref(w), ctypes.byref(h)) or (w.value, h.value) != (
+            width, height):
+        return None
+    return out.raw
+
+
+def psnr(src, ycc, width, height, stride):
+    """psnr of Y, Cb, Cr. Each source chroma sample covers a pixel pair"""
+    err = [0, 0, 0]
+    for y in range(height):
+        s = y * stride
+        d = y * width * 3
+        for x in range(width):
+            pair = s + (x & ~1) * 2
+            ref = (src[s + 2 * x], src[pair + 1], src[pair + 3])
+            for c in range(3):
+                diff = ycc[d + 3 * x + c] - ref[c]
+                err[c] += diff * diff
+    nb = width * height
+    return [99.0 if e == 0 else 10 * math.log10(255 * 255 * nb / e) for e in err]
+
+
+def ref_encode(ref, src, width, height, stride, quality):
+    dst = ctypes.create_string_buffer(width * height * 4 + (1 << 12))
+    size = ref.REF_Encode(dst, len(dst), src, width, height, stride, quality)
+    return dst.raw[:size] if size >= 0 else None
+
+
+def check(libs, ref, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    # full MCUs, partial MCUs on right and bottom edges, stride larger than a row
+    sizes = [(64, 32, 128), (70, 30, 140), (18, 10, 40), (2, 1, 4)]
+    scenes = {s: make_scene(*s, rnd) for s in sizes}
+    outputs = {}
+    for path, lib in libs.items():
+        for quality in (1, 10, 50, 75, 95, 100):
+            lib.SCRJ_Init(quality)
+            ok = True
+            for (width, height, stride), src in scenes.items():
+                jpg, intact = encode(lib, src, width, height, stride, 1 << 16)
+                ycc = decode(ref, jpg, width, height) if jpg else None
+                # same tables, quantization and dct as libjpeg, so decoded planes are the same
+                ok &= intact and ycc is not None and ycc == decode(ref, ref_encode(ref, src, width, height, stride,
+                                                                                   quality), width, height)
+                if ycc and (width, height) == sizes[0][:2]:
+                    print('  %s quality %d psnr Y %.1f Cb %.1f Cr %.1f dB' % (path, quality,
+                                                                          *psnr(src, ycc, width, height, stride)))
+                outputs.setdefault((quality, width, height), []).append(jpg)
+            expect('%s quality %d decodes as libjpeg encode' % (path, quality), ok)
+
+        # truncation
+        lib.SCRJ_Init(75)
+        width, height, stride = sizes[0]
+        src = scenes[sizes[0]]
+        full, _ = encode(lib, src, width, height, stride, 1 << 16)
+        ok = True
+        for dst_size in (0, 100, SCRJ_MCU_MAX_SIZE - 1, SCRJ_MCU_MAX_SIZE, len(full) // 2, len(full),
+                         len(full) + SCRJ_MCU_MAX_SIZE - 1):
+            jpg, intact = encode(lib, src, width, height, stride, dst_size)
+            # output is either complete or refused, and never written past dst_size
+            ok &= intact and (jpg is None or jpg == full)
+        expect('%s short output buffer gives -1 and no overflow' % path,
+               ok and encode(lib, src, width, height, stride, len(full) // 2)[0] is None)
+        expect('%s output with SCRJ_MCU_MAX_SIZE margin succeeds' % path,
+               encode(lib, src, width, height, stride, len(full) + SCRJ_MCU_MAX_SIZE)[0] == full)
+        expect('%s odd width gives -1' % path, encode(lib, src, width - 1, height, stride, 1 << 16)[0] is None)
+
+    expect('vector and scalar outputs are identical', all(a == b for a, b in outputs.values()))
+
+    return checker.ok()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run checks instead of benchmark')
+    parser.add_argument('--width', type=int, default=640, help='frame width, even (default: 640)')
+    parser.add_argument('--height', type=int, default=480, help='frame height (default: 480)')
+    parser.add_argument('--quality', default='50,75,90', help='comma separated qualities (default: 50,75,90)')
+    parser.add_argument('--loops', type=int, default=20, help='frames timed per point (default: 20)')
+    hostbuild.add_arguments(parser, cflags='-O2')
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc, args.cflags) as build:
+        libs, ref = build_jpeg(build)
+        if args.check:
+            sys.exit(0 if check(libs, ref, args.seed) else 1)
+
+        width, height = args.width, args.height
+        stride = width * 2
+        src = make_scene(width, height, stride, random.Random(args.seed))
+        dst_size = width * height * 2 + SCRJ_MCU_MAX_SIZE
+        dst = ctypes.create_string_buffer(dst_size)
+        out = sys.stdout
+        out.write('%dx%d frame\n' % (width, height))
+        out.write('%-7s %7s %8s %6s %6s %6s %9s\n' % ('path', 'quality', 'size', 'Y', 'Cb', 'Cr', 'ms/frame'))
+        for quality in [int(v) for v in args.quality.split(',')]:
+            for path, lib in libs.items():
+                lib.SCRJ_Init(quality)
+                jpg, _ = encode(lib, src, width, height, stride, dst_size)
+                start = time.perf_counter()
+                for _ in range(args.loops):
+                    lib.SCRJ_EncodeYuv422(dst, dst_size, src, width, height, stride)
+                encode_s = (time.perf_counter() - start) / args.loops
+                ycc = decode(ref, jpg, width, height)
+                y, cb, cr = psnr(src, ycc, width, height, stride) if ycc else (0, 0, 0)
+                out.write('%-7s %7d %8d %6.1f %6.1f %6.1f %9.3f\n' % (path, quality, len(jpg), y, cb, cr,
+                                                                      encode_s * 1e3))
+            start = time.perf_counter()
+            for _ in range(args.loops):
+                ref.REF_Encode(dst, dst_size, src, width, height, stride, quality)
+            encode_s = (time.perf_counter() - start) / args.loops
+            jpg = ref_encode(ref, src, width, height, stride, quality)
+            y, cb, cr = psnr(src, decode(ref, jpg, width, height), width, height, stride)
+            out.write('%-7s %7d %8d %6.1f %6.1f %6.1f %9.3f\n' % ('libjpeg', quality, len(jpg), y, cb, cr,
+                                                                  encode_s * 1e3))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Report size and placement of large static buffers of the application.
+
+Symbols are read from the elf with readelf and mapped to memory regions described in the linker map file. Every
+buffer above --min-size is checked against the memory plan, so a new large buffer or a buffer that grows is visible.
+
+The plan is read from the sources. Each large buffer declaration is preceded by a comment giving its lifetime and
+role:
+
+    /* mem_plan(run, trace builds): event trace ring */
+    static trc_record_t trc_ring[TRACE_RING_SIZE];
+
+All planned buffers are live while the pipeline runs, so none of them can share storage. Buffers that only exist in
+some builds are reported as absent in the others.
+
+'make mem_report' prints the whole report. 'make' runs --check, which only prints problems and fails when a large
+buffer has no annotation, or when a region grows over MEM_BASELINE report.
+
+Example:
+    mem_report.py build/Project.elf build/Project.map --save mem.json
+    mem_report.py build/Project.elf build/Project.map --baseline mem.json --threshold 4096
+    mem_report.py --plan                # print plan read from sources, no build needed
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+PLAN_SOURCES = ['Src/*.c']
+PLAN_RE = re.compile(r'/\*\s*mem_plan\((?P<lifetime>[^)]*)\):\s*(?P<role>.*?)\s*\*/')
+# annotated buffer is the first array declared on the lines following annotation, attributes and comments skipped
+DECL_RE = re.compile(r'\b(?P<name>[A-Za-z_]\w*)\s*\[')
+DECL_SKIP = ('/*', '*', '__attribute__')
+
+
+def parse_plan(patterns):
+    """Return {buffer name: (lifetime, role, 'file:line')} from mem_plan annotations of sources matching patterns"""
+    plan = {}
+    for path in sorted(p for pattern in patterns for p in glob.glob(os.path.join(ROOT, pattern))):
+        with open(path, errors='replace') as f:
+            lines = f.readlines()
+        where = os.path.relpath(path, ROOT)
+        for idx, line in enumerate(lines):
+            m = PLAN_RE.search(line)
+            if not m:
+                continue
+            decl = None
+            for next_line in lines[idx + 1:]:
+                if not next_line.lstrip().startswith(DECL_SKIP):
+                    decl = DECL_RE.search(next_line)
+                    break
+            if not decl:
+                sys.exit('%s:%d: mem_plan annotation is not followed by an array declaration' % (where, idx + 1))
+            plan[decl.group('name')] = (m.group('lifetime'), m.group('role'), '%s:%d' % (where, idx + 1))
+    return plan
+
+
+def parse_regions(map_path):
+    """Return [(name, origin, length)] from 'Memory Configuration' section of a gnu ld map file"""
+    regions = []
+    in_config = False
+    with open(map_path, 'r', errors='replace') as f:
+        for line in f:
+            if line.startswith('Memory Configuration'):
+                in_config = True
+                continue
+            if not in_config:
+                continue
+            if line.startswith('Linker script and memory map'):
+                break
+            items = line.split()
+            if len(items) >= 3 and items[1].startswith('0x') and items[0] != '*default*':
+                regions.append((items[0], int(items[1], 16), int(items[2], 16)))
+    return regions
+
+
+def parse_symbols(elf_path, readelf):
+    """Return {name: (address, size)} of data objects"""
+    out = subprocess.run([readelf, '-sW', elf_path], check=True, stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        items = line.split()
+        # Num: Value Size Type Bind Vis Ndx Name
+        if len(items) < 8 or items[3] != 'OBJECT' or not items[6].isdigit():
+            continue
+        size = int(items[2], 16) if items[2].startswith('0x') else int(items[2])
+        name = items[7]
+        # static symbols of the same name in different files are told apart by their address
+        if name in symbols and symbols[name][0] != int(items[1], 16):
+            name = '%s@%s' % (name, items[1])
+        symbols[name] = (int(items[1], 16), size)
+    return symbols
+
+
+def region_of(addr, regions):
+    for name, origin, length in regions:
+        if origin <= addr < origin + length:
+            return name
+    return 'other'
+
+
+def build_report(symbols, regions, min_size, plan):
+    report = {'regions': {}, 'buffers': {}}
+    for name, origin, length in regions:
+        report['regions'][name] = {'size': length, 'used': 0}
+    report['regions']['other'] = {'size': 0, 'used': 0}
+    for name, (addr, size) in symbols.items():
+        region = region_of(addr, regions)
+        report['regions'][region]['used'] += size
+        if size >= min_size or plan_name(name) in plan:
+            report['buffers'][name] = {'region': region, 'size': size}
+    if not report['regions']['other']['used']:
+        del report['regions']['other']
+    return report
+
+
+def plan_name(name):
+    # function local statics get a numbered suffix
+    return re.sub(r'\.\d+$', '', name)
+
+
+def print_report(report, baseline, plan):
+    def delta(cur, prev):
+        return '%+d' % (cur - prev) if cur != prev else ''
+
+    print('%-16s %10s %10s %6s %10s' % ('region', 'static', 'size', 'use', 'delta'))
+    for name, r in sorted(report['regions'].items()):
+        use = '%5.1f%%' % (100.0 * r['used'] / r['size']) if r['size'] else ''
+        prev = '' if baseline is None else delta(r['used'], baseline['regions'].get(name, {}).get('used', 0))
+        print('%-16s %10d %10d %6s %10s' % (name, r['used'], r['size'], use, prev))
+    print()
+    print('%-24s %-16s %10s %10s  %s' % ('buffer', 'region', 'size', 'delta', 'lifetime'))
+    for name, b in sorted(report['buffers'].items(), key=lambda kv: (kv[1]['region'], -kv[1]['size'])):
+        lifetime = plan.get(plan_name(name), ('NOT IN PLAN',))[0]
+        prev = ''
+        if baseline is not None:
+            prev = baseline['buffers'].get(name)
+            prev = 'new' if prev is None else delta(b['size'], prev['size'])
+        print('%-24s %-16s %10d %10s  %s' % (name, b['region'], b['size'], prev, lifetime))
+    if baseline is not None:
+        for name in sorted(set(baseline['buffers']) - set(report['buffers'])):
+            print('%-24s %-16s %10s %10s' % (name, baseline['buffers'][name]['region'], '', 'removed'))
+
+
+def print_plan(plan):
+    print('%-24s %-28s %-22s  %s' % ('buffer', 'lifetime', 'declared', 'role'))
+    for name, (lifetime, role, where) in sorted(plan.items()):
+        print('%-24s %-28s %-22s  %s' % (name, lifetime, where, role))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf', nargs='?', help='application elf file')
+    parser.add_argument('map', nargs='?', help='linker map file')
+    parser.add_argument('--readelf', default='arm-none-eabi-readelf', help='readelf to use')
+    parser.add_argument('--min-size', type=int, default=16 * 1024, help='report buffers from this size (default: 16K)')
+    parser.add_argument('--save', help='save report as json to use it later as baseline')
+    parser.add_argument('--baseline', help='json report to compare with')
+    parser.add_argument('--threshold', type=int, default=0,
+                        help='fail when a region grows more than this number of bytes over baseline (default: 0)')
+    parser.add_argument('--strict', action='store_true', help='fail when a large buffer is not in memory plan')
+    parser.add_argument('--check', action='store_true', help='same as --strict, only printing problems')
+    parser.add_argument('--plan', action='store_true', help='print memory plan read from sources and exit')
+    args = parser.parse_args()
+
+    plan = parse_plan(PLAN_SOURCES)
+    if args.plan:
+        print_plan(plan)
+        return
+    if not args.elf or not args.map:
+        parser.error('elf and map files are required')
+
+    regions = parse_regions(args.map)
+    if not regions:
+        sys.exit('no memory configuration found in %s' % args.map)
+    report = build_report(parse_symbols(args.elf, args.readelf), regions, args.min_size, plan)
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    if not args.check:
+        print_report(report, baseline, plan)
+
+    status = 0
+    unplanned = [n for n in report['buffers'] if plan_name(n) not in plan]
+    if unplanned:
+        is_error = args.strict or args.check
+        print('%s%s: buffers without mem_plan annotation: %s' % ('' if args.check else '\n',
+                                                                 'error' if is_error else 'warning',
+                                                                 ', '.join(sorted(unplanned))))
+        if is_error:
+            status = 1
+    if baseline is not None:
+        for name, r in report['regions'].items():
+            grow = r['used'] - baseline['regions'].get(name, {}).get('used', 0)
+            if grow > args.threshold:
+                print('error: %s static usage grew by %d bytes' % (name, grow))
+                status = 1
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump(report, f, indent=1, sort_keys=True)
+
+    sys.exit(status)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Decode binary metadata records sent by the application on console uart.
+
+Build with USE_METADATA defined and capture raw console output, or read it live from serial port (needs pyserial).
+Console text lines between records are skipped. Each record is printed as one json object per line, or as csv with
+one line per box.
+
+Can also be imported: feed raw bytes to Decoder.feed() and get decoded records back as dicts.
+
+Example:
+    metadata_decode.py console.bin
+    metadata_decode.py --serial /dev/ttyACM0 --format csv
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+# Keep in sync with Inc/app_metadata.h
+SYNC = b'\xa5\x5a'
+VERSION = 1
+TYPE_FRAME = 1
+FLAG_TRACKS = 1 << 0
+FLAG_TRUNCATED = 1 << 1
+COORD_FRAC_BITS = 14
+
+HEADER = struct.Struct('<2sBBH')
+FRAME = struct.Struct('<IIIIIBB')
+BOX = struct.Struct('<IhhhhBB')
+CRC = struct.Struct('<H')
+# a corrupted length can't make us wait for more than a record can hold
+PAYLOAD_MAX = FRAME.size + 255 * BOX.size
+
+
+def crc16(data):
+    crc = 0xffff
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xffff if crc & 0x8000 else (crc << 1) & 0xffff
+    return crc
+
+
+def parse_payload(payload):
+    frame_id, ts_ms, inf_us, pp_us, trk_us, flags, box_nb = FRAME.unpack_from(payload)
+    if len(payload) != FRAME.size + box_nb * BOX.size:
+        raise ValueError('payload length does not match box count')
+    scale = float(1 << COORD_FRAC_BITS)
+    boxes = []
+    for i in range(box_nb):
+        box_id, cx, cy, w, h, conf, class_index = BOX.unpack_from(payload, FRAME.size + i * BOX.size)
+        box = {'cx': cx / scale, 'cy': cy / scale, 'w': w / scale, 'h': h / scale}
+        if flags & FLAG_TRACKS:
+            box['id'] = box_id
+        else:
+            box['conf'] = conf / 255.0
+            box['class'] = class_index
+        boxes.append(box)
+    return {
+        'frame': frame_id,
+        'ts_ms': ts_ms,
+        'inference_us': inf_us,
+        'pp_us': pp_us,
+        'tracking_us': trk_us,
+        'kind': 'tracks' if flags & FLAG_TRACKS else 'detections',
+        'truncated': bool(flags & FLAG_TRUNCATED),
+        'boxes': boxes,
+    }
+
+
+class Decoder:
+    """Incremental decoder. Resynchronizes on next sync pattern whenever a record is corrupted."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.crc_errors = 0
+        self.skipped = 0
+        self.lost = 0
+        self.last_frame = None
+
+    def _record(self):
+        """Return (record or None, bytes consumed), or None when more data is needed"""
+        _, version, rec_type, length = HEADER.unpack_from(self.buf)
+        if version != VERSION or length > PAYLOAD_MAX:
+            return None, 1
+        end = HEADER.size + length + CRC.size
+        if len(self.buf) < end:
+            return None
+        crc, = CRC.unpack_from(self.buf, HEADER.size + length)
+        if crc != crc16(self.buf[2:HEADER.size + length]):
+            self.crc_errors += 1
+            return None, 1
+        if rec_type != TYPE_FRAME:
+            return None, end
+        try:
+            return parse_payload(bytes(self.buf[HEADER.size:HEADER.size + length])), end
+        except (ValueError, struct.error):
+            return None, end
+
+    def feed(self, data):
+        """Append raw bytes and return list of records decoded so far"""
+        records = []
+        self.buf += data
+        while True:
+            idx = self.buf.find(SYNC)
+            if idx < 0:
+                # keep a possible first sync byte
+                keep = 1 if self.buf[-1:] == SYNC[:1] else 0
+                self.skipped += len(self.buf) - keep
+                del self.buf[:len(self.buf) - keep]
+                break
+            self.skipped += idx
+            del self.buf[:idx]
+            if len(self.buf) < HEADER.size:
+                break
+            res = self._record()
+            if res is None:
+                break
+            rec, consumed = res
+            if rec is None:
+                self.skipped += consumed
+            else:
+                # a smaller frame id means target has been reset
+                if self.last_frame is not None and rec['frame'] > self.last_frame:
+                    self.lost += rec['frame'] - self.last_frame - 1
+                self.last_frame = rec['frame']
+                records.append(rec)
+            del self.buf[:consumed]
+        return records
+
+
+def read_chunks(args):
+    if args.serial:
+        import serial
+        port = serial.Serial(args.serial, args.baudrate, timeout=0.1)
+        while True:
+            yield port.read(4096)
+    f = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+    while True:
+        data = f.read(4096)
+        if not data:
+            break
+        yield data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', nargs='?', default='-', help='raw console capture, - for stdin (default)')
+    parser.add_argument('--serial', help='read from this serial port instead of input')
+    parser.add_argument('--baudrate', type=int, default=115200, help='serial port baudrate (default: 115200)')
+    parser.add_argument('--format', choices=['json', 'csv'], default='json', help='output format (default: json)')
+    args = parser.parse_args()
+
+    dec = Decoder()
+    if args.format == 'csv':
+        print('frame,ts_ms,inference_us,pp_us,tracking_us,kind,id,class,conf,cx,cy,w,h')
+    try:
+        for chunk in read_chunks(args):
+            for rec in dec.feed(chunk):
+                if args.format == 'json':
+                    print(json.dumps(rec))
+                    continue
+                for box in rec['boxes']:
+                    print('%d,%d,%d,%d,%d,%s,%s,%s,%s,%.4f,%.4f,%.4f,%.4f' % (
+                        rec['frame'], rec['ts_ms'], rec['inference_us'], rec['pp_us'], rec['tracking_us'],
+                        rec['kind'], box.get('id', ''), box.get('class', ''),
+                        '%.3f' % box['conf'] if 'conf' in box else '', box['cx'], box['cy'], box['w'], box['h']))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    sys.stderr.write('frames lost %d, crc errors %d, non record bytes %d\n' % (dec.lost, dec.crc_errors,
+                                                                               dec.skipped))
+
+
+if __name__ == '__main__':
+    main()
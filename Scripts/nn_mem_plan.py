@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Compute activation lifetimes of a generated X-CUBE-AI network and the memory they need.
+
+Array, tensor, chain and layer declarations of network.c are parsed, layers are ordered by following their next
+pointer, and placement of arrays comes from network_configure_activations() / network_configure_weights(). An
+activation array lives from the first layer using it to the last one reading it. Network outputs live until the end.
+
+Reported:
+    - activation pool size of the generated placement against live footprint peak, which is the minimum pool size
+      for this layer order. Outputs of a layer may overlap inputs it reads for the last time, as the generated
+      placement does. The strict peak, without such overlap, is given too
+    - layers with the largest footprints and the arrays live at the peak
+    - pad and concat layers whose output is a copy of their inputs, with the peak if their inputs were written in
+      place into their output
+    - weights size per layer
+
+The placement is also checked: two arrays live at the same time must not overlap, except in place as above.
+
+Examples:
+    nn_mem_plan.py
+    nn_mem_plan.py Model/STM32N6570-DK/network.c --svg plan.svg --csv plan.csv
+"""
+
+import argparse
+import collections
+import csv
+import os
+import re
+import sys
+import zlib
+
+DEFAULT_NETWORK = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'Model', 'STM32N6570-DK',
+                               'network.c')
+
+FORMAT_BYTES = {'S8': 1, 'U8': 1, 'S16': 2, 'U16': 2, 'S32': 4, 'U32': 4, 'FLOAT': 4, 'BOOL': 1}
+COPY_KERNELS = ('forward_pad', 'forward_concat')
+
+Array = collections.namedtuple('Array', 'name size')
+Layer = collections.namedtuple('Layer', 'name id type forward inputs outputs weights scratch next axis')
+
+
+def macro_bodies(text, macro):
+    """Yield argument text of each top level 'macro(...)' invocation"""
+    for m in re.finditer(r'^%s\(' % macro, text, re.M):
+        depth = 0
+        for i in range(m.end() - 1, len(text)):
+            if text[i] == '(':
+                depth += 1
+            elif text[i] == ')':
+                depth -= 1
+                if depth == 0:
+                    yield text[m.end():i]
+                    break
+
+
+def parse_network(path):
+    with open(path, 'r', errors='replace') as f:
+        text = f.read()
+
+    arrays = {}
+    for body in macro_bodies(text, 'AI_ARRAY_OBJ_DECLARE'):
+        items = [i.strip() for i in body.split(',')]
+        fmt = re.match(r'AI_ARRAY_FORMAT_(\w+)', items[1])
+        width = FORMAT_BYTES.get(fmt.group(1), 1) if fmt else 1
+        arrays[items[0]] = Array(items[0], int(items[4]) * width)
+
+    tensors = {}
+    for body in macro_bodies(text, 'AI_TENSOR_OBJ_DECLARE'):
+        m = re.search(r'&(\w+)\s*,\s*&?\w+\s*$', body.strip())
+        tensors[body.split(',')[0].strip()] = m.group(1) if m else None
+
+    chains = {}
+    for body in macro_bodies(text, 'AI_TENSOR_CHAIN_OBJ_DECLARE'):
+        lists = re.findall(r'AI_TENSOR_LIST_OBJ_(?:INIT\(([^)]*)\)|EMPTY)', body)
+        lists = [[tensors.get(t) for t in re.findall(r'&(\w+)', l)] for l in lists]
+        lists += [[]] * (4 - len(lists))
+        chains[body.split(',')[0].strip()] = [[a for a in l if a] for l in lists]
+
+    layers = {}
+    for body in macro_bodies(text, 'AI_LAYER_OBJ_DECLARE'):
+        items = [i.strip() for i in body.split(',')]
+        chain = chains.get(items[7].lstrip('&'), [[], [], [], []])
+        axis = re.search(r'\.axis\s*=\s*AI_SHAPE_(\w+)', body)
+        layers[items[0]] = Layer(items[0], int(items[1]), items[2].replace('_TYPE', '').lower(), items[6],
+                                 chain[0], chain[1], chain[2], chain[3], items[9].lstrip('&'),
+                                 axis.group(1).lower() if axis else '')
+
+    # network first layer is the last pointer of network declaration
+    first = re.search(r'AI_NETWORK_OBJ_DECLARE\(.*?&(\w+_layer)\s*,\s*0x', text, re.S)
+    order = []
+    name = first.group(1) if first else None
+    while name in layers and name not in order:
+        order.append(name)
+        name = layers[name].next
+    order = [layers[n] for n in order]
+
+    acts = dict(re.findall(r'(\w+)\.data = AI_PTR\(g_network_activations_map\[0\] \+ (\d+)\);', text))
+    weights = dict(re.findall(r'(\w+)\.data = AI_PTR\(g_network_weights_map\[0\] \+ (\d+)\);', text))
+    outputs = re.search(r'AI_TENSOR_LIST_IO_OBJ_INIT\(AI_FLAG_NONE, AI_NETWORK_OUT_NUM,([^)]*)\)', text)
+    outputs = [tensors.get(t) for t in re.findall(r'&(\w+)', outputs.group(1))] if outputs else []
+
+    return (arrays, order, {a: int(o) for a, o in acts.items()}, {a: int(o) for a, o in weights.items()},
+            set(filter(None, outputs)))
+
+
+def lifetimes(order, acts, outputs):
+    """Return {array: [first, last]} layer indexes of activation arrays"""
+    life = {}
+    for i, layer in enumerate(order):
+        for name in layer.inputs + layer.outputs + layer.scratch:
+            if name not in acts:
+                continue
+            span = life.setdefault(name, [i, i])
+            span[1] = i
+    for name in outputs:
+        if name in life:
+            life[name][1] = len(order) - 1
+    return life
+
+
+def footprints(order, arrays, life):
+    """Return (strict, in_place) live bytes per layer.
+
+    strict counts inputs and outputs of a layer separately. in_place lets outputs of a layer overlap the inputs it
+    reads for the last time, as the code generator does for most kernels.
+    """
+    through = [0] * len(order)
+    dying = [0] * len(order)
+    born = [0] * len(order)
+    for name, (first, last) in life.items():
+        size = arrays[name].size
+        if first == last:
+            through[first] += size
+            continue
+        born[first] += size
+        dying[last] += size
+        for i in range(first + 1, last):
+            through[i] += size
+    strict = [t + d + b for t, d, b in zip(through, dying, born)]
+    in_place = [t + max(d, b) for t, d, b in zip(through, dying, born)]
+    return strict, in_place
+
+
+def consumers(order):
+    count = collections.Counter()
+    for layer in order:
+        for name in set(layer.inputs):
+            count[name] += 1
+    return count
+
+
+def alias_candidates(order, arrays, acts, life):
+    """Return [(layer, in_bytes, out_bytes, sole_consumer)] for layers copying their inputs into their output"""
+    used = consumers(order)
+    out = []
+    for layer in order:
+        if not layer.forward.startswith(COPY_KERNELS) or not layer.outputs:
+            continue
+        inputs = [n for n in layer.inputs if n in acts]
+        sole = all(used[n] == 1 for n in inputs)
+        out.append((layer, sum(arrays[n].size for n in inputs), arrays[layer.outputs[0]].size, sole))
+    return out
+
+
+def aliased_life(order, life, candidates):
+    """Lifetimes once inputs of candidates are written in place into their output"""
+    life = {k: list(v) for k, v in life.items()}
+    for layer, _, _, sole in candidates:
+        out = layer.outputs[0]
+        if not sole or out not in life:
+            continue
+        for name in layer.inputs:
+            if name in life:
+                life[out][0] = min(life[out][0], life[name][0])
+                del life[name]
+    return life
+
+
+def check_placement(arrays, acts, life):
+    """Return [(a, b)] of arrays live at the same time with overlapping placement. An array overlapping another one
+    read for the last time by the layer producing it is in place, not a clash.
+    """
+    items = sorted(life, key=lambda n: acts[n])
+    clashes = []
+    for i, a in enumerate(items):
+        a_end = acts[a] + arrays[a].size
+        for b in items[i + 1:]:
+            if acts[b] >= a_end:
+                break
+            if life[a][0] < life[b][1] and life[b][0] < life[a][1]:
+                clashes.append((a, b))
+    return clashes
+
+
+def write_csv(path, order, arrays, acts, life):
+    with open(path, 'w', newline='') as f:
+        w = csv.writer(f)
+        w.writerow(['array', 'offset', 'size', 'first', 'last', 'first_layer', 'last_layer'])
+        for name in sorted(life, key=lambda n: (life[n][0], acts[n])):
+            first, last = life[name]
+            w.writerow([name, acts[name], arrays[name].size, first, last, order[first].name, order[last].name])
+
+
+def write_svg(path, order, arrays, acts, life, steps, pool):
+    width, height, margin = 1200, 700, 50
+    xs = (width - 2 * margin) / len(order)
+    ys = (height - 2 * margin) / pool
+    peak = max(range(len(steps)), key=lambda i: steps[i])
+    out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="sans-serif" '
+           'font-size="11">' % (width, height),
+           '<rect width="100%" height="100%" fill="white"/>',
+           '<text x="%d" y="20">activation placement: x layer order, y offset in pool (%d bytes). Black line: live '
+           'bytes, peak %d at layer %s</text>' % (margin, pool, steps[peak], order[peak].name)]
+    for name, (first, last) in life.items():
+        hue = zlib.crc32(name.encode()) % 360
+        out.append('<rect x="%.1f" y="%.1f" width="%.1f" height="%.1f" fill="hsl(%d,60%%,70%%)" stroke="#555" '
+                   'stroke-width="0.3"><title>%s %d bytes @%d, layers %d-%d</title></rect>' % (
+                       margin + first * xs, margin + acts[name] * ys, (last - first + 1) * xs,
+                       max(arrays[name].size * ys, 0.5), hue, name, arrays[name].size, acts[name], first, last))
+    points = ' '.join('%.1f,%.1f' % (margin + (i + 0.5) * xs, margin + v * ys) for i, v in enumerate(steps))
+    out.append('<polyline points="%s" fill="none" stroke="black" stroke-width="1.5"/>' % points)
+    out.append('<line x1="%.1f" y1="%d" x2="%.1f" y2="%d" stroke="red" stroke-dasharray="4"/>' % (
+        margin + (peak + 0.5) * xs, margin, margin + (peak + 0.5) * xs, height - margin))
+    out.append('<rect x="%d" y="%d" width="%d" height="%d" fill="none" stroke="black"/>' % (
+        margin, margin, width - 2 * margin, height - 2 * margin))
+    out.append('</svg>')
+    with open(path, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('network', nargs='?', default=DEFAULT_NETWORK, help='generated network.c (default: DK model)')
+    parser.add_argument('--top', type=int, default=10, help='number of largest footprints to list (default: 10)')
+    parser.add_argument('--layers', action='store_true', help='print footprint of every layer')
+    parser.add_argument('--csv', help='write array lifetimes to this csv file')
+    parser.add_argument('--svg', help='write lifetime chart to this svg file')
+    args = parser.parse_args()
+
+    arrays, order, acts, weights, outputs = parse_network(args.network)
+    if not order or not acts:
+        sys.exit('%s: no layer or activation placement found. Only X-CUBE-AI cpu runtime models are supported'
+                 % args.network)
+
+    life = lifetimes(order, acts, outputs)
+    strict, steps = footprints(order, arrays, life)
+    pool = max(acts[n] + arrays[n].size for n in acts)
+    peak = max(range(len(steps)), key=lambda i: steps[i])
+    strict_peak = max(range(len(strict)), key=lambda i: strict[i])
+    candidates = alias_candidates(order, arrays, acts, life)
+    _, alias_steps = footprints(order, arrays, aliased_life(order, life, candidates))
+    alias_peak = max(range(len(alias_steps)), key=lambda i: alias_steps[i])
+    out = sys.stdout
+
+    out.write('%d layers, %d activation arrays, %d weight arrays\n' % (len(order), len(acts), len(weights)))
+    out.write('activation pool     %9d bytes, generated placement\n' % pool)
+    out.write('in place peak       %9d bytes at %s, minimum pool for this layer order\n' % (
+        steps[peak], order[peak].name))
+    out.write('strict peak         %9d bytes at %s, without in place layers\n' % (
+        strict[strict_peak], order[strict_peak].name))
+    out.write('aliased copies peak %9d bytes at %s\n' % (alias_steps[alias_peak], order[alias_peak].name))
+    out.write('weights             %9d bytes\n' % max(weights[n] + arrays[n].size for n in weights)
+              if weights else 'weights not placed in network.c\n')
+    for a, b in check_placement(arrays, acts, life):
+        out.write('warning: %s and %s are live together and overlap\n' % (a, b))
+
+    out.write('\nlargest footprints\n%5s %-36s %-16s %10s %10s\n' % ('idx', 'layer', 'type', 'in place', 'strict'))
+    for i in sorted(range(len(steps)), key=lambda i: -steps[i])[:args.top]:
+        out.write('%5d %-36s %-16s %10d %10d\n' % (i, order[i].name, order[i].type, steps[i], strict[i]))
+
+    out.write('\nlive at %s\n' % order[peak].name)
+    live = [n for n, (first, last) in life.items() if first <= peak <= last]
+    for name in sorted(live, key=lambda n: -arrays[n].size):
+        out.write('  %-40s %9d bytes @%-8d layers %d-%d\n' % (name, arrays[name].size, acts[name], *life[name]))
+
+    out.write('\ncopy layers, inputs could be written in place into output\n')
+    out.write('%5s %-36s %-16s %6s %10s %10s %s\n' % ('idx', 'layer', 'kernel', 'axis', 'in', 'out', 'aliasable'))
+    index = {layer.name: i for i, layer in enumerate(order)}
+    for layer, in_bytes, out_bytes, sole in candidates:
+        note = 'yes' if sole else 'no, input has other readers'
+        if sole and layer.forward.startswith('forward_concat') and layer.axis == 'channel':
+            note = 'yes, producers must write with channel stride'
+        out.write('%5d %-36s %-16s %6s %10d %10d %s\n' % (index[layer.name], layer.name, layer.forward, layer.axis,
+                                                        in_bytes, out_bytes, note))
+    out.write('%d pad and %d concat layers copy %d bytes per inference\n' % (
+        sum(1 for c in candidates if c[0].forward.startswith('forward_pad')),
+        sum(1 for c in candidates if c[0].forward.startswith('forward_concat')), sum(c[1] for c in candidates)))
+
+    if weights:
+        out.write('\nlargest weights\n%5s %-36s %-16s %10s\n' % ('idx', 'layer', 'type', 'bytes'))
+        per_layer = [(i, sum(arrays[n].size for n in layer.weights if n in weights)) for i, layer in enumerate(order)]
+        for i, size in sorted(per_layer, key=lambda v: -v[1])[:args.top]:
+            out.write('%5d %-36s %-16s %10d\n' % (i, order[i].name, order[i].type, size))
+
+    if args.layers:
+        out.write('\n%5s %-36s %-16s %10s %10s %10s\n' % ('idx', 'layer', 'type', 'in place', 'strict', 'aliased'))
+        for i, layer in enumerate(order):
+            out.write('%5d %-36s %-16s %10d %10d %10d\n' % (i, layer.name, layer.type, steps[i], strict[i],
+                                                             alias_steps[i]))
+
+    if args.csv:
+        write_csv(args.csv, order, arrays, acts, life)
+    if args.svg:
+        write_svg(args.svg, order, arrays, acts, life, steps, pool)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Render nn layer profiles printed by the application when USE_NN_PROFILER is defined.
+
+Profile reports are blocks of lines of the form:
+    prof,begin,report,run_nb,cpu_hz,layer_nb,run_cycles,layers_cycles
+    prof,type,type_name,layer_nb,cycles,permille
+    prof,layer,c_idx,id,type_name,forward,cycles,min_cycles,max_cycles
+    prof,end
+
+Cycles are averaged per inference. Reports found in the log are averaged together. With --elf, forward function
+addresses are resolved to kernel names (forward_pw_sssa8_ch, forward_dw_3x3_sssa8_ch, ...), which tells pointwise and
+depthwise convolutions apart.
+
+Examples:
+    nn_profile_view.py console.log
+    nn_profile_view.py console.log --elf build/Project.elf --by kernel --top 30
+"""
+
+import argparse
+import collections
+import subprocess
+import sys
+
+Layer = collections.namedtuple('Layer', 'c_idx id type forward cycles min max')
+
+
+def read_reports(lines):
+    """Yield (header, [Layer]) for each complete report"""
+    header = None
+    layers = []
+    for line in lines:
+        items = line.strip().split(',')
+        if len(items) < 2 or items[0] != 'prof':
+            continue
+        try:
+            if items[1] == 'begin':
+                header = dict(zip(('report', 'run_nb', 'cpu_hz', 'layer_nb', 'run_cycles', 'layers_cycles'),
+                                  map(int, items[2:8])))
+                layers = []
+            elif items[1] == 'layer' and header is not None:
+                layers.append(Layer(int(items[2]), int(items[3]), items[4], int(items[5], 16), int(items[6]),
+                                    int(items[7]), int(items[8])))
+            elif items[1] == 'end' and header is not None:
+                # a report truncated by a reset is dropped
+                if len(layers) == header['layer_nb']:
+                    yield header, layers
+                header = None
+        except (ValueError, IndexError):
+            header = None
+
+
+def resolve_symbols(elf, nm):
+    """Return {address: name} of functions, thumb bit cleared"""
+    out = subprocess.run([nm, elf], check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        items = line.split()
+        if len(items) == 3 and items[1] in 'tTwW':
+            symbols[int(items[0], 16) & ~1] = items[2]
+    return symbols
+
+
+def merge(reports):
+    """Average reports per layer index"""
+    runs = collections.defaultdict(list)
+    for _, layers in reports:
+        for layer in layers:
+            runs[layer.c_idx].append(layer)
+    merged = []
+    for c_idx, samples in runs.items():
+        first = samples[0]
+        merged.append(first._replace(cycles=sum(s.cycles for s in samples) / len(samples),
+                                     min=min(s.min for s in samples), max=max(s.max for s in samples)))
+    return merged
+
+
+def print_groups(layers, key, cpu_hz, out):
+    groups = collections.defaultdict(list)
+    for layer in layers:
+        groups[key(layer)].append(layer)
+    total = sum(layer.cycles for layer in layers)
+    cumul = 0
+    out.write('%-36s %6s %12s %10s %7s %7s\n' % ('group', 'layers', 'cycles', 'us', '%', 'cumul'))
+    for name, group in sorted(groups.items(), key=lambda kv: -sum(l.cycles for l in kv[1])):
+        cycles = sum(layer.cycles for layer in group)
+        cumul += cycles
+        out.write('%-36s %6d %12d %10.1f %7.1f %7.1f\n' % (name, len(group), cycles, 1e6 * cycles / cpu_hz,
+                                                          100.0 * cycles / total, 100.0 * cumul / total))
+
+
+def print_layers(layers, kernel, cpu_hz, top, out):
+    total = sum(layer.cycles for layer in layers)
+    out.write('%5s %5s %-16s %-32s %12s %10s %7s %12s %12s\n' % ('idx', 'id', 'type', 'kernel', 'cycles', 'us', '%',
+                                                                'min', 'max'))
+    for layer in sorted(layers, key=lambda l: -l.cycles)[:top]:
+        out.write('%5d %5d %-16s %-32s %12d %10.1f %7.1f %12d %12d\n' % (
+            layer.c_idx, layer.id, layer.type, kernel(layer), layer.cycles, 1e6 * layer.cycles / cpu_hz,
+            100.0 * layer.cycles / total, layer.min, layer.max))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('log', nargs='?', default='-', help='console log file, - for stdin (default)')
+    parser.add_argument('--elf', help='application elf, to resolve kernel names')
+    parser.add_argument('--nm', default='arm-none-eabi-nm', help='nm to use with --elf')
+    parser.add_argument('--by', choices=['type', 'kernel'], default='type', help='group layers by (default: type)')
+    parser.add_argument('--top', type=int, default=20, help='number of most expensive layers to list (default: 20)')
+    args = parser.parse_args()
+
+    f = sys.stdin if args.log == '-' else open(args.log, 'r', errors='replace')
+    reports = list(read_reports(f))
+    if not reports:
+        sys.exit('no complete profile report found')
+    if args.by == 'kernel' and not args.elf:
+        sys.exit('--by kernel needs --elf')
+
+    symbols = resolve_symbols(args.elf, args.nm) if args.elf else {}
+
+    def kernel(layer):
+        if not layer.forward:
+            return '?'
+        return symbols.get(layer.forward & ~1, '0x%08x' % layer.forward)
+
+    header = reports[-1][0]
+    cpu_hz = header['cpu_hz']
+    layers = merge(reports)
+    run_cycles = sum(h['run_cycles'] for h, _ in reports) / len(reports)
+    layers_cycles = sum(layer.cycles for layer in layers)
+    out = sys.stdout
+    out.write('%d reports, %d inferences, %d layers\n' % (len(reports), sum(h['run_nb'] for h, _ in reports),
+                                                          len(layers)))
+    out.write('inference %.2f ms, layers %.2f ms, runtime overhead %.1f%%\n\n' % (
+        1e3 * run_cycles / cpu_hz, 1e3 * layers_cycles / cpu_hz,
+        100.0 * (run_cycles - layers_cycles) / run_cycles if run_cycles else 0))
+    print_groups(layers, kernel if args.by == 'kernel' else (lambda l: l.type), cpu_hz, out)
+    out.write('\n')
+    print_layers(layers, kernel, cpu_hz, args.top, out)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Replay overlay dirty area tracking of Src/overlay.c on host and count frame buffer traffic per update.
+
+Src/overlay.c is compiled with the host C compiler and driven through ctypes, so clipping, overflow and cache
+maintenance ranges are the ones of the dp thread. Each update draws into one of the two foreground buffers: areas
+drawn into it two updates earlier are erased, then boxes outlines (4 edges), their labels and --panel stats lines are
+drawn and written back. Boxes move a few pixels per update. Every panel line is redrawn on each update, an upper bound
+of the panel cost.
+
+Reported per update, against a full clear and clean of the foreground buffer:
+    rects        areas tracked for the buffer, 'overflow' once more than --rect-max are drawn
+    cleared      bytes erased by fill
+    cleaned      bytes written back from dcache, rounded to 32 bytes cache lines, erase and draw included
+    ops          dcache maintenance calls, one per range
+
+Examples:
+    overlay_bench.py
+    overlay_bench.py --width 320 --height 240 --glyph 7x12 --boxes 0,1,5,10
+    overlay_bench.py --check            # tracking checks against a python model, non zero exit on failure
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+
+import hostbuild
+
+CACHE_LINE = 32
+
+
+# Keep in sync with Inc/overlay.h
+class Rect(ctypes.Structure):
+    _fields_ = [('X0', ctypes.c_uint32), ('Y0', ctypes.c_uint32), ('XSize', ctypes.c_uint32),
+                ('YSize', ctypes.c_uint32)]
+
+
+class OvlDirty(ctypes.Structure):
+    _fields_ = [('width', ctypes.c_int), ('height', ctypes.c_int), ('rects', ctypes.POINTER(Rect)),
+                ('rect_max', ctypes.c_int), ('nb', ctypes.c_int), ('is_overflow', ctypes.c_int)]
+
+
+def build_overlay(build):
+    lib = build.lib('overlay', ['Src/overlay.c'], includes=['Inc'])
+    lib.ovl_dirty_init.argtypes = [ctypes.POINTER(OvlDirty), ctypes.c_int, ctypes.c_int, ctypes.POINTER(Rect),
+                                   ctypes.c_int]
+    lib.ovl_dirty_add.argtypes = [ctypes.POINTER(OvlDirty)] + [ctypes.c_int] * 4
+    lib.ovl_dirty_reset.argtypes = [ctypes.POINTER(OvlDirty)]
+    lib.ovl_is_overlapping.argtypes = [ctypes.POINTER(Rect), ctypes.POINTER(Rect)]
+    lib.ovl_range_next.argtypes = [ctypes.POINTER(Rect), ctypes.c_int, ctypes.POINTER(ctypes.c_int),
+                                   ctypes.POINTER(ctypes.c_uint32)]
+    return lib
+
+
+class Dirty:
+    """ovl_dirty_t with its rectangles storage"""
+
+    def __init__(self, lib, width, height, rect_max):
+        self.lib = lib
+        self.rects = (Rect * rect_max)()
+        self.ctx = OvlDirty()
+        lib.ovl_dirty_init(ctypes.byref(self.ctx), width, height, self.rects, rect_max)
+
+    def add(self, x, y, w, h):
+        self.lib.ovl_dirty_add(ctypes.byref(self.ctx), x, y, w, h)
+
+    def reset(self):
+        self.lib.ovl_dirty_reset(ctypes.byref(self.ctx))
+
+    def list(self):
+        return [(r.X0, r.Y0, r.XSize, r.YSize) for r in self.rects[:self.ctx.nb]]
+
+
+def ranges(lib, rect, width):
+    """Return (offset, len) list of ovl_range_next() for rect"""
+    r = Rect(*rect)
+    row = ctypes.c_int(0)
+    offset = ctypes.c_uint32(0)
+    res = []
+    while True:
+        length = lib.ovl_range_next(ctypes.byref(r), width, ctypes.byref(row), ctypes.byref(offset))
+        if not length:
+            return res
+        res.append((offset.value, length))
+
+
+def line_bytes(offset, length):
+    return ((offset + length - 1) // CACHE_LINE - offset // CACHE_LINE + 1) * CACHE_LINE
+
+
+def ref_clip(x, y, w, h, width, height):
+    """Python model of ovl_dirty_add() clipping, None when nothing is left"""
+    x0, y0 = max(x, 0), max(y, 0)
+    x1, y1 = min(x + w, width), min(y + h, height)
+    return (x0, y0, x1 - x0, y1 - y0) if x1 > x0 and y1 > y0 else None
+
+
+def check(lib, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    width, height = 800, 480
+
+    dirty = Dirty(lib, width, height, 8)
+    for area in [(-5, -3, 20, 10), (790, 470, 20, 20), (100, 100, 1, 300), (-20, 0, 10, 10), (0, 480, 5, 5),
+                 (10, 10, 0, 5)]:
+        dirty.add(*area)
+    expect('clips to frame buffer and drops empty areas',
+           dirty.list() == [(0, 0, 15, 7), (790, 470, 10, 10), (100, 100, 1, 300)])
+
+    bad = 0
+    for _ in range(2000):
+        dirty.reset()
+        area = (rnd.randint(-100, 900), rnd.randint(-100, 580), rnd.randint(-5, 300), rnd.randint(-5, 300))
+        dirty.add(*area)
+        ref = ref_clip(*area, width, height)
+        bad += dirty.list() != ([ref] if ref else [])
+    expect('2000 random areas clip as python model', bad == 0)
+
+    dirty.reset()
+    for i in range(9):
+        dirty.add(i, i, 4, 4)
+    full = dirty.ctx.nb == 8 and dirty.ctx.is_overflow
+    dirty.reset()
+    expect('overflows past rect_max, reset restarts tracking', full and dirty.ctx.nb == 0 and not dirty.ctx.is_overflow)
+
+    bad = 0
+    for _ in range(2000):
+        a = (rnd.randint(0, 50), rnd.randint(0, 50), rnd.randint(1, 30), rnd.randint(1, 30))
+        b = (rnd.randint(0, 50), rnd.randint(0, 50), rnd.randint(1, 30), rnd.randint(1, 30))
+        ref = a[0] < b[0] + b[2] and b[0] < a[0] + a[2] and a[1] < b[1] + b[3] and b[1] < a[1] + a[3]
+        bad += bool(lib.ovl_is_overlapping(Rect(*a), Rect(*b))) != ref
+    touch = lib.ovl_is_overlapping(Rect(0, 0, 10, 10), Rect(10, 0, 10, 10))
+    expect('overlap matches python model, touching is not', bad == 0 and not touch)
+
+    # each range must stay inside frame buffer and all of them must cover every byte of the area
+    bad = 0
+    for _ in range(500):
+        x, y = rnd.randint(0, width - 1), rnd.randint(0, height - 1)
+        rect = (x, y, rnd.randint(1, width - x), rnd.randint(1, min(40, height - y)))
+        covered = set()
+        res = ranges(lib, rect, width)
+        for offset, length in res:
+            bad += offset + length > width * height * 2
+            covered.update(range(offset, offset + length))
+        wanted = {(row * width + col) * 2 + b for row in range(rect[1], rect[1] + rect[3])
+                  for col in range(rect[0], rect[0] + rect[2]) for b in range(2)}
+        bad += not wanted <= covered
+        bad += len(res) != (1 if rect[2] * 2 >= width else rect[3])
+        bad += rect[2] * 2 < width and len(covered) != len(wanted)
+    expect('ranges cover area, one per row unless wide', bad == 0)
+
+    args = argparse.Namespace(width=width, height=height, glyph_w=14, glyph_h=20, label=6, panel=16, updates=50)
+    limit = 10
+    res = {nb: measure(lib, nb, 5 * limit + 16, args, rnd) for nb in (0, limit, limit + 1)}
+    full = width * height * 2
+    expect('box limit fits without overflow, cheaper than full',
+           all(not r['overflow'] and r['cleared'] + r['cleaned'] < full for r in (res[0], res[limit])))
+    expect('overflow falls back to full buffer', res[limit + 1]['overflow'] and res[limit + 1]['cleared'] == full)
+
+    return checker.ok()
+
+
+def measure(lib, box_nb, rect_max, args, rnd):
+    """Return mean per update traffic of box_nb moving boxes and args.panel lines over args.updates updates"""
+    width, height = args.width, args.height
+    full = width * height * 2
+    buffers = [Dirty(lib, width, height, rect_max) for _ in range(2)]
+    boxes = []
+    for _ in range(box_nb):
+        w, h = rnd.randint(width // 20, width // 4), rnd.randint(height // 6, height * 3 // 4)
+        boxes.append([rnd.randint(0, width - w), rnd.randint(0, height - h), w, h,
+                      rnd.choice([-3, -1, 1, 3]), rnd.choice([-2, 0, 2])])
+    total = {'rects': 0, 'cleared': 0, 'cleaned': 0, 'ops': 0, 'overflow': False}
+
+    def clean(rect):
+        for offset, length in ranges(lib, rect, width):
+            total['cleaned'] += line_bytes(offset, length)
+            total['ops'] += 1
+
+    # first two updates start from cleared buffers
+    for update in range(args.updates + 2):
+        dirty = buffers[update % 2]
+        is_counted = update >= 2
+        if is_counted and dirty.ctx.is_overflow:
+            total['cleared'] += full
+            total['cleaned'] += full
+            total['ops'] += 1
+        elif is_counted:
+            for rect in dirty.list():
+                total['cleared'] += rect[2] * rect[3] * 2
+                clean(rect)
+        dirty.reset()
+
+        for line in range(args.panel):
+            text_w = rnd.randint(6, 12) * args.glyph_w
+            dirty.add(width - text_w, line * args.glyph_h, text_w, args.glyph_h)
+        for box in boxes:
+            x, y, w, h = box[:4]
+            dirty.add(x, y, w, 1)
+            dirty.add(x, y + h - 1, w, 1)
+            dirty.add(x, y, 1, h)
+            dirty.add(x + w - 1, y, 1, h)
+            dirty.add(x + 1, y + 1, args.label * args.glyph_w, args.glyph_h)
+            box[0] = min(max(x + box[4], 0), width - w)
+            box[1] = min(max(y + box[5], 0), height - h)
+
+        if not is_counted:
+            continue
+        total['rects'] += dirty.ctx.nb
+        total['overflow'] |= bool(dirty.ctx.is_overflow)
+        if dirty.ctx.is_overflow:
+            total['cleaned'] += full
+            total['ops'] += 1
+        else:
+            for rect in dirty.list():
+                clean(rect)
+
+    for key in ('rects', 'cleared', 'cleaned', 'ops'):
+        total[key] /= args.updates
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run tracking checks instead of measure')
+    parser.add_argument('--boxes', default='0,1,5,10,20', help='comma separated boxes on screen (default: 0,1,5,10,20)')
+    parser.add_argument('--limit', type=int, default=10, help='AI_OD_PP_MAX_BOXES_LIMIT (default: 10)')
+    parser.add_argument('--rect-max', type=int, help='OVERLAY_DIRTY_MAX (default: 5 * limit + 16)')
+    parser.add_argument('--width', type=int, default=800, help='foreground width (default: 800)')
+    parser.add_argument('--height', type=int, default=480, help='foreground height (default: 480)')
+    parser.add_argument('--glyph', default='14x20', help='LCD_FONT glyph size (default: 14x20)')
+    parser.add_argument('--label', type=int, default=6, help='label length in glyphs (default: 6)')
+    parser.add_argument('--panel', type=int, default=11, help='stats panel lines (default: 11)')
+    parser.add_argument('--updates', type=int, default=100, help='updates per box count (default: 100)')
+    hostbuild.add_arguments(parser)
+    args = parser.parse_args()
+    args.glyph_w, args.glyph_h = [int(v) for v in args.glyph.split('x')]
+    rect_max = args.rect_max if args.rect_max is not None else 5 * args.limit + 16
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build_overlay(build)
+        if args.check:
+            sys.exit(0 if check(lib, args.seed) else 1)
+
+        rnd = random.Random(args.seed)
+        full = args.width * args.height * 2
+        out = sys.stdout
+        out.write('%dx%d foreground, %d panel lines, OVERLAY_DIRTY_MAX %d, per update:\n' %
+                  (args.width, args.height, args.panel, rect_max))
+        out.write('%6s %9s %10s %10s %7s %9s\n' % ('boxes', 'rects', 'cleared', 'cleaned', 'ops', 'vs full'))
+        out.write('%6s %9s %10d %10d %7d %8.1f%%\n' % ('full', '-', full, full, 1, 100))
+        for box_nb in [int(b) for b in args.boxes.split(',')]:
+            res = measure(lib, box_nb, rect_max, args, rnd)
+            rects = 'overflow' if res['overflow'] else '%.0f' % res['rects']
+            out.write('%6d %9s %10.0f %10.0f %7.0f %8.1f%%\n' %
+                      (box_nb, rects, res['cleared'], res['cleaned'], res['ops'],
+                       (res['cleared'] + res['cleaned']) * 100 / (2 * full)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Check and benchmark the span rasterizer of Lib/screenl/Src/scrl_raster.c against the former per pixel drivers.
+
+Lib/screenl/Src/scrl_raster.c is compiled with the host C compiler together with a copy of the nested loop drivers it
+replaced in scrl_common.c, and both are driven through ctypes. Host builds take the scalar path; the MVE path is only
+built for target.
+
+The reference FillRGBRect 24 bits driver advanced rows by layer_width + 3 bytes instead of layer_width * 3. The copy
+below uses the right stride, so it gives what the driver was meant to draw.
+
+--check draws random rectangles, lines and copies at random alignments, sizes and pitches into frames filled with
+random pixels, and compares whole frames, so bytes outside of the drawn area are checked too.
+
+Benchmark columns:
+    ref us      host time of one call of the former driver, ctypes call overhead removed
+    raster us   same for the rasterizer
+    MB/s        bytes written per second by the rasterizer
+
+Examples:
+    raster_bench.py
+    raster_bench.py --check                      # pixel equality checks, non zero exit on failure
+    raster_bench.py --width 800 --height 480 --loops 200
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+import time
+
+import hostbuild
+
+# Drivers removed from Lib/screenl/Src/scrl_common.c, with layer context replaced by arguments
+REF_SRC = r'''
+#include <stdint.h>
+
+void REF_FillRGBRect16(uint16_t *pel, int layer_width, const uint8_t *pData, int src_pitch, int Width, int Height)
+{
+  int w, h;
+
+  for (h = 0; h < Height; h++) {
+    for (w = 0; w < Width; w++) {
+      pel[w] = *(uint16_t *)(pData + 2 * w);
+    }
+    pel += layer_width;
+    pData += 2 * src_pitch;
+  }
+}
+
+void REF_FillRGBRect24(uint8_t *pel, int layer_width, const uint8_t *pData, int src_pitch, int Width, int Height)
+{
+  int w, h;
+
+  for (h = 0; h < Height; h++) {
+    for (w = 0; w < Width; w++) {
+      pel[3 * w + 0] = pData[3 * w + 0];
+      pel[3 * w + 1] = pData[3 * w + 1];
+      pel[3 * w + 2] = pData[3 * w + 2];
+    }
+    pel += layer_width * 3;
+    pData += 3 * src_pitch;
+  }
+}
+
+void REF_HLine16(uint16_t *pel, int Length, uint16_t Color)
+{
+  int i;
+
+  for (i = 0; i < Length; i++)
+    *pel++ = Color;
+}
+
+void REF_VLine16(uint16_t *pel, int layer_width, int Length, uint16_t Color)
+{
+  int i;
+
+  for (i = 0; i < Length; i++) {
+    *pel = Color;
+    pel += layer_width;
+  }
+}
+
+void REF_FillRect16(uint16_t *pel, int layer_width, int Width, int Height, uint16_t Color)
+{
+  int w, h;
+
+  for (h = 0; h < Height; h++) {
+    for (w = 0; w < Width; w++) {
+      pel[w] = Color;
+    }
+    pel += layer_width;
+  }
+}
+
+void REF_FillRect24(uint8_t *pel, int layer_width, int Width, int Height, uint32_t Color)
+{
+  uint8_t r, g, b;
+  int w, h;
+
+  r = (Color >> 16) & 0xff;
+  g = (Color >> 8) & 0xff;
+  b = (Color >> 0) & 0xff;
+  for (h = 0; h < Height; h++) {
+    for (w = 0; w < Width; w++) {
+      pel[3 * w + 0] = b;
+      pel[3 * w + 1] = g;
+      pel[3 * w + 2] = r;
+    }
+    pel += layer_width * 3;
+  }
+}
+
+void REF_HLine24(uint8_t *pel, int Length, uint32_t Color)
+{
+  REF_FillRect24(pel, Length, Length, 1, Color);
+}
+
+void REF_VLine24(uint8_t *pel, int layer_width, int Length, uint32_t Color)
+{
+  REF_FillRect24(pel, layer_width, 1, Length, Color);
+}
+'''
+
+P, I, U16, U32 = ctypes.c_void_p, ctypes.c_int, ctypes.c_uint16, ctypes.c_uint32
+
+# name: (bytes per pixel, reference, rasterizer, argtypes after dst), drivers take (dst, <args>)
+OPS = {
+    'fill16': (2, 'REF_FillRect16', 'SCRR_FillRect16', [I, I, I, U16]),
+    'fill24': (3, 'REF_FillRect24', 'SCRR_FillRect24', [I, I, I, U32]),
+    'hline16': (2, 'REF_HLine16', 'SCRR_FillSpan16', [I, U16]),
+    'hline24': (3, 'REF_HLine24', 'SCRR_FillSpan24', [I, U32]),
+    'vline16': (2, 'REF_VLine16', 'SCRR_VLine16', [I, I, U16]),
+    'vline24': (3, 'REF_VLine24', 'SCRR_VLine24', [I, I, U32]),
+    'copy16': (2, 'REF_FillRGBRect16', 'SCRR_CopyRect16', [I, P, I, I, I]),
+    'copy24': (3, 'REF_FillRGBRect24', 'SCRR_CopyRect24', [I, P, I, I, I]),
+}
+
+
+def build_raster(build):
+    lib = build.lib('raster', ['Lib/screenl/Src/scrl_raster.c'], includes=['Lib/screenl/Inc'], code=REF_SRC)
+    for bpp, ref_name, name, argtypes in OPS.values():
+        for fct in (getattr(lib, ref_name), getattr(lib, name)):
+            fct.argtypes = [P] + argtypes
+            fct.restype = None
+    return lib
+
+
+def fct_args(op, pitch, w, h, color, src, src_pitch):
+    """Arguments after dst for op, identical for reference and rasterizer"""
+    return {
+        'fill16': (pitch, w, h, color & 0xffff),
+        'fill24': (pitch, w, h, color & 0xffffff),
+        'hline16': (w, color & 0xffff),
+        'hline24': (w, color & 0xffffff),
+        'vline16': (pitch, h, color & 0xffff),
+        'vline24': (pitch, h, color & 0xffffff),
+        'copy16': (pitch, src, src_pitch, w, h),
+        'copy24': (pitch, src, src_pitch, w, h),
+    }[op]
+
+
+def run_case(lib, op, pitch, x, y, w, h, base_off, src_off, src_pitch, rnd):
+    """Draw with both drivers into identical random frames, return True when frames are identical"""
+    bpp, ref_name, name, _ = OPS[op]
+    rows = y + h + 2
+    size = base_off + pitch * rows * bpp
+    init = rnd.randbytes(size)
+    src = ctypes.create_string_buffer(rnd.randbytes(src_off + src_pitch * h * bpp + 1))
+    src_addr = ctypes.addressof(src) + src_off
+    color = rnd.getrandbits(32)
+    frames = []
+    for fct_name in (ref_name, name):
+        frame = ctypes.create_string_buffer(init, size)
+        dst = ctypes.addressof(frame) + base_off + (y * pitch + x) * bpp
+        getattr(lib, fct_name)(dst, *fct_args(op, pitch, w, h, color, src_addr, src_pitch))
+        frames.append(frame.raw)
+    return frames[0] == frames[1]
+
+
+def check(lib, cases, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    for op, (bpp, _, _, _) in OPS.items():
+        bad = 0
+        for i in range(cases):
+            pitch = rnd.randint(1, 80)
+            x = rnd.randrange(pitch)
+            # small sizes hit head / tail paths, larger ones the word and vector loops
+            w = rnd.randint(0, min(pitch - x, 40 if i % 2 else 4))
+            if op.startswith('vline'):
+                w = 1
+            h = rnd.randint(0, 12)
+            y = rnd.randint(0, 3)
+            if op.startswith('hline'):
+                h = 1
+            # 16 bits pixels stay halfword aligned
+            base_off = rnd.randrange(0, 8, 2 if bpp == 2 else 1)
+            src_off = rnd.randrange(8)
+            src_pitch = w + (rnd.randint(0, 5) if i % 3 else 0)
+            if not run_case(lib, op, pitch, x, y, w, h, base_off, src_off, src_pitch, rnd):
+                bad += 1
+                if bad == 1:
+                    print('  first mismatch: pitch %d x %d y %d w %d h %d offset %d src offset %d src pitch %d' %
+                          (pitch, x, y, w, h, base_off, src_off, src_pitch))
+        expect('%s matches former driver on %d random cases' % (op, cases), bad == 0)
+
+    # full width rectangles take the single span path
+    for op in ('fill16', 'fill24'):
+        expect('%s full width rectangle' % op, all(run_case(lib, op, pitch, 0, 1, pitch, 9, off, 0, pitch, rnd)
+                                                   for pitch in (1, 3, 7, 320) for off in (0, 2)))
+
+    return checker.ok()
+
+
+def call_overhead(lib, loops):
+    fct = lib.SCRR_FillSpan16
+    buf = ctypes.create_string_buffer(16)
+    start = time.perf_counter()
+    for _ in range(loops):
+        fct(buf, 0, 0)
+    return (time.perf_counter() - start) / loops
+
+
+def bench_op(lib, fct_name, op, width, height, loops, overhead):
+    bpp = OPS[op][0]
+    frame = ctypes.create_string_buffer(width * height * bpp + 4)
+    src = ctypes.create_string_buffer(width * height * bpp + 4)
+    # odd origin so no case starts aligned
+    w, h = width - 2, height - 2
+    dst = ctypes.addressof(frame) + (width + 1) * bpp
+    args = fct_args(op, width, w, h, 0x123456, ctypes.addressof(src) + 1, width)
+    fct = getattr(lib, fct_name)
+    start = time.perf_counter()
+    for _ in range(loops):
+        fct(dst, *args)
+    return max(0, (time.perf_counter() - start) / loops - overhead)
+
+
+def bytes_written(op, width, height):
+    bpp = OPS[op][0]
+    w, h = width - 2, height - 2
+    if op.startswith('hline'):
+        return w * bpp
+    if op.startswith('vline'):
+        return h * bpp
+    return w * h * bpp
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run pixel equality checks instead of benchmark')
+    parser.add_argument('--cases', type=int, default=2000, help='random cases per driver in check (default: 2000)')
+    parser.add_argument('--width', type=int, default=320, help='benchmark layer width (default: 320)')
+    parser.add_argument('--height', type=int, default=240, help='benchmark layer height (default: 240)')
+    parser.add_argument('--loops', type=int, default=100, help='calls timed per driver (default: 100)')
+    hostbuild.add_arguments(parser, cflags='-O2')
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc, args.cflags) as build:
+        lib = build_raster(build)
+        if args.check:
+            sys.exit(0 if check(lib, args.cases, args.seed) else 1)
+
+        overhead = call_overhead(lib, 20000)
+        out = sys.stdout
+        out.write('%-8s %10s %10s %8s %9s\n' % ('op', 'ref us', 'raster us', 'speedup', 'MB/s'))
+        for op, (_, ref_name, name, _) in OPS.items():
+            ref_s = bench_op(lib, ref_name, op, args.width, args.height, args.loops, overhead)
+            raster_s = bench_op(lib, name, op, args.width, args.height, args.loops, overhead)
+            out.write('%-8s %10.2f %10.2f %7.2fx %9.0f\n' % (
+                op, ref_s * 1e6, raster_s * 1e6, ref_s / raster_s if raster_s else 0,
+                bytes_written(op, args.width, args.height) / raster_s / 1e6 if raster_s else 0))
+
+
+if __name__ == '__main__':
+    main()
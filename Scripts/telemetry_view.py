@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Display task telemetry printed by the application when USE_TELEMETRY is defined.
+
+Telemetry lines have the form:
+    tlm,ts_ms,task,prio,cpu_permille,stack_free_words,ctx_switches
+
+Input is either a serial port (needs pyserial) or a captured console log.
+
+Examples:
+    telemetry_view.py --port /dev/ttyACM0
+    telemetry_view.py console.log --summary
+    telemetry_view.py console.log --plot
+"""
+
+import argparse
+import collections
+import sys
+
+FIELDS = ('ts_ms', 'task', 'prio', 'cpu_permille', 'stack_free_words', 'ctx_switches')
+
+Sample = collections.namedtuple('Sample', FIELDS)
+
+
+def parse_line(line):
+    items = line.strip().split(',')
+    if len(items) != len(FIELDS) + 1 or items[0] != 'tlm':
+        return None
+    try:
+        return Sample(int(items[1]), items[2], int(items[3]), int(items[4]), int(items[5]), int(items[6]))
+    except ValueError:
+        # header line
+        return None
+
+
+def open_input(args):
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit('pyserial is required to read from a serial port')
+        port = serial.Serial(args.port, args.baudrate, timeout=1)
+        return (line.decode('ascii', errors='replace') for line in iter(port.readline, None))
+    if args.log == '-':
+        return sys.stdin
+    return open(args.log, 'r', errors='replace')
+
+
+def read_samples(lines):
+    batch = []
+    ts = None
+    for line in lines:
+        s = parse_line(line)
+        if not s:
+            continue
+        if ts is not None and s.ts_ms != ts:
+            yield ts, batch
+            batch = []
+        ts = s.ts_ms
+        batch.append(s)
+    if batch:
+        yield ts, batch
+
+
+def print_batch(ts, batch, out):
+    out.write('\n@ %d ms\n' % ts)
+    out.write('%-16s %5s %7s %10s %10s\n' % ('task', 'prio', 'cpu %', 'stack free', 'ctx sw'))
+    for s in sorted(batch, key=lambda s: -s.cpu_permille):
+        out.write('%-16s %5d %7.1f %10d %10d\n' % (s.task, s.prio, s.cpu_permille / 10.0, s.stack_free_words,
+                                                  s.ctx_switches))
+    out.flush()
+
+
+def print_summary(history, out):
+    out.write('\n%-16s %9s %9s %15s %12s\n' % ('task', 'avg cpu %', 'max cpu %', 'min stack free', 'avg ctx sw'))
+    for task, samples in sorted(history.items()):
+        cpu = [s.cpu_permille / 10.0 for s in samples]
+        sw = [s.ctx_switches for s in samples]
+        out.write('%-16s %9.1f %9.1f %15d %12.1f\n' % (task, sum(cpu) / len(cpu), max(cpu),
+                                                       min(s.stack_free_words for s in samples),
+                                                       sum(sw) / len(sw)))
+
+
+def plot(history):
+    try:
+        import matplotlib.pyplot as plt
+    except ImportError:
+        sys.exit('matplotlib is required for --plot')
+    fig, (ax_cpu, ax_stack) = plt.subplots(2, 1, sharex=True)
+    for task, samples in sorted(history.items()):
+        ts = [s.ts_ms / 1000.0 for s in samples]
+        ax_cpu.plot(ts, [s.cpu_permille / 10.0 for s in samples], label=task)
+        ax_stack.plot(ts, [s.stack_free_words for s in samples], label=task)
+    ax_cpu.set_ylabel('cpu %')
+    ax_stack.set_ylabel('stack free (words)')
+    ax_stack.set_xlabel('time (s)')
+    ax_cpu.legend(loc='upper right', fontsize='small')
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('log', nargs='?', default='-', help='console log file, - for stdin (default)')
+    parser.add_argument('--port', help='serial port to read console from')
+    parser.add_argument('--baudrate', type=int, default=115200)
+    parser.add_argument('--summary', action='store_true', help='only print per task summary at end of input')
+    parser.add_argument('--plot', action='store_true', help='plot cpu share and stack usage at end of input')
+    args = parser.parse_args()
+
+    history = collections.defaultdict(list)
+    try:
+        for ts, batch in read_samples(open_input(args)):
+            for s in batch:
+                history[s.task].append(s)
+            if not args.summary and not args.plot:
+                print_batch(ts, batch, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+    if history:
+        print_summary(history, sys.stdout)
+    if args.plot and history:
+        plot(history)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Check and benchmark cross tile box merge of Src/tiling.c on synthetic scenes.
+
+Src/tiling.c and Src/zoom.c are compiled with the host C compiler and driven through ctypes, so the merge under test
+is the one running on target when USE_NN_TILING is defined.
+
+Synthetic people are spread over the field of view. Each tile detects the part of a person it sees when that part
+is at least --min-visible of the person, with some jitter, as a detector would. Tile results are merged and compared
+to ground truth:
+    found       people matched by a merged box with iou >= 0.5
+    extra       merged boxes matching nobody, mostly people split across tiles and not merged back
+    us/merge    host time of one tile_merge() call, ctypes call overhead removed
+    pairs       box pairs compared by merge, which is what target cost scales with
+
+'plain' is a iou only nms given as reference.
+
+Examples:
+    tile_merge_bench.py
+    tile_merge_bench.py --check                  # unit checks on hand made boxes, non zero exit on failure
+    tile_merge_bench.py --grid 2 --people 1,5,20 --overlap 0.1
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+import time
+
+import hostbuild
+
+TILE_MAX = 16
+CUT_LEFT, CUT_RIGHT, CUT_TOP, CUT_BOTTOM = 1, 2, 4, 8
+
+
+# Keep in sync with Inc/zoom.h and Inc/tiling.h
+class ZoomRoi(ctypes.Structure):
+    _fields_ = [('x', ctypes.c_float), ('y', ctypes.c_float), ('size', ctypes.c_float)]
+
+
+class TileBox(ctypes.Structure):
+    _fields_ = [('cx', ctypes.c_float), ('cy', ctypes.c_float), ('w', ctypes.c_float), ('h', ctypes.c_float),
+                ('conf', ctypes.c_float), ('class_index', ctypes.c_int), ('tile', ctypes.c_int), ('cut', ctypes.c_int)]
+
+
+class TileConf(ctypes.Structure):
+    _fields_ = [('grid', ctypes.c_int), ('overlap', ctypes.c_float), ('min_size', ctypes.c_float),
+                ('is_sweep', ctypes.c_int), ('iou_thresh', ctypes.c_float), ('contain_thresh', ctypes.c_float),
+                ('cut_margin', ctypes.c_float)]
+
+
+class TileCtx(ctypes.Structure):
+    _fields_ = [('cfg', TileConf), ('tile_nb', ctypes.c_int), ('tiles', ZoomRoi * TILE_MAX), ('next', ctypes.c_int),
+                ('box_max', ctypes.c_int), ('boxes', ctypes.POINTER(TileBox)), ('box_nb', ctypes.c_int * TILE_MAX),
+                ('work', ctypes.POINTER(TileBox)), ('fresh', ctypes.c_uint)]
+
+
+def build_tiling(build):
+    return build.lib('tiling', ['Src/tiling.c', 'Src/zoom.c'], includes=['Inc'])
+
+
+class Tiling:
+    def __init__(self, lib, box_max, **conf):
+        self.lib = lib
+        self.cfg = TileConf(**conf)
+        nb = self.cfg.grid * self.cfg.grid * box_max
+        self.boxes = (TileBox * nb)()
+        self.work = (TileBox * nb)()
+        self.out = (TileBox * nb)()
+        self.ctx = TileCtx()
+        if lib.tile_init(ctypes.byref(self.ctx), ctypes.byref(self.cfg), box_max, self.boxes, self.work):
+            sys.exit('tile_init failed')
+
+    def tiles(self):
+        return [(t.x, t.y, t.size) for t in self.ctx.tiles[:self.ctx.tile_nb]]
+
+    def add(self, tile, boxes):
+        """boxes are (cx, cy, w, h, conf) in tile coordinates. Return tile_add() result"""
+        arr = (TileBox * max(1, len(boxes)))(*[TileBox(cx, cy, w, h, conf, 0, 0, 0) for cx, cy, w, h, conf in boxes])
+        roi = self.ctx.tiles[tile]
+        return self.lib.tile_add(ctypes.byref(self.ctx), tile, ctypes.byref(roi), len(boxes), arr)
+
+    def merge(self):
+        nb = self.lib.tile_merge(ctypes.byref(self.ctx), len(self.out), self.out)
+        return [(b.cx, b.cy, b.w, b.h, b.conf, b.cut) for b in self.out[:nb]]
+
+
+def rect(box):
+    return box[0] - box[2] / 2, box[1] - box[3] / 2, box[0] + box[2] / 2, box[1] + box[3] / 2
+
+
+def iou(a, b):
+    ax0, ay0, ax1, ay1 = rect(a)
+    bx0, by0, bx1, by1 = rect(b)
+    inter = max(0, min(ax1, bx1) - max(ax0, bx0)) * max(0, min(ay1, by1) - max(ay0, by0))
+    union = a[2] * a[3] + b[2] * b[3] - inter
+    return inter / union if union > 0 else 0
+
+
+def tile_view(person, tile, args, rnd):
+    """What a detector running on tile reports for person, in tile coordinates, or None"""
+    tx, ty, ts = tile
+    px0, py0, px1, py1 = rect(person)
+    x0, y0 = max(px0, tx), max(py0, ty)
+    x1, y1 = min(px1, tx + ts), min(py1, ty + ts)
+    if x1 <= x0 or y1 <= y0:
+        return None
+    if (x1 - x0) * (y1 - y0) < args.min_visible * person[2] * person[3]:
+        return None
+    w, h = (x1 - x0) / ts, (y1 - y0) / ts
+    cx, cy = ((x0 + x1) / 2 - tx) / ts, ((y0 + y1) / 2 - ty) / ts
+    j = args.jitter
+    return (cx + rnd.gauss(0, j * w), cy + rnd.gauss(0, j * h), w * (1 + rnd.gauss(0, j)), h * (1 + rnd.gauss(0, j)),
+            rnd.uniform(0.6, 0.95))
+
+
+def make_scene(nb, rnd):
+    people = []
+    for _ in range(nb):
+        h = rnd.uniform(0.08, 0.5)
+        w = h * rnd.uniform(0.3, 0.5)
+        people.append((rnd.uniform(w / 2, 1 - w / 2), rnd.uniform(h / 2, 1 - h / 2), w, h))
+    return people
+
+
+def score(people, merged):
+    found = 0
+    free = list(merged)
+    for person in people:
+        best = max(free, key=lambda b: iou(person, b), default=None)
+        if best is not None and iou(person, best) >= 0.5:
+            found += 1
+            free.remove(best)
+    return found, len(free)
+
+
+def run_grid(lib, grid, nb_people, contain, args, rnd):
+    box_max = max(10, nb_people)
+    tiling = Tiling(lib, box_max, grid=grid, overlap=args.overlap, min_size=args.min_size, is_sweep=1,
+                    iou_thresh=0.5, contain_thresh=contain, cut_margin=0.02)
+    tiles = tiling.tiles()
+    found = extra = total = 0
+    merge_s = 0.0
+    pairs = 0
+    for _ in range(args.scenes):
+        people = make_scene(nb_people, rnd)
+        for i, tile in enumerate(tiles):
+            boxes = [b for b in (tile_view(p, tile, args, rnd) for p in people) if b][:box_max]
+            tiling.add(i, boxes)
+        nb = sum(tiling.ctx.box_nb[:tiling.ctx.tile_nb])
+        pairs += nb * (nb - 1) // 2
+        # tile_merge() only reads tile results, so it can be timed in a loop
+        start = time.perf_counter()
+        for _ in range(args.loops):
+            lib.tile_merge(ctypes.byref(tiling.ctx), len(tiling.out), tiling.out)
+        merge_s += time.perf_counter() - start
+        f, e = score(people, tiling.merge())
+        found += f
+        extra += e
+        total += nb_people
+    return found, extra, total, merge_s / (args.scenes * args.loops), pairs / args.scenes
+
+
+def call_overhead(lib, loops):
+    ctx = TileCtx(tile_nb=1)
+    start = time.perf_counter()
+    for _ in range(loops):
+        lib.tile_next(ctypes.byref(ctx))
+    return (time.perf_counter() - start) / loops
+
+
+def check(lib):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    def tiling(is_sweep=1):
+        return Tiling(lib, 10, grid=2, overlap=0.2, min_size=0.3, is_sweep=is_sweep, iou_thresh=0.5,
+                      contain_thresh=0.7, cut_margin=0.02)
+
+    t = tiling()
+    tiles = t.tiles()
+    expect('2x2 tiles cover field of view with overlap', abs(tiles[0][2] - 1 / 1.8) < 1e-5 and
+           abs(tiles[3][0] + tiles[3][2] - 1) < 1e-5 and tiles[1][0] < tiles[0][2])
+    expect('sweep waits for all tiles', [t.add(i, []) for i in range(4)] == [0, 0, 0, 1])
+    t = tiling(is_sweep=0)
+    expect('round robin merges after each tile', [t.add(i, []) for i in (0, 1)] == [1, 1])
+
+    # person whole in tile 0, cut at left border of tile 1
+    t = tiling()
+    size = tiles[0][2]
+    person = (0.47, 0.3, 0.08, 0.3)
+    views = [tile_view(person, tile, argparse.Namespace(min_visible=0.2, jitter=0), random.Random(0))
+             for tile in tiles]
+    for i, v in enumerate(views):
+        t.add(i, [v[:4] + (0.9 - 0.1 * i,)] if v else [])
+    merged = t.merge()
+    expect('person across vertical seam gives one box', len(merged) == 1 and iou(person, merged[0]) > 0.9)
+
+    # person wider than overlap, cut on both sides of the seam
+    t = tiling()
+    person = (0.5, 0.3, 0.3, 0.3)
+    for i, tile in enumerate(tiles):
+        v = tile_view(person, tile, argparse.Namespace(min_visible=0.2, jitter=0), random.Random(0))
+        t.add(i, [v[:4] + (0.8,)] if v else [])
+    merged = t.merge()
+    expect('person split by seam is merged back', len(merged) == 1 and iou(person, merged[0]) > 0.9)
+    expect('merged person is not cut anymore', merged and merged[0][5] == 0)
+
+    # two people side by side in overlap band
+    t = tiling()
+    a, b = (0.46, 0.7, 0.04, 0.2), (0.53, 0.7, 0.04, 0.2)
+    for i, tile in enumerate(tiles):
+        vs = [tile_view(p, tile, argparse.Namespace(min_visible=0.99, jitter=0), random.Random(0)) for p in (a, b)]
+        t.add(i, [v[:4] + (0.9,) for v in vs if v])
+    expect('neighbours in overlap band are kept apart', len(t.merge()) == 2)
+
+    # box touching frame border is not cut
+    t = tiling()
+    t.add(0, [(0.05, 0.5, 0.1, 0.2, 0.9)])
+    expect('frame border does not cut', t.merge()[0][5] == 0)
+    t = tiling()
+    t.add(0, [(0.95, 0.5, 0.1, 0.2, 0.9)])
+    expect('inner tile border cuts', t.merge()[0][5] == CUT_RIGHT)
+
+    return checker.ok()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run unit checks instead of benchmark')
+    parser.add_argument('--grid', type=int, action='append', help='grid size to run, may be repeated (default: 1 to 4)')
+    parser.add_argument('--people', default='2,10,40', help='comma separated people per scene (default: 2,10,40)')
+    parser.add_argument('--scenes', type=int, default=200, help='scenes per point (default: 200)')
+    parser.add_argument('--loops', type=int, default=20, help='merge calls timed per scene (default: 20)')
+    parser.add_argument('--overlap', type=float, default=0.2, help='NN_TILING_OVERLAP (default: 0.2)')
+    parser.add_argument('--min-size', type=float, default=0.309,
+                        help='smallest tile side, DK with IMX335 default (default: 0.309)')
+    parser.add_argument('--min-visible', type=float, default=0.3,
+                        help='part of a person a tile must see to detect it (default: 0.3)')
+    parser.add_argument('--jitter', type=float, default=0.02, help='relative box jitter (default: 0.02)')
+    hostbuild.add_arguments(parser)
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build_tiling(build)
+        if args.check:
+            sys.exit(0 if check(lib) else 1)
+
+        overhead = call_overhead(lib, 20000)
+        out = sys.stdout
+        out.write('%4s %5s %6s %-6s %7s %7s %10s %8s\n' % ('grid', 'tiles', 'people', 'merge', 'found', 'extra',
+                                                           'us/merge', 'pairs'))
+        for grid in args.grid or [1, 2, 3, 4]:
+            for nb_people in [int(v) for v in args.people.split(',')]:
+                for name, contain in (('tiles', 0.7), ('plain', 1.01)):
+                    rnd = random.Random(args.seed)
+                    found, extra, total, merge_s, pairs = run_grid(lib, grid, nb_people, contain, args, rnd)
+                    out.write('%4d %5d %6d %-6s %6.1f%% %7.2f %10.2f %8.0f\n' % (
+                        grid, grid * grid, nb_people, name, 100.0 * found / total, extra / args.scenes,
+                        max(0, merge_s - overhead) * 1e6, pairs))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Convert a trace dump printed by the application into a chrome trace json file.
+
+Build with USE_TRACE defined, send 'd' on the console and capture output until 'trc,end'. Open the result in
+chrome://tracing or https://ui.perfetto.dev.
+
+Example:
+    trace2chrome.py console.log -o trace.json
+"""
+
+import argparse
+import json
+import sys
+
+TYPE_BEGIN = 0
+TYPE_END = 1
+TYPE_INSTANT = 2
+TYPE_ASYNC_BEGIN = 3
+TYPE_ASYNC_END = 4
+
+# Cortex-M exception numbers below this one are system exceptions. Others are irq number + 16
+IRQ_EXCEPTION_BASE = 16
+SYSTEM_EXCEPTIONS = {
+    2: 'NMI', 3: 'HardFault', 4: 'MemManage', 5: 'BusFault', 6: 'UsageFault', 7: 'SecureFault',
+    11: 'SVCall', 12: 'DebugMonitor', 14: 'PendSV', 15: 'SysTick',
+}
+# Task handles are ram addresses, so any smaller value is an exception number
+MAX_EXCEPTION_NB = 512
+
+
+def ctx_name(ctx, tasks):
+    if ctx in tasks:
+        return tasks[ctx]
+    if ctx == 0:
+        return 'boot'
+    if ctx < MAX_EXCEPTION_NB:
+        if ctx < IRQ_EXCEPTION_BASE:
+            return 'isr %s' % SYSTEM_EXCEPTIONS.get(ctx, ctx)
+        return 'isr irq%d' % (ctx - IRQ_EXCEPTION_BASE)
+    return 'task %x' % ctx
+
+
+def parse_dumps(lines):
+    """Yield (cpu_hz, tasks, names, events) for each dump found in input"""
+    dump = None
+    for line in lines:
+        items = line.strip().split(',')
+        if len(items) < 2 or items[0] != 'trc':
+            continue
+        kind = items[1]
+        if kind == 'begin':
+            dump = {'cpu_hz': int(items[2]), 'tasks': {}, 'names': {}, 'events': []}
+        elif dump is None:
+            continue
+        elif kind == 'ctx':
+            dump['tasks'][int(items[2], 16)] = items[3]
+        elif kind == 'name':
+            dump['names'][int(items[2])] = items[3]
+        elif kind == 'evt':
+            dump['events'].append((int(items[2]), int(items[3], 16), int(items[4]), int(items[5]), int(items[6])))
+        elif kind == 'end':
+            yield dump
+            dump = None
+
+
+def convert(dump):
+    cpu_hz = dump['cpu_hz']
+    tasks = dump['tasks']
+    names = dump['names']
+    tids = {}
+    out = []
+    ts = 0
+    prev = None
+
+    for cycles, ctx, evt_id, evt_type, arg in dump['events']:
+        # DWT_CYCCNT is 32 bits. Records are almost ordered, so interpret delta as signed to unwrap it
+        if prev is not None:
+            delta = (cycles - prev) & 0xffffffff
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            ts += delta
+        prev = cycles
+
+        if ctx not in tids:
+            tids[ctx] = len(tids) + 1
+            out.append({'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': tids[ctx],
+                        'args': {'name': ctx_name(ctx, tasks)}})
+        evt = {
+            'name': names.get(evt_id, 'id%d' % evt_id),
+            'pid': 0,
+            'tid': tids[ctx],
+            'ts': ts * 1e6 / cpu_hz,
+        }
+        if evt_type == TYPE_BEGIN:
+            evt['ph'] = 'B'
+        elif evt_type == TYPE_END:
+            evt['ph'] = 'E'
+        elif evt_type == TYPE_INSTANT:
+            evt['ph'] = 'i'
+            evt['s'] = 't'
+            evt['args'] = {'arg': arg}
+        elif evt_type in (TYPE_ASYNC_BEGIN, TYPE_ASYNC_END):
+            evt['ph'] = 'b' if evt_type == TYPE_ASYNC_BEGIN else 'e'
+            evt['cat'] = 'async'
+            evt['id'] = evt_id
+        else:
+            continue
+        out.append(evt)
+
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('log', nargs='?', default='-', help='console log file, - for stdin (default)')
+    parser.add_argument('-o', '--output', default='-', help='output json file, - for stdout (default)')
+    parser.add_argument('--index', type=int, default=-1, help='dump to convert when log holds several (default: last)')
+    args = parser.parse_args()
+
+    lines = sys.stdin if args.log == '-' else open(args.log, 'r', errors='replace')
+    dumps = list(parse_dumps(lines))
+    if not dumps:
+        sys.exit('no complete trace dump found')
+
+    events = convert(dumps[args.index])
+    out = sys.stdout if args.output == '-' else open(args.output, 'w')
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, out)
+    if out is not sys.stdout:
+        out.close()
+        sys.stderr.write('%d events written to %s\n' % (len(events), args.output))
+
+
+if __name__ == '__main__':
+    main()
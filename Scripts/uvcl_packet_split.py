@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Check and show how Lib/screenl/uvcl/Src/uvcl_packet.c splits frames into usb iso packets.
+
+Lib/screenl/uvcl/Src/uvcl_packet.c is compiled with the host C compiler and driven through ctypes, the way usb stacks
+of uvcl drive it: get packet length, prepare packet, send it, restore frame bytes hidden by an in place header, move
+to next packet.
+
+--check sends frames whose size is an exact multiple of the packet payload, leaves a remainder, or fits in a single
+packet, with and without in place header. For each frame it checks that packets carry the frame bytes in order with
+the stream header in front, that no packet is longer than packet size, that only the last packet reports the end of
+frame, and that the frame is left unmodified.
+
+Default mode prints the split of the given frame sizes:
+    packets     packets per frame
+    last        length of last packet, header included
+    bounce      bytes copied into bounce buffer per frame with in place header, instead of whole frame without
+
+Examples:
+    uvcl_packet_split.py
+    uvcl_packet_split.py --check                 # unit checks, non zero exit on failure
+    uvcl_packet_split.py --packet-size 1023 --frame-size 153600,8000
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+
+import hostbuild
+
+# UVC_ISO_HS_MPS with 3 packets per micro frame, UVC_ISO_FS_MPS
+HS_PACKET_SIZE = 3 * 1024
+FS_PACKET_SIZE = 1023
+
+
+# Keep in sync with Lib/screenl/uvcl/Src/uvcl_packet.h
+class OnFlyCtx(ctypes.Structure):
+    _fields_ = [('frame_index', ctypes.c_int), ('cursor', ctypes.c_void_p), ('packet_nb', ctypes.c_int),
+                ('packet_index', ctypes.c_int), ('last_packet_size', ctypes.c_int), ('prev_len', ctypes.c_int),
+                ('p_frame', ctypes.c_void_p)]
+
+
+class PacketPatch(ctypes.Structure):
+    _fields_ = [('patched', ctypes.c_void_p), ('saved', ctypes.c_uint8 * 2)]
+
+
+def build_packet(build):
+    lib = build.lib('uvcl_packet', ['Lib/screenl/uvcl/Src/uvcl_packet.c'], includes=['Lib/screenl/uvcl/Src'])
+    lib.UVCL_PacketStart.argtypes = [ctypes.POINTER(OnFlyCtx), ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+    lib.UVCL_GetPacketLen.argtypes = [ctypes.POINTER(OnFlyCtx), ctypes.c_int]
+    lib.UVCL_PacketPrepare.argtypes = [ctypes.POINTER(OnFlyCtx), ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int,
+                                       ctypes.c_int, ctypes.POINTER(PacketPatch)]
+    lib.UVCL_PacketPrepare.restype = ctypes.c_void_p
+    lib.UVCL_PacketRestore.argtypes = [ctypes.POINTER(PacketPatch)]
+    lib.UVCL_PacketNext.argtypes = [ctypes.POINTER(OnFlyCtx), ctypes.c_int]
+    return lib
+
+
+def send_frame(lib, frame, packet_size, is_in_place, header=b'\x02\x01'):
+    """Send frame as usb stack does. Return list of (packet bytes, is in place, is last)"""
+    buf = ctypes.create_string_buffer(frame, len(frame))
+    bounce = ctypes.create_string_buffer(header, packet_size)
+    hdr = ctypes.create_string_buffer(header, 2)
+    ctx = OnFlyCtx()
+    patch = PacketPatch()
+    packets = []
+    lib.UVCL_PacketStart(ctypes.byref(ctx), buf, len(frame), packet_size)
+    for _ in range(len(frame) + 2):
+        length = lib.UVCL_GetPacketLen(ctypes.byref(ctx), packet_size)
+        addr = lib.UVCL_PacketPrepare(ctypes.byref(ctx), hdr, bounce, length, is_in_place, ctypes.byref(patch))
+        packets.append([ctypes.string_at(addr, length), addr != ctypes.addressof(bounce), False])
+        # packet is gone
+        lib.UVCL_PacketRestore(ctypes.byref(patch))
+        if lib.UVCL_PacketNext(ctypes.byref(ctx), length):
+            packets[-1][2] = True
+            break
+    return packets, buf.raw
+
+
+def check(lib, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    cases = []
+    for packet_size in (HS_PACKET_SIZE, FS_PACKET_SIZE, 8):
+        payload = packet_size - 2
+        cases += [('exact multiple', packet_size, payload * 7), ('remainder of one byte', packet_size, payload * 7 + 1),
+                  ('remainder', packet_size, payload * 7 + payload // 3), ('two packets', packet_size, payload + 1),
+                  ('single full packet', packet_size, payload), ('single short packet', packet_size, payload // 2),
+                  ('single byte', packet_size, 1)]
+
+    for is_in_place in (0, 1):
+        mode = 'in place' if is_in_place else 'bounce'
+        for name, packet_size, fsize in cases:
+            payload = packet_size - 2
+            frame = rnd.randbytes(fsize)
+            packets, after = send_frame(lib, frame, packet_size, is_in_place)
+            nb = -(-fsize // payload)
+            ok = len(packets) == nb and packets[-1][2] and not any(last for _, _, last in packets[:-1])
+            ok &= all(p[:2] == b'\x02\x01' and len(p) <= packet_size for p, _, _ in packets)
+            ok &= all(len(p) == packet_size for p, _, _ in packets[:-1])
+            ok &= b''.join(p[2:] for p, _, _ in packets) == frame
+            ok &= after == frame
+            # first and last packets always go through bounce buffer
+            in_place = [i for i, (_, is_frame, _) in enumerate(packets) if is_frame]
+            ok &= in_place == (list(range(1, nb - 1)) if is_in_place else [])
+            expect('%s %s, frame %d packet %d' % (mode, name, fsize, packet_size), ok)
+
+    # a frame started after an aborted one starts from its first packet
+    ctx = OnFlyCtx()
+    frame = ctypes.create_string_buffer(100)
+    lib.UVCL_PacketStart(ctypes.byref(ctx), frame, 100, 8)
+    lib.UVCL_PacketNext(ctypes.byref(ctx), 8)
+    lib.UVCL_PacketStart(ctypes.byref(ctx), frame, 100, 8)
+    expect('restart after abort begins at first packet', ctx.packet_index == 0 and ctx.cursor == ctx.p_frame)
+
+    return checker.ok()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run unit checks instead of printing split')
+    parser.add_argument('--packet-size', type=int, default=HS_PACKET_SIZE,
+                        help='iso packet size, header included (default: %d)' % HS_PACKET_SIZE)
+    parser.add_argument('--frame-size', default='614400,153600,20000',
+                        help='comma separated frame sizes in bytes (default: 614400,153600,20000)')
+    hostbuild.add_arguments(parser)
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build_packet(build)
+        if args.check:
+            sys.exit(0 if check(lib, args.seed) else 1)
+
+        out = sys.stdout
+        out.write('%10s %8s %8s %8s\n' % ('frame', 'packets', 'last', 'bounce'))
+        for fsize in [int(v) for v in args.frame_size.split(',')]:
+            packets, _ = send_frame(lib, bytes(fsize), args.packet_size, 1)
+            bounce = sum(len(p) - 2 for p, is_frame, _ in packets if not is_frame)
+            out.write('%10d %8d %8d %8d\n' % (fsize, len(packets), len(packets[-1][0]), bounce))
+
+
+if __name__ == '__main__':
+    main()
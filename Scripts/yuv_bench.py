@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Check and benchmark cpu composition and YUY2 conversion of the usb screen in Lib/screenl/Src/scrl_yuv.c.
+
+Lib/screenl/Src/scrl_yuv.c is compiled twice with the host C compiler, once with its vector path and once with its
+scalar lut path, and driven through ctypes. Both are compared against the two pass sequence they replace:
+    - a blend of the ARGB4444 overlay over the RGB565 frame into RGB565, as DMA2D does it, each channel being
+      (fg * a + bg * (255 - a)) / 255 on 8 bits values rounded to nearest, then truncated to RGB565,
+    - the lut converter from RGB565 to YUY2 that scrl_usb.c used before scrl_yuv.c.
+
+DMA2D rounding is not documented, so hardware may differ from the reference blend by one RGB565 lsb.
+
+SCRY_Rgb565ToYuv422() alone is compared against the lut converter and the largest deviation of each of Y, Cb and
+Cr is reported. Both paths use the same fixed point arithmetic, so it is expected to be 0.
+
+Benchmark columns:
+    ms/frame    host time to compose or convert one frame
+    Mpix/s      pixels composed per second
+
+Examples:
+    yuv_bench.py
+    yuv_bench.py --check                         # bit exactness checks, non zero exit on failure
+    yuv_bench.py --width 1280 --height 720
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+import time
+
+import hostbuild
+
+# Two pass reference: DMA2D blend model and lut converter removed from Lib/screenl/Src/scrl_usb.c
+REF_SRC = r'''
+#include <stdint.h>
+
+#define CLAMP(v, v_min, v_max) do { \
+  v = v < v_min ? v_min : v; \
+  v = v > v_max ? v_max : v; \
+} while (0)
+
+#define RGB_2_Y(r, g, b, y) do { \
+  y = SCRU_RED_Y_LUT[r] + SCRU_GREEN_Y_LUT[g] + SCRU_BLUE_Y_LUT[b]; \
+  CLAMP(y, 0, 255); \
+} while(0)
+
+#define RGB_2_CR(r, g, b, cr) do { \
+  cr = SCRU_BLUE_CB_RED_CR_LUT[r] + SCRU_GREEN_CR_LUT[g] + SCRU_BLUE_CR_LUT[b] + 128; \
+  CLAMP(cr, 0, 255); \
+} while(0)
+
+#define RGB_2_CB(r, g, b, cb) do { \
+  cb = SCRU_RED_CB_LUT[r] + SCRU_GREEN_CB_LUT[g] + SCRU_BLUE_CB_RED_CR_LUT[b] + 128; \
+  CLAMP(cb, 0, 255); \
+} while(0)
+
+static int32_t SCRU_RED_Y_LUT[256];
+static int32_t SCRU_RED_CB_LUT[256];
+static int32_t SCRU_BLUE_CB_RED_CR_LUT[256];
+static int32_t SCRU_GREEN_Y_LUT[256];
+static int32_t SCRU_GREEN_CR_LUT[256];
+static int32_t SCRU_GREEN_CB_LUT[256];
+static int32_t SCRU_BLUE_Y_LUT[256];
+static int32_t SCRU_BLUE_CR_LUT[256];
+
+static void SCRU_cvt_dual_pel_rgb_to_yuv(uint8_t *r, uint8_t *g, uint8_t *b, int32_t *y, int32_t *cb, int32_t *cr)
+{
+  uint8_t red, green, blue;
+
+  RGB_2_Y(r[0], g[0], b[0], y[0]);
+  RGB_2_Y(r[1], g[1], b[1], y[1]);
+
+  red = (r[0] + r[1] + 1) / 2;
+  green = (g[0] + g[1] + 1) / 2;
+  blue = (b[0] + b[1] + 1) / 2;
+
+  RGB_2_CR(red, green, blue, cr[0]);
+  RGB_2_CB(red, green, blue, cb[0]);
+}
+
+void REF_Init(void)
+{
+  int i;
+
+  for (i = 0; i <= 255; i++)
+  {
+    SCRU_RED_Y_LUT[i]           = ((  ((int32_t) ((0.299 )  * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_GREEN_Y_LUT[i]         = ((  ((int32_t) ((0.587 )  * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_BLUE_Y_LUT[i]          = ((  ((int32_t) ((0.114 )  * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_RED_CB_LUT[i]          = (((-((int32_t) ((0.1687 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_GREEN_CB_LUT[i]        = (((-((int32_t) ((0.3313 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_BLUE_CB_RED_CR_LUT[i]  = ((  ((int32_t) ((0.5 )    * (1L << 16)))  * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_GREEN_CR_LUT[i]        = (((-((int32_t) ((0.4187 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+    SCRU_BLUE_CR_LUT[i]         = (((-((int32_t) ((0.0813 ) * (1L << 16)))) * i) + ((int32_t) 1 << (16 - 1))) >> 16 ;
+  }
+}
+
+void REF_Rgb565ToYuv422(uint8_t *p_dst, uint8_t *p_src, int width, int height)
+{
+  uint32_t *p_src_dual_rgb565 = (uint32_t *)p_src;
+  int32_t luma[2];
+  int32_t cb, cr;
+  uint8_t b[2];
+  uint8_t g[2];
+  uint8_t r[2];
+  int x, y;
+
+  for (y = 0; y < height; y++)
+  {
+    for (x = 0; x < width; x += 2)
+    {
+      uint32_t p = p_src_dual_rgb565[x / 2];
+
+      b[0] = (p >> 0) & 0x1f;
+      b[0] = (b[0] << 3) | (b[0] >> 2);
+      g[0] = (p >> 5) & 0x3f;
+      g[0] = (g[0] << 2) | (g[0] >> 4);
+      r[0] = (p >> 11) & 0x1f;
+      r[0] = (r[0] << 3) | (r[0] >> 2);
+      b[1] = (p >> 16) & 0x1f;
+      b[1] = (b[1] << 3) | (b[1] >> 2);
+      g[1] = (p >> 21) & 0x3f;
+      g[1] = (g[1] << 2) | (g[1] >> 4);
+      r[1] = (p >> 27) & 0x1f;
+      r[1] = (r[1] << 3) | (r[1] >> 2);
+
+      SCRU_cvt_dual_pel_rgb_to_yuv(r, g, b, luma, &cb, &cr);
+      *p_dst++ = luma[0];
+      *p_dst++ = cb;
+      *p_dst++ = luma[1];
+      *p_dst++ = cr;
+    }
+    p_src_dual_rgb565 += width / 2;
+  }
+}
+
+static uint32_t blend_channel(uint32_t fg4, uint32_t a, uint32_t bg, int bits)
+{
+  uint32_t bg8 = (bg << (8 - bits)) | (bg >> (2 * bits - 8));
+
+  return ((fg4 * 17 * a + bg8 * (255 - a) + 127) / 255) >> (8 - bits);
+}
+
+/* DMA2D memory to memory with blending, ARGB4444 foreground over opaque RGB565 background into RGB565 */
+void REF_Dma2dBlend(uint16_t *dst, const uint16_t *bg, const uint16_t *fg, int nb)
+{
+  uint32_t a;
+  int i;
+
+  for (i = 0; i < nb; i++) {
+    a = (fg[i] >> 12) * 17;
+    dst[i] = (blend_channel((fg[i] >> 8) & 0xf, a, bg[i] >> 11, 5) << 11) |
+             (blend_channel((fg[i] >> 4) & 0xf, a, (bg[i] >> 5) & 0x3f, 6) << 5) |
+             blend_channel(fg[i] & 0xf, a, bg[i] & 0x1f, 5);
+  }
+}
+'''
+
+P, I = ctypes.c_void_p, ctypes.c_int
+PATHS = ('vector', 'scalar')
+
+
+def build_yuv(build):
+    """Return {path name: lib}. Reference functions are in each lib"""
+    libs = {}
+    for path in PATHS:
+        lib = build.lib('yuv_%s' % path, ['Lib/screenl/Src/scrl_yuv.c'],
+                        defines=['SCRY_USE_VECTOR=%d' % (path == 'vector')], code=REF_SRC)
+        lib.SCRY_Rgb565ToYuv422.argtypes = [P, P, I]
+        lib.SCRY_BlendToYuv422.argtypes = [P, P, P, I]
+        lib.REF_Rgb565ToYuv422.argtypes = [P, P, I, I]
+        lib.REF_Dma2dBlend.argtypes = [P, P, P, I]
+        lib.SCRY_Init()
+        lib.REF_Init()
+        libs[path] = lib
+    return libs
+
+
+def u16_buffer(values):
+    return (ctypes.c_uint16 * len(values))(*values)
+
+
+def two_pass(lib, bg, fg, width, height):
+    """DMA2D blend into frame then lut conversion, return YUY2 bytes"""
+    nb = width * height
+    blended = (ctypes.c_uint16 * nb)()
+    out = ctypes.create_string_buffer(nb * 2)
+    lib.REF_Dma2dBlend(blended, bg, fg, nb)
+    lib.REF_Rgb565ToYuv422(out, blended, width, height)
+    return out.raw
+
+
+def fused(lib, bg, fg, width, height):
+    nb = width * height
+    out = ctypes.create_string_buffer(nb * 2)
+    for y in range(height):
+        lib.SCRY_BlendToYuv422(ctypes.addressof(out) + y * width * 2, ctypes.addressof(bg) + y * width * 2,
+                               ctypes.addressof(fg) + y * width * 2, width)
+    return out.raw
+
+
+def max_deviation(a, b):
+    """Largest difference of Y, Cb and Cr between two YUY2 buffers"""
+    dev = [0, 0, 0]
+    for i, (va, vb) in enumerate(zip(a, b)):
+        c = (0, 1, 0, 2)[i % 4]
+        dev[c] = max(dev[c], abs(va - vb))
+    return dev
+
+
+def check(libs, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    # every background and every foreground value, the other layer random
+    all_values = list(range(65536))
+    shuffled = rnd.sample(all_values, len(all_values))
+    sets = {
+        'every bg': (all_values, shuffled),
+        'every fg': (shuffled, all_values),
+        'alpha 0 and 15 fg': (shuffled, [v & 0x0fff if v & 1 else v | 0xf000 for v in all_values]),
+    }
+    for path, lib in libs.items():
+        for name, (bg, fg) in sets.items():
+            bg, fg = u16_buffer(bg), u16_buffer(fg)
+            ref = two_pass(lib, bg, fg, 256, 256)
+            expect('%s blend %s matches two pass' % (path, name), fused(lib, bg, fg, 256, 256) == ref)
+        # odd pixel pair counts exercise the scalar tail of the vector path
+        ok = True
+        for width in range(2, 42, 2):
+            bg = u16_buffer([rnd.getrandbits(16) for _ in range(width * 3)])
+            fg = u16_buffer([rnd.getrandbits(16) for _ in range(width * 3)])
+            ok &= fused(lib, bg, fg, width, 3) == two_pass(lib, bg, fg, width, 3)
+        expect('%s blend widths 2 to 40 match two pass' % path, ok)
+
+        # every pixel as first and second of a pair, so chroma averages every pair of values from both sides
+        src = u16_buffer([v for pair in zip(all_values, shuffled) for v in pair] +
+                         [v for pair in zip(shuffled, all_values) for v in pair])
+        nb = len(src)
+        ref = ctypes.create_string_buffer(nb * 2)
+        out = ctypes.create_string_buffer(nb * 2)
+        lib.REF_Rgb565ToYuv422(ref, src, nb, 1)
+        lib.SCRY_Rgb565ToYuv422(out, src, nb)
+        dev = max_deviation(ref.raw, out.raw)
+        print('  %s max deviation from lut: y %d cb %d cr %d' % (path, *dev))
+        expect('%s convert every pixel matches lut' % path, dev == [0, 0, 0])
+        ok = True
+        for width in range(2, 42, 2):
+            src = u16_buffer([rnd.getrandbits(16) for _ in range(width)])
+            lib.REF_Rgb565ToYuv422(ref, src, width, 1)
+            lib.SCRY_Rgb565ToYuv422(out, src, width)
+            ok &= out.raw[:width * 2] == ref.raw[:width * 2]
+        expect('%s convert widths 2 to 40 match lut' % path, ok)
+        # usb screen converts its buffer in place
+        lib.SCRY_Rgb565ToYuv422(src, src, width)
+        expect('%s convert in place matches lut' % path, bytes(src) == ref.raw[:width * 2])
+
+    return checker.ok()
+
+
+def call_overhead(lib, loops):
+    buf = ctypes.create_string_buffer(4)
+    start = time.perf_counter()
+    for _ in range(loops):
+        lib.SCRY_Rgb565ToYuv422(buf, buf, 0)
+    return (time.perf_counter() - start) / loops
+
+
+def bench(fct, loops, overhead):
+    start = time.perf_counter()
+    for _ in range(loops):
+        fct()
+    return max(0, (time.perf_counter() - start) / loops - overhead)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run bit exactness checks instead of benchmark')
+    parser.add_argument('--width', type=int, default=640, help='frame width, even (default: 640)')
+    parser.add_argument('--height', type=int, default=480, help='frame height (default: 480)')
+    parser.add_argument('--loops', type=int, default=50, help='frames timed per method (default: 50)')
+    hostbuild.add_arguments(parser, cflags='-O2')
+    args = parser.parse_args()
+
+    with hostbuild.HostBuild(args.cc, args.cflags) as build:
+        libs = build_yuv(build)
+        if args.check:
+            sys.exit(0 if check(libs, args.seed) else 1)
+
+        rnd = random.Random(args.seed)
+        width, height = args.width, args.height
+        nb = width * height
+        bg = u16_buffer([rnd.getrandbits(16) for _ in range(nb)])
+        fg = u16_buffer([rnd.getrandbits(16) for _ in range(nb)])
+        blended = (ctypes.c_uint16 * nb)()
+        out = ctypes.create_string_buffer(nb * 2)
+        lib = libs['scalar']
+        overhead = call_overhead(lib, 20000)
+        lib.REF_Dma2dBlend(blended, bg, fg, nb)
+        # whole frame per call so ctypes overhead stays negligible
+        blend_s = bench(lambda: lib.REF_Dma2dBlend(blended, bg, fg, nb), args.loops, overhead)
+        lut_s = bench(lambda: lib.REF_Rgb565ToYuv422(out, blended, width, height), args.loops, overhead)
+        # speedup is given against two pass total and lut
+        groups = [
+            ('composition', blend_s + lut_s,
+             [('two pass blend', blend_s), ('two pass lut', lut_s), ('two pass total', blend_s + lut_s)] +
+             [('fused %s' % path, bench(lambda l=l: l.SCRY_BlendToYuv422(out, bg, fg, nb), args.loops, overhead))
+              for path, l in libs.items()]),
+            ('conversion', lut_s, [('lut', lut_s)] +
+             [('convert %s' % path, bench(lambda l=l: l.SCRY_Rgb565ToYuv422(out, blended, nb), args.loops, overhead))
+              for path, l in libs.items()]),
+        ]
+
+        sys.stdout.write('%dx%d frame\n' % (width, height))
+        for group, base_s, results in groups:
+            sys.stdout.write('%-16s %9s %9s %8s\n' % (group, 'ms/frame', 'Mpix/s', 'speedup'))
+            for name, s in results:
+                sys.stdout.write('%-16s %9.3f %9.1f %7.2fx\n' % (name, s * 1e3, nb / s / 1e6 if s else 0,
+                                                                 base_s / s if s else 0))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 STMicroelectronics.
+# All rights reserved.
+#
+# This software is licensed under terms that can be found in the LICENSE file
+# in the root directory of this software component.
+# If no LICENSE file comes with this software, it is provided AS-IS.
+#
+"""Replay nn input zoom of Src/zoom.c on host against synthetic scenes.
+
+Src/zoom.c is compiled with the host C compiler and driven through ctypes, so region selection and coordinate mapping
+are the ones running on target when USE_NN_ROI is defined. Each frame is captured with the region selected --lag
+results earlier. The nn detects the part of a person seen in the region when it is at least half of the person, with
+--jitter relative to the region, and detections are mapped back with zoom_remap() before zoom_update().
+
+Default mode replays a person walking across the field of view at each --speed, in field of view per result:
+    zoom        mean zoom level of frames captured with someone in the scene
+    cut         share of frames where someone is partly outside of the capture region
+    missed      share of frames where someone is not detected
+    moves       region changes, full field of view scans excluded
+    us/update   host time of one zoom_update() call, ctypes call overhead removed
+
+--check replays a walking person, a standing one with detection jitter, a group whose hull shrinks and a scene
+becoming empty, and checks that people are never cut, that jitter doesn't move the region, and that shrink, release
+and scans happen on the expected results.
+
+Examples:
+    zoom_sim.py
+    zoom_sim.py --check                          # replay checks, non zero exit on failure
+    zoom_sim.py --speed 0.01,0.04 --margin 0.1 --lag 2
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+import time
+
+import hostbuild
+
+FULL = (0.0, 0.0, 1.0)
+BOX_MAX = 64
+
+
+# Keep in sync with Inc/zoom.h
+class ZoomRoi(ctypes.Structure):
+    _fields_ = [('x', ctypes.c_float), ('y', ctypes.c_float), ('size', ctypes.c_float)]
+
+
+class ZoomBox(ctypes.Structure):
+    _fields_ = [('cx', ctypes.c_float), ('cy', ctypes.c_float), ('w', ctypes.c_float), ('h', ctypes.c_float)]
+
+
+class ZoomConf(ctypes.Structure):
+    _fields_ = [('margin', ctypes.c_float), ('min_size', ctypes.c_float), ('hysteresis', ctypes.c_float),
+                ('shrink_delay', ctypes.c_int), ('release_delay', ctypes.c_int), ('scan_period', ctypes.c_int)]
+
+
+class ZoomCtx(ctypes.Structure):
+    _fields_ = [('cfg', ZoomConf), ('roi', ZoomRoi), ('shrink_cnt', ctypes.c_int), ('empty_cnt', ctypes.c_int),
+                ('update_cnt', ctypes.c_int)]
+
+
+def build_zoom(build):
+    lib = build.lib('zoom', ['Src/zoom.c'], includes=['Inc'])
+    lib.zoom_init.argtypes = [ctypes.POINTER(ZoomCtx), ctypes.POINTER(ZoomConf)]
+    lib.zoom_update.argtypes = [ctypes.POINTER(ZoomCtx), ctypes.c_int, ctypes.POINTER(ZoomBox),
+                                ctypes.POINTER(ZoomRoi)]
+    lib.zoom_remap.argtypes = [ctypes.POINTER(ZoomRoi)] + [ctypes.POINTER(ctypes.c_float)] * 4
+    return lib
+
+
+def roi_tuple(roi):
+    return (roi.x, roi.y, roi.size)
+
+
+class Zoom:
+    def __init__(self, lib, **conf):
+        self.lib = lib
+        self.cfg = ZoomConf(**conf)
+        self.ctx = ZoomCtx()
+        self.boxes = (ZoomBox * BOX_MAX)()
+        self.out = ZoomRoi()
+        if lib.zoom_init(ctypes.byref(self.ctx), ctypes.byref(self.cfg)):
+            raise ValueError('invalid zoom configuration')
+
+    def update(self, boxes):
+        """Return (roi for next frames, roi kept by ctx)"""
+        for i, box in enumerate(boxes):
+            self.boxes[i] = ZoomBox(*box)
+        self.lib.zoom_update(ctypes.byref(self.ctx), len(boxes), self.boxes, ctypes.byref(self.out))
+        return roi_tuple(self.out), roi_tuple(self.ctx.roi)
+
+    def remap(self, roi, box):
+        v = [ctypes.c_float(c) for c in box]
+        self.lib.zoom_remap(ctypes.byref(ZoomRoi(*roi)), *[ctypes.byref(c) for c in v])
+        return tuple(c.value for c in v)
+
+
+def rect(box):
+    cx, cy, w, h = box
+    return cx - w / 2, cy - h / 2, cx + w / 2, cy + h / 2
+
+
+def is_inside(box, roi, eps=1e-6):
+    x0, y0, x1, y1 = rect(box)
+    return x0 >= roi[0] - eps and y0 >= roi[1] - eps and x1 <= roi[0] + roi[2] + eps and y1 <= roi[1] + roi[2] + eps
+
+
+def detect(person, roi, jitter, rnd):
+    """Box found by nn in a frame captured with roi, in roi coordinates, or None when missed"""
+    x0, y0, x1, y1 = rect(person)
+    vx0, vy0 = max(x0, roi[0]), max(y0, roi[1])
+    vx1, vy1 = min(x1, roi[0] + roi[2]), min(y1, roi[1] + roi[2])
+    if vx1 <= vx0 or vy1 <= vy0 or (vx1 - vx0) * (vy1 - vy0) < 0.5 * person[2] * person[3]:
+        return None
+    box = (((vx0 + vx1) / 2 - roi[0]) / roi[2], ((vy0 + vy1) / 2 - roi[1]) / roi[2], (vx1 - vx0) / roi[2],
+           (vy1 - vy0) / roi[2])
+    return tuple(v + rnd.gauss(0, jitter) * (1 if i < 2 else v) for i, v in enumerate(box))
+
+
+def replay(zoom, scene, lag, jitter, rnd):
+    """Run scene, a list of people boxes per frame. Return one (capture roi, people, found, next roi, ctx roi)
+    per frame"""
+    selected = [FULL] * lag
+    frames = []
+    for people in scene:
+        capture = selected[-lag]
+        found = [b for b in (detect(p, capture, jitter, rnd) for p in people) if b]
+        found = [zoom.remap(capture, b) for b in found]
+        roi, kept = zoom.update(found)
+        selected.append(roi)
+        frames.append((capture, people, found, roi, kept))
+    return frames
+
+
+def walk_scene(speed, person=(0.1, 0.55, 0.06, 0.2), end=0.9, empty=0):
+    """Person walking along x from person cx to end, then leaving for empty frames"""
+    scene = []
+    cx = person[0]
+    while cx <= end:
+        scene.append([(cx,) + person[1:]])
+        cx += speed
+    return scene + [[]] * empty
+
+
+def summary(frames):
+    busy = [f for f in frames if f[1]]
+    cut = sum(1 for capture, people, _, _, _ in busy if not all(is_inside(p, capture) for p in people))
+    missed = sum(1 for _, people, found, _, _ in busy if len(found) < len(people))
+    moves = sum(1 for prev, cur in zip(frames, frames[1:]) if prev[4] != cur[4])
+    zoom = sum(1 / f[0][2] for f in busy) / max(1, len(busy))
+    return zoom, cut / max(1, len(busy)), missed / max(1, len(busy)), moves
+
+
+def fit_size(box, conf):
+    """Side of region fitting a single box with its margin"""
+    return min(1, max(conf['min_size'], max(box[2], box[3]) * (1 + 2 * conf['margin'])))
+
+
+def changes(frames):
+    """Result indexes where ctx roi changed"""
+    return [i for i in range(1, len(frames)) if frames[i][4] != frames[i - 1][4]]
+
+
+def call_overhead(lib, loops):
+    # invalid configuration returns at once
+    ctx = ZoomCtx()
+    cfg = ZoomConf()
+    start = time.perf_counter()
+    for _ in range(loops):
+        lib.zoom_init(ctypes.byref(ctx), ctypes.byref(cfg))
+    return (time.perf_counter() - start) / loops
+
+
+def check(lib, conf, seed):
+    checker = hostbuild.Checker()
+    expect = checker.expect
+    rnd = random.Random(seed)
+    no_scan = dict(conf, scan_period=0)
+
+    # walking person at about one body width per 6 results, then scene becoming empty
+    speed, empty = 0.01, conf['release_delay'] + 10
+    frames = replay(Zoom(lib, **conf), walk_scene(speed, empty=empty), 1, 0.01, rnd)
+    zoom, cut, missed, _ = summary(frames)
+    expect('walking person is never cut', cut == 0)
+    expect('walking person is never missed', missed == 0)
+    expect('walking person is zoomed in', zoom > 0.8 / conf['min_size'] * (1 - 1 / conf['scan_period']))
+    expect('region stays inside field of view', all(r[0] >= 0 and r[1] >= 0 and r[0] + r[2] <= 1 + 1e-6 and
+                                                    r[1] + r[2] <= 1 + 1e-6 for f in frames for r in (f[3], f[4])))
+    scans = [i for i, f in enumerate(frames) if (i + 1) % conf['scan_period'] == 0]
+    expect('one result out of scan period requests full view', all(frames[i][3] == FULL for i in scans))
+    expect('scan keeps zoomed region', all(frames[i][4] != FULL for i in scans if frames[i][1] and
+                                           i >= conf['shrink_delay']))
+
+    # release: first empty result is first_empty, region is full on release_delay th empty result
+    first_empty = len(frames) - empty
+    release = changes(frames)[-1]
+    expect('region released after release delay', release == first_empty + conf['release_delay'] - 1 and
+           frames[-1][4] == FULL)
+
+    # standing person with detection jitter, region settles then doesn't move
+    scene = [[(0.3, 0.4, 0.08, 0.25)]] * 300
+    frames = replay(Zoom(lib, **no_scan), scene, 1, 0.01, rnd)
+    settled = conf['shrink_delay'] + 2
+    expect('detection jitter does not move region', not [i for i in changes(frames) if i > settled])
+    expect('standing person is zoomed in', abs(frames[-1][4][2] - fit_size(scene[0][0], conf)) < 0.02)
+
+    # group, then right person leaves: region shrinks on shrink_delay th result with the smaller hull only
+    left, right = (0.2, 0.5, 0.08, 0.25), (0.8, 0.5, 0.08, 0.25)
+    scene = [[left, right]] * 40 + [[left]] * 40
+    frames = replay(Zoom(lib, **no_scan), scene, 1, 0, rnd)
+    expect('group is zoomed out', frames[39][4][2] > 0.8)
+    expect('region shrinks after shrink delay', [i for i in changes(frames) if i >= 40] ==
+           [40 + conf['shrink_delay'] - 1] and abs(frames[-1][4][2] - fit_size(left, conf)) < 1e-6)
+
+    # hull shrinking less than hysteresis keeps region
+    big = (0.5, 0.5, 0.3, 0.6)
+    small = (0.5, 0.5, 0.3 * (1 - conf['hysteresis'] / 2), 0.6 * (1 - conf['hysteresis'] / 2))
+    frames = replay(Zoom(lib, **no_scan), [[big]] * 20 + [[small]] * 40, 1, 0, rnd)
+    expect('hull shrinking less than hysteresis keeps region', not [i for i in changes(frames) if i >= 20])
+
+    # person jumping out of region, region moves on next result, not after shrink delay
+    zoom = Zoom(lib, **no_scan)
+    for _ in range(20):
+        zoom.update([(0.2, 0.5, 0.08, 0.25)])
+    _, kept = zoom.update([(0.6, 0.5, 0.08, 0.25)])
+    expect('region follows person leaving it at once', is_inside((0.6, 0.5, 0.08, 0.25), kept))
+
+    # person walking away out of region, region moves without shrinking before shrink delay
+    zoom = Zoom(lib, **no_scan)
+    near, far = (0.3, 0.5, 0.1, 0.4), (0.8, 0.5, 0.05, 0.2)
+    for _ in range(20):
+        _, before = zoom.update([near])
+    _, kept = zoom.update([far])
+    expect('region moves without shrinking at once', is_inside(far, kept) and abs(kept[2] - before[2]) < 1e-6)
+
+    # remap brings boxes found in region back to full field of view
+    zoom = Zoom(lib, **conf)
+    ok = True
+    for _ in range(1000):
+        size = rnd.uniform(conf['min_size'], 1)
+        roi = (rnd.uniform(0, 1 - size), rnd.uniform(0, 1 - size), size)
+        person = (roi[0] + rnd.uniform(0.2, 0.8) * size, roi[1] + rnd.uniform(0.2, 0.8) * size, 0.1 * size, 0.2 * size)
+        box = zoom.remap(roi, detect(person, roi, 0, rnd))
+        ok &= all(abs(a - b) < 1e-5 for a, b in zip(box, person))
+    expect('remap inverts region crop on 1000 random regions', ok)
+
+    bad = [dict(conf, margin=-0.1), dict(conf, min_size=0), dict(conf, min_size=1.1), dict(conf, hysteresis=1),
+           dict(conf, shrink_delay=0), dict(conf, release_delay=0), dict(conf, scan_period=-1)]
+    refused = 0
+    for c in bad:
+        try:
+            Zoom(lib, **c)
+        except ValueError:
+            refused += 1
+    expect('invalid configurations are refused', refused == len(bad))
+
+    return checker.ok()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--check', action='store_true', help='run replay checks instead of walking person replay')
+    parser.add_argument('--speed', default='0.005,0.01,0.02,0.04',
+                        help='comma separated walking speeds, field of view per result (default: 0.005,0.01,0.02,0.04)')
+    parser.add_argument('--margin', type=float, default=0.25, help='NN_ROI_MARGIN (default: 0.25)')
+    parser.add_argument('--min-size', type=float, default=0.309,
+                        help='smallest region side, DK with IMX335 default (default: 0.309)')
+    parser.add_argument('--hysteresis', type=float, default=0.2, help='NN_ROI_HYSTERESIS (default: 0.2)')
+    parser.add_argument('--shrink-delay', type=int, default=10, help='NN_ROI_SHRINK_DELAY (default: 10)')
+    parser.add_argument('--release-delay', type=int, default=30, help='NN_ROI_RELEASE_DELAY (default: 30)')
+    parser.add_argument('--scan-period', type=int, default=8, help='NN_ROI_SCAN_PERIOD (default: 8)')
+    parser.add_argument('--lag', type=int, default=1,
+                        help='results between region selection and first frame captured with it (default: 1)')
+    parser.add_argument('--jitter', type=float, default=0.01, help='box jitter relative to region (default: 0.01)')
+    hostbuild.add_arguments(parser)
+    args = parser.parse_args()
+    conf = dict(margin=args.margin, min_size=args.min_size, hysteresis=args.hysteresis,
+                shrink_delay=args.shrink_delay, release_delay=args.release_delay, scan_period=args.scan_period)
+
+    with hostbuild.HostBuild(args.cc) as build:
+        lib = build_zoom(build)
+        if args.check:
+            sys.exit(0 if check(lib, conf, args.seed) else 1)
+
+        overhead = call_overhead(lib, 20000)
+        out = sys.stdout
+        out.write('%8s %6s %6s %7s %6s %10s\n' % ('speed', 'zoom', 'cut', 'missed', 'moves', 'us/update'))
+        for speed in [float(v) for v in args.speed.split(',')]:
+            frames = replay(Zoom(lib, **conf), walk_scene(speed), args.lag, args.jitter, random.Random(args.seed))
+            zoom_level, cut, missed, moves = summary(frames)
+            # time updates alone on the boxes of the replay
+            zoom = Zoom(lib, **conf)
+            start = time.perf_counter()
+            for f in frames:
+                zoom.update(f[2])
+            us = max(0, (time.perf_counter() - start) / len(frames) - overhead) * 1e6
+            out.write('%8.3f %6.2f %5.1f%% %6.1f%% %6d %10.2f\n' %
+                      (speed, zoom_level, 100 * cut, 100 * missed, moves, us))
+
+
+if __name__ == '__main__':
+    main()
@@ -18,11 +18,26 @@
 
 #include "app.h"
 
+#include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
+#include "app_bench.h"
 #include "app_cam.h"
 #include "app_config.h"
+#include "app_metadata.h"
+#include "app_nninput.h"
+#include "app_nnoutput.h"
+#include "app_nnprof.h"
 #include "app_postprocess.h"
+#include "app_text.h"
+#include "app_telemetry.h"
+#include "app_trace.h"
+#include "app_wcache.h"
+#include "overlay.h"
+#include "tiling.h"
+#include "zoom.h"
 #include "isp_api.h"
 #include "cmw_camera.h"
 #include "scrl.h"
@@ -40,6 +55,12 @@
 #ifdef TRACKER_MODULE
 #include "tracker.h"
 #endif
+#ifdef USE_GOVERNOR
+#include "governor.h"
+#endif
+#ifdef USE_NN_DEADLINE
+#include "deadline.h"
+#endif
 #include "network.h"
 #include "network_data.h"
 #include "utils.h"
@@ -61,24 +82,31 @@
 #error "max output buffer reached"
 #endif
 
-#define NN_OUT0_SIZE AI_NETWORK_OUT_1_SIZE_BYTES
+/* int8 outputs take one byte per element whatever generated output format is */
+#ifdef USE_NN_INT8_OUTPUT
+#define NN_OUT_SIZE(_n_) AI_NETWORK_OUT_##_n_##_SIZE
+#else
+#define NN_OUT_SIZE(_n_) AI_NETWORK_OUT_##_n_##_SIZE_BYTES
+#endif
+
+#define NN_OUT0_SIZE NN_OUT_SIZE(1)
 #define NN_OUT0_SIZE_ALIGN ALIGN_VALUE(NN_OUT0_SIZE, 32)
 #ifdef AI_NETWORK_OUT_2_SIZE_BYTES
-#define NN_OUT1_SIZE AI_NETWORK_OUT_2_SIZE_BYTES
+#define NN_OUT1_SIZE NN_OUT_SIZE(2)
 #define NN_OUT1_SIZE_ALIGN ALIGN_VALUE(NN_OUT1_SIZE, 32)
 #else
 #define NN_OUT1_SIZE 0
 #define NN_OUT1_SIZE_ALIGN 0
 #endif
 #ifdef AI_NETWORK_OUT_3_SIZE_BYTES
-#define NN_OUT2_SIZE AI_NETWORK_OUT_3_SIZE_BYTES
+#define NN_OUT2_SIZE NN_OUT_SIZE(3)
 #define NN_OUT2_SIZE_ALIGN ALIGN_VALUE(NN_OUT2_SIZE, 32)
 #else
 #define NN_OUT2_SIZE 0
 #define NN_OUT2_SIZE_ALIGN 0
 #endif
 #ifdef AI_NETWORK_OUT_4_SIZE_BYTES
-#define NN_OUT3_SIZE AI_NETWORK_OUT_4_SIZE_BYTES
+#define NN_OUT3_SIZE NN_OUT_SIZE(4)
 #define NN_OUT3_SIZE_ALIGN ALIGN_VALUE(NN_OUT3_SIZE, 32)
 #else
 #define NN_OUT3_SIZE 0
@@ -95,6 +123,27 @@
 #define CPU_LOAD_HISTORY_DEPTH 8
 
 #define DISPLAY_BUFFER_NB (DISPLAY_DELAY + 2)
+/* On usb output, compose next frame while previous one is still being sent */
+#ifdef SCR_LIB_USE_UVCL
+#define SCREEN_BUFFER_NB 2
+#else
+#define SCREEN_BUFFER_NB 1
+#endif
+/* jpeg frames are composed in a YUV422 buffer and encoded into smaller screen buffers */
+#if defined(SCR_LIB_USE_UVCL) && defined(USE_USB_JPEG)
+#define SCREEN_BUFFER_SIZE (LCD_BG_WIDTH * LCD_BG_HEIGHT)
+#else
+#define SCREEN_BUFFER_SIZE (LCD_BG_WIDTH * LCD_BG_HEIGHT * 2)
+#endif
+
+/* boxes outline (4 edges) and label + stats panel lines */
+#define OVERLAY_DIRTY_MAX (5 * AI_OD_PP_MAX_BOXES_LIMIT + 16)
+#define OVERLAY_TEXT_MAX 48
+#define OVERLAY_PANEL_LINE_NB 16
+#define OVERLAY_LABEL_LEN_MAX 12
+
+/* Must be a power of two so slot index stays continuous when sequence number wraps */
+#define SNAPSHOT_SLOT_NB 4
 
 /* Align so we are sure nn_output_buffers[0] and nn_output_buffers[1] are aligned on 32 bytes */
 #define NN_BUFFER_OUT_SIZE_ALIGN ALIGN_VALUE(NN_BUFFER_OUT_SIZE, 32)
@@ -119,13 +168,14 @@ typedef struct {
 } tbox_info;
 #endif
 
-typedef struct
-{
-  uint32_t X0;
-  uint32_t Y0;
-  uint32_t XSize;
-  uint32_t YSize;
-} Rectangle_TypeDef;
+/* Stats panel line as currently drawn into one foreground buffer. Only redrawn when its text changes or when
+ * something drawn over it has been erased.
+ */
+typedef struct {
+  int is_valid;
+  char text[OVERLAY_TEXT_MAX];
+  Rectangle_TypeDef area;
+} overlay_line_t;
 
 typedef struct {
   SemaphoreHandle_t free;
@@ -150,28 +200,67 @@ typedef struct {
   } history[CPU_LOAD_HISTORY_DEPTH];
 } cpuload_info_t;
 
+/* Single writer / multiple readers publication. Writer never blocks and fills the slot after the published
+ * one. Readers copy the published slot and retry only if writer wrapped around onto it in the meantime. Since
+ * writer never works on the slot being read, a higher priority reader can't livelock a preempted writer.
+ */
+typedef struct {
+  volatile uint32_t seq;
+  int slot_size;
+  uint8_t *slots[SNAPSHOT_SLOT_NB];
+} snapshot_t;
+
 typedef struct {
-  int32_t nb_detect;
-  od_pp_outBuffer_t detects[AI_OD_PP_MAX_BOXES_LIMIT];
-  int tracking_enabled;
+  int32_t nb;
+  int32_t nb_candidates; /* boxes above threshold before nms and max boxes cap */
+  od_pp_outBuffer_t boxes[AI_OD_PP_MAX_BOXES_LIMIT];
+} display_detects_t;
+
+typedef struct {
+  int is_enabled;
 #ifdef TRACKER_MODULE
-  int tboxes_valid_nb;
-  tbox_info tboxes[AI_OD_PP_MAX_BOXES_LIMIT];
+  int nb;
+  int nb_lost;
+  tbox_info boxes[AI_OD_PP_MAX_BOXES_LIMIT];
 #endif
-  uint32_t nn_period_ms;
-  uint32_t inf_ms;
-  uint32_t pp_ms;
-  uint32_t disp_ms;
+} display_tracks_t;
+
+/* Each field is a 32 bits word with a single writer thread, so no tearing is possible */
+typedef struct {
+  uint32_t nn_period_ms; /* nn thread */
+  uint32_t inf_ms;       /* nn thread */
+  uint32_t pp_ms;        /* pp thread */
+  uint32_t disp_ms;      /* dp thread */
+#ifdef USE_NN_DEADLINE
+  uint32_t nn_miss_nb;   /* nn thread */
+  uint32_t nn_error_nb;  /* nn thread */
+  uint32_t nn_worst_ms;  /* nn thread */
+#endif
+} display_timing_t;
+
+typedef struct {
+  display_detects_t detects;
+  display_tracks_t tracks;
+  display_timing_t timing;
 } display_info_t;
 
 typedef struct {
   SemaphoreHandle_t update;
   StaticSemaphore_t update_buffer;
-  SemaphoreHandle_t lock;
-  StaticSemaphore_t lock_buffer;
-  display_info_t info;
+  snapshot_t detects;
+  display_detects_t detects_slots[SNAPSHOT_SLOT_NB];
+  snapshot_t tracks;
+  display_tracks_t tracks_slots[SNAPSHOT_SLOT_NB];
+  volatile display_timing_t timing;
 } display_t;
 
+#ifdef APP_NN_CROP
+typedef struct {
+  zoom_roi_t roi;
+  int tile;                   /* tile index when tiling */
+} nn_crop_t;
+#endif
+
 /* Globals */
 DECLARE_CLASSES_TABLE;
 /* Lcd Background area */
@@ -200,27 +289,52 @@ static const uint32_t colors[NUMBER_COLORS] = {
     UTIL_LCD_COLOR_BLUE,
     UTIL_LCD_COLOR_ORANGE
 };
+/* Large buffers carry a mem_plan(lifetime) annotation read by Scripts/mem_report.py, which fails the build when a
+ * large buffer has none.
+ */
 /* Lcd Background Buffer */
+/* mem_plan(run): camera display pipe frames, rotate between dcmipp and display */
 static uint8_t lcd_bg_buffer[DISPLAY_BUFFER_NB][LCD_BG_WIDTH * LCD_BG_HEIGHT * 2] ALIGN_32 IN_PSRAM;
 static int lcd_bg_buffer_disp_idx = 1;
 static int lcd_bg_buffer_capt_idx = 0;
 /* Lcd Foreground Buffer */
+/* mem_plan(run): overlay double buffer, drawn by dp thread and composed by screen library */
 static uint8_t lcd_fg_buffer[2][LCD_FG_WIDTH * LCD_FG_HEIGHT* 2] ALIGN_32 IN_PSRAM;
 static int lcd_fg_buffer_rd_idx;
+/* areas drawn into each foreground buffer, cleared next time this buffer is drawn */
+static ovl_dirty_t lcd_fg_dirty[2];
+static Rectangle_TypeDef lcd_fg_dirty_rects[2][OVERLAY_DIRTY_MAX];
+static overlay_line_t lcd_fg_panel[2][OVERLAY_PANEL_LINE_NB];
+/* Overlay text */
+/* mem_plan(run): overlay glyph atlas, built at init */
+static uint16_t txt_atlas[TXT_ATLAS_PIXELS(TXT_FONT_WIDTH(LCD_FONT), TXT_FONT_HEIGHT(LCD_FONT))];
+/* mem_plan(run): overlay class labels, built at init */
+static uint16_t class_labels_pixels[NB_CLASSES][OVERLAY_LABEL_LEN_MAX * TXT_FONT_WIDTH(LCD_FONT) *
+                                                TXT_FONT_HEIGHT(LCD_FONT)];
+static TXT_Bitmap_t class_labels[NB_CLASSES];
 static display_t disp;
 static cpuload_info_t cpu_load;
 /* screen buffer */
-static uint8_t screen_buffer[LCD_BG_WIDTH * LCD_BG_HEIGHT * 2] ALIGN_32 IN_PSRAM;
+#ifndef APP_HEADLESS
+/* mem_plan(run, not in headless builds): composed frames sent to display */
+static uint8_t screen_buffer[SCREEN_BUFFER_NB][SCREEN_BUFFER_SIZE] ALIGN_32 IN_PSRAM;
+#if defined(SCR_LIB_USE_UVCL) && defined(USE_USB_JPEG)
+/* mem_plan(run, usb jpeg builds): YUV422 frame composed before jpeg encoding */
+static uint8_t composition_buffer[LCD_BG_WIDTH * LCD_BG_HEIGHT * 2] ALIGN_32 IN_PSRAM;
+#endif
+#endif
 
 /* model */
 //LL_ATON_DECLARE_NAMED_NN_INSTANCE_AND_INTERFACE(Default);
  /* nn input buffers */
+/* mem_plan(run): camera nn pipe frames, used in place as nn input tensor */
 static uint8_t nn_input_buffers[2][NN_WIDTH * NN_HEIGHT * NN_BPP] ALIGN_32 IN_PSRAM;
 static bqueue_t nn_input_queue;
  /* nn output buffers */
 static const uint32_t nn_out_len_user[NN_OUT_MAX_NB] = {
   NN_OUT0_SIZE, NN_OUT1_SIZE, NN_OUT2_SIZE, NN_OUT3_SIZE
 };
+/* mem_plan(run): nn output tensors, used in place as post process input */
 static uint8_t nn_output_buffers[2][NN_OUT_BUFFER_SIZE] ALIGN_32;
 static bqueue_t nn_output_queue;
 
@@ -235,6 +349,26 @@ static StaticTask_t isp_thread;
 static StackType_t isp_thread_stack[2 *configMINIMAL_STACK_SIZE];
 static SemaphoreHandle_t isp_sem;
 static StaticSemaphore_t isp_sem_buffer;
+#ifdef USE_GOVERNOR
+static StaticTask_t gov_thread;
+static StackType_t gov_thread_stack[2 *configMINIMAL_STACK_SIZE];
+#endif
+
+/* governor state */
+#ifdef USE_GOVERNOR
+static gov_ctx_t gov_ctx;
+static gov_setpoint_t gov_sp;
+static gov_presence_t gov_presence;
+static cpuload_info_t gov_cpu_load;
+#endif
+
+/* nn deadline state */
+#ifdef USE_NN_DEADLINE
+static dl_ctx_t dl_ctx;
+/* degraded mode settings, written by nn thread from nn_deadline_degrade() */
+static volatile uint32_t nn_deadline_period_ms;
+static volatile float nn_deadline_conf_min;
+#endif
 
 /* tracking state */
 #ifdef TRACKER_MODULE
@@ -243,6 +377,34 @@ static trk_dbox_t dboxes[AI_OD_PP_MAX_BOXES_LIMIT];
 static trk_ctx_t trk_ctx;
 #endif
 
+/* nn crop state */
+#ifdef APP_NN_CROP
+/* crop handed over to nn pipe frame event, with irq masked */
+static nn_crop_t nn_crop_next;
+static int nn_crop_pending;
+/* buffer dcmipp is writing and crop it is captured with */
+static uint8_t *nn_crop_capture_buffer;
+static nn_crop_t nn_crop_capture;
+/* crop each buffer content was captured with */
+static nn_crop_t nn_input_crop[2];
+static nn_crop_t nn_output_crop[2];
+#endif
+#ifdef USE_NN_ROI
+static zoom_ctx_t zoom_ctx;
+static zoom_box_t zoom_boxes[2 * AI_OD_PP_MAX_BOXES_LIMIT];
+/* last roi selected by pp thread. Only touched by pp thread */
+static zoom_roi_t nn_roi_selected;
+#endif
+#ifdef USE_NN_TILING
+static tile_ctx_t tile_ctx;
+/* latest boxes of each tile, merge scratch, tile result being added and merged result */
+static tile_box_t tile_boxes[NN_TILING_GRID * NN_TILING_GRID * AI_OD_PP_MAX_BOXES_LIMIT];
+static tile_box_t tile_work[NN_TILING_GRID * NN_TILING_GRID * AI_OD_PP_MAX_BOXES_LIMIT];
+static tile_box_t tile_in[AI_OD_PP_MAX_BOXES_LIMIT];
+static tile_box_t tile_merged[AI_OD_PP_MAX_BOXES_LIMIT];
+static od_pp_outBuffer_t tile_out[AI_OD_PP_MAX_BOXES_LIMIT];
+#endif
+
 static int is_cache_enable()
 {
 #if defined(USE_DCACHE)
@@ -287,6 +449,54 @@ static void cpuload_get_info(cpuload_info_t *cpu_load, float *cpu_load_last, flo
                      (cpu_load->history[2].total - cpu_load->history[7].total);
 }
 
+static void snapshot_init(snapshot_t *snap, int slot_size, uint8_t *slots)
+{
+  int i;
+
+  snap->seq = 0;
+  snap->slot_size = slot_size;
+  for (i = 0; i < SNAPSHOT_SLOT_NB; i++)
+    snap->slots[i] = slots + i * slot_size;
+}
+
+static void *snapshot_write_begin(snapshot_t *snap)
+{
+  return snap->slots[(snap->seq + 1) % SNAPSHOT_SLOT_NB];
+}
+
+static void snapshot_write_end(snapshot_t *snap)
+{
+  /* slot content must be visible before new sequence number */
+  __DMB();
+  snap->seq = snap->seq + 1;
+}
+
+static void snapshot_read(snapshot_t *snap, void *dst)
+{
+  uint32_t seq;
+
+  do {
+    seq = snap->seq;
+    __DMB();
+    memcpy(dst, snap->slots[seq % SNAPSHOT_SLOT_NB], snap->slot_size);
+    __DMB();
+    /* writer only touches slot seq % SNAPSHOT_SLOT_NB once it has published SNAPSHOT_SLOT_NB - 1 more slots */
+  } while (snap->seq - seq >= SNAPSHOT_SLOT_NB - 1);
+}
+
+static void display_timing_read(display_timing_t *timing)
+{
+  timing->nn_period_ms = disp.timing.nn_period_ms;
+  timing->inf_ms = disp.timing.inf_ms;
+  timing->pp_ms = disp.timing.pp_ms;
+  timing->disp_ms = disp.timing.disp_ms;
+#ifdef USE_NN_DEADLINE
+  timing->nn_miss_nb = disp.timing.nn_miss_nb;
+  timing->nn_error_nb = disp.timing.nn_error_nb;
+  timing->nn_worst_ms = disp.timing.nn_worst_ms;
+#endif
+}
+
 static int bqueue_init(bqueue_t *bq, int buffer_nb, uint8_t **buffers)
 {
   int i;
@@ -340,6 +550,13 @@ static void bqueue_put_free(bqueue_t *bq)
   assert(ret == pdTRUE);
 }
 
+/* Give back last buffer returned by bqueue_get_free() without publishing it. Only valid with a single producer */
+static void bqueue_unget_free(bqueue_t *bq)
+{
+  bq->free_idx = (bq->free_idx + bq->buffer_nb - 1) % bq->buffer_nb;
+  bqueue_put_free(bq);
+}
+
 static uint8_t *bqueue_get_ready(bqueue_t *bq)
 {
   uint8_t *res;
@@ -369,6 +586,16 @@ static void bqueue_put_ready(bqueue_t *bq)
   }
 }
 
+#ifdef USE_GOVERNOR
+static void gov_get_setpoint(gov_setpoint_t *sp)
+{
+  taskENTER_CRITICAL();
+  *sp = gov_sp;
+  taskEXIT_CRITICAL();
+}
+#endif
+
+#ifndef APP_HEADLESS
 static void reload_bg_layer(int next_disp_idx)
 {
   int ret;
@@ -381,6 +608,7 @@ static void reload_bg_layer(int next_disp_idx)
   ret = SRCL_Update();
   assert(ret == 0);
 }
+#endif
 
 static void app_main_pipe_frame_event()
 {
@@ -392,22 +620,68 @@ static void app_main_pipe_frame_event()
                                          DCMIPP_MEMORY_ADDRESS_0, (uint32_t) lcd_bg_buffer[next_capt_idx]);
   assert(ret == HAL_OK);
 
+#ifndef APP_HEADLESS
   reload_bg_layer(next_disp_idx);
+#endif
   lcd_bg_buffer_disp_idx = next_disp_idx;
   lcd_bg_buffer_capt_idx = next_capt_idx;
 }
 
+#ifdef APP_NN_CROP
+static int nn_input_idx(uint8_t *buffer)
+{
+  return (buffer - nn_input_buffers[0]) / sizeof(nn_input_buffers[0]);
+}
+
+static int nn_output_idx(uint8_t *buffer)
+{
+  return (buffer - nn_output_buffers[0]) / sizeof(nn_output_buffers[0]);
+}
+
+/* Tag frame just captured with its crop and apply next crop. Like memory address, crop and downsize registers are
+ * shadowed by dcmipp so they take effect at next frame start. next_buffer is NULL when frame is dropped, dcmipp then
+ * writes next frame into same buffer.
+ */
+static void nn_crop_frame_event(uint8_t *next_buffer)
+{
+  nn_input_crop[nn_input_idx(nn_crop_capture_buffer)] = nn_crop_capture;
+#ifdef USE_NN_TILING
+  /* move to next tile once frame is queued. A dropped frame is captured again on same tile */
+  if (next_buffer) {
+    nn_crop_next.tile = tile_next(&tile_ctx);
+    nn_crop_next.roi = tile_ctx.tiles[nn_crop_next.tile];
+    nn_crop_pending = nn_crop_next.tile != nn_crop_capture.tile;
+  }
+#endif
+  if (next_buffer)
+    nn_crop_capture_buffer = next_buffer;
+  if (!nn_crop_pending)
+    return;
+
+  nn_crop_capture = nn_crop_next;
+  nn_crop_pending = 0;
+  CAM_NNPipe_SetRoi(&nn_crop_capture.roi);
+}
+#endif
+
 static void app_ancillary_pipe_frame_event()
 {
   uint8_t *next_buffer;
   int ret;
 
+  BENCH_FrameCaptured();
   next_buffer = bqueue_get_free(&nn_input_queue, 0);
+#ifdef APP_NN_CROP
+  nn_crop_frame_event(next_buffer);
+#endif
   if (next_buffer) {
     ret = HAL_DCMIPP_PIPE_SetMemoryAddress(CMW_CAMERA_GetDCMIPPHandle(), DCMIPP_PIPE2,
                                            DCMIPP_MEMORY_ADDRESS_0, (uint32_t) next_buffer);
     assert(ret == HAL_OK);
     bqueue_put_ready(&nn_input_queue);
+  } else {
+    TRACE_INSTANT(TRC_ID_NN_FRAME_DROP, 0);
+    BENCH_QueueDrop(BENCH_QUEUE_NN_INPUT);
   }
 }
 
@@ -450,88 +724,293 @@ static void convert_point(float32_t xi, float32_t yi, int *xo, int *yo)
   *yo = (int) (lcd_bg_area.YSize * yi);
 }
 
-static void Display_Detection(od_pp_outBuffer_t *detect)
+static void overlay_dirty_add(int x, int y, int w, int h)
+{
+  ovl_dirty_add(&lcd_fg_dirty[lcd_fg_buffer_rd_idx], x, y, w, h);
+}
+
+/* Boxes may be drawn by DMA2D while text is written by cpu. Invalidate so no stale line is ever written back over
+ * DMA2D output.
+ */
+static void overlay_clean_rect(uint8_t *buffer, Rectangle_TypeDef *r)
+{
+  uint32_t offset;
+  int row = 0;
+  int len;
+
+  while ((len = ovl_range_next(r, lcd_fg_area.XSize, &row, &offset)))
+    SCB_CleanInvalidateDCache_by_Addr(buffer + offset, len);
+}
+
+/* Erase what was drawn last time into foreground buffer lcd_fg_buffer_rd_idx and restart area tracking */
+static void overlay_clear()
+{
+  ovl_dirty_t *dirty = &lcd_fg_dirty[lcd_fg_buffer_rd_idx];
+  overlay_line_t *panel = lcd_fg_panel[lcd_fg_buffer_rd_idx];
+  uint8_t *buffer = lcd_fg_buffer[lcd_fg_buffer_rd_idx];
+  Rectangle_TypeDef *r;
+  int i, j;
+
+  if (dirty->is_overflow) {
+    UTIL_LCD_FillRect(lcd_fg_area.X0, lcd_fg_area.Y0, lcd_fg_area.XSize, lcd_fg_area.YSize, 0x00000000);
+    CACHE_OP(SCB_CleanInvalidateDCache_by_Addr(buffer, LCD_FG_WIDTH * LCD_FG_HEIGHT * 2));
+    for (j = 0; j < OVERLAY_PANEL_LINE_NB; j++)
+      panel[j].is_valid = 0;
+  } else {
+    for (i = 0; i < dirty->nb; i++) {
+      r = &dirty->rects[i];
+      UTIL_LCD_FillRect(r->X0, r->Y0, r->XSize, r->YSize, 0x00000000);
+      CACHE_OP(overlay_clean_rect(buffer, r));
+      /* box or label drawn over a panel line has just erased part of it. Forget its text so it is redrawn */
+      for (j = 0; j < OVERLAY_PANEL_LINE_NB; j++)
+        if (panel[j].is_valid && ovl_is_overlapping(r, &panel[j].area))
+          panel[j].text[0] = '\0';
+    }
+  }
+
+  ovl_dirty_reset(dirty);
+}
+
+/* Write back areas drawn since overlay_clear() so display hw sees them */
+static void overlay_clean()
+{
+  ovl_dirty_t *dirty = &lcd_fg_dirty[lcd_fg_buffer_rd_idx];
+  uint8_t *buffer = lcd_fg_buffer[lcd_fg_buffer_rd_idx];
+  int i;
+
+  if (dirty->is_overflow) {
+    CACHE_OP(SCB_CleanInvalidateDCache_by_Addr(buffer, LCD_FG_WIDTH * LCD_FG_HEIGHT * 2));
+    return;
+  }
+
+  for (i = 0; i < dirty->nb; i++)
+    CACHE_OP(overlay_clean_rect(buffer, &dirty->rects[i]));
+}
+
+static void overlay_draw_rect(int x, int y, int w, int h, uint32_t color)
+{
+  if (w <= 0 || h <= 0)
+    return;
+
+  UTIL_LCD_DrawRect(x, y, w, h, color);
+  overlay_dirty_add(x, y, w, 1);
+  overlay_dirty_add(x, y + h - 1, w, 1);
+  overlay_dirty_add(x, y, 1, h);
+  overlay_dirty_add(x + w - 1, y, 1, h);
+}
+
+static void overlay_draw_text(int x, int y, const char *text)
+{
+  uint16_t *fb = (uint16_t *) lcd_fg_buffer[lcd_fg_buffer_rd_idx];
+  int w;
+
+  w = TXT_DrawString(fb, lcd_fg_area.XSize, lcd_fg_area.YSize, x, y, text);
+  overlay_dirty_add(x, y, w, TXT_GetGlyphHeight());
+}
+
+static void overlay_draw_label(int x, int y, TXT_Bitmap_t *label)
+{
+  uint16_t *fb = (uint16_t *) lcd_fg_buffer[lcd_fg_buffer_rd_idx];
+  int w;
+
+  w = TXT_DrawBitmap(fb, lcd_fg_area.XSize, lcd_fg_area.YSize, x, y, label);
+  overlay_dirty_add(x, y, w, label->height);
+}
+
+/* Right aligned stats panel line. Only touch frame buffer if text differs from what this buffer already shows. Line
+ * is written back right away since boxes are drawn over the panel by DMA2D afterwards.
+ */
+static void overlay_panel_printf(int line_nb, const char *format, ...)
+{
+  overlay_line_t *line = &lcd_fg_panel[lcd_fg_buffer_rd_idx][line_nb];
+  uint8_t *buffer = lcd_fg_buffer[lcd_fg_buffer_rd_idx];
+  const int glyph_w = TXT_GetGlyphWidth();
+  const int glyph_h = TXT_GetGlyphHeight();
+  char text[OVERLAY_TEXT_MAX];
+  va_list args;
+  int len;
+  int x;
+
+  assert(line_nb < OVERLAY_PANEL_LINE_NB);
+  va_start(args, format);
+  len = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (len < 0)
+    return;
+  len = MIN(len, (int) sizeof(text) - 1);
+
+  if (line->is_valid && strcmp(line->text, text) == 0)
+    return;
+
+  /* erase previous text */
+  if (line->is_valid) {
+    UTIL_LCD_FillRect(line->area.X0, line->area.Y0, line->area.XSize, line->area.YSize, 0x00000000);
+    CACHE_OP(overlay_clean_rect(buffer, &line->area));
+  }
+
+  /* same placement as UTIL_LCD_DisplayStringAt() in RIGHT_MODE */
+  x = MAX(((int) lcd_fg_area.XSize / glyph_w - len) * glyph_w, 1);
+  line->area.X0 = x;
+  line->area.Y0 = line_nb * glyph_h;
+  line->area.XSize = TXT_DrawString((uint16_t *) buffer, lcd_fg_area.XSize, lcd_fg_area.YSize, x, line->area.Y0, text);
+  line->area.YSize = MIN(glyph_h, (int) lcd_fg_area.YSize - (int) line->area.Y0);
+  strcpy(line->text, text);
+  line->is_valid = 1;
+  if (line->area.XSize && line->area.YSize > 0)
+    CACHE_OP(overlay_clean_rect(buffer, &line->area));
+}
+
+/* Same output as "%3d" without going through vsnprintf() */
+static void overlay_format_id(uint32_t id, char *text)
+{
+  char digits[10];
+  int nb = 0;
+  int i = 0;
+
+  do {
+    digits[nb++] = '0' + id % 10;
+    id /= 10;
+  } while (id);
+  for (; i < 3 - nb; i++)
+    text[i] = ' ';
+  while (nb)
+    text[i++] = digits[--nb];
+  text[i] = '\0';
+}
+
+static void overlay_text_init()
+{
+  int ret;
+  int i;
+
+  ret = TXT_Init(&LCD_FONT, UTIL_LCD_COLOR_WHITE, UTIL_LCD_COLOR_TRANSPARENT, txt_atlas, ARRAY_NB(txt_atlas));
+  assert(ret == 0);
+
+  /* class labels never change so render them once */
+  for (i = 0; i < NB_CLASSES; i++) {
+    ret = TXT_RenderString(classes_table[i], &class_labels[i], class_labels_pixels[i],
+                           ARRAY_NB(class_labels_pixels[i]));
+    assert(ret == 0);
+  }
+}
+
+static void Display_DetectionArea(od_pp_outBuffer_t *detect, int *x0, int *y0, int *x1, int *y1)
 {
   int xc, yc;
-  int x0, y0;
-  int x1, y1;
   int w, h;
 
   convert_point(detect->x_center, detect->y_center, &xc, &yc);
   convert_length(detect->width, detect->height, &w, &h);
-  x0 = xc - (w + 1) / 2;
-  y0 = yc - (h + 1) / 2;
-  x1 = xc + (w + 1) / 2;
-  y1 = yc + (h + 1) / 2;
-  clamp_point(&x0, &y0);
-  clamp_point(&x1, &y1);
+  *x0 = xc - (w + 1) / 2;
+  *y0 = yc - (h + 1) / 2;
+  *x1 = xc + (w + 1) / 2;
+  *y1 = yc + (h + 1) / 2;
+  clamp_point(x0, y0);
+  clamp_point(x1, y1);
+}
+
+static void Display_Detection(od_pp_outBuffer_t *detect)
+{
+  int x0, y0;
+  int x1, y1;
+
+  Display_DetectionArea(detect, &x0, &y0, &x1, &y1);
+  overlay_draw_rect(x0, y0, x1 - x0, y1 - y0, colors[detect->class_index % NUMBER_COLORS]);
+}
+
+static void Display_DetectionLabel(od_pp_outBuffer_t *detect)
+{
+  int x0, y0;
+  int x1, y1;
+
+  Display_DetectionArea(detect, &x0, &y0, &x1, &y1);
+  overlay_draw_label(x0 + 1, y0 + 1, &class_labels[detect->class_index]);
+}
 
-  UTIL_LCD_DrawRect(x0, y0, x1 - x0, y1 - y0, colors[detect->class_index % NUMBER_COLORS]);
-  UTIL_LCDEx_PrintfAt(x0 + 1, y0 + 1, LEFT_MODE, classes_table[detect->class_index]);
+#ifdef USE_NN_DEADLINE
+/* Deadline misses, failed inferences included, and worst inference time */
+static int Display_DeadlineStats(display_info_t *info, int line_nb)
+{
+  line_nb += 1;
+  overlay_panel_printf(line_nb, "Late/failed");
+  line_nb += 1;
+  overlay_panel_printf(line_nb, "   %u/%u", info->timing.nn_miss_nb, info->timing.nn_error_nb);
+  line_nb += 1;
+  overlay_panel_printf(line_nb, "Worst");
+  line_nb += 1;
+  overlay_panel_printf(line_nb, "   %ums", info->timing.nn_worst_ms);
+  line_nb += 1;
+
+  return line_nb;
 }
+#endif
 
 static void Display_NetworkOutput_NoTracking(display_info_t *info)
 {
-  od_pp_outBuffer_t *rois = info->detects;
-  uint32_t nb_rois = info->nb_detect;
+  od_pp_outBuffer_t *rois = info->detects.boxes;
+  uint32_t nb_rois = info->detects.nb;
   float cpu_load_one_second;
   int line_nb = 0;
   float nn_fps;
   int i;
 
-  /* clear previous ui */
-  UTIL_LCD_FillRect(lcd_fg_area.X0, lcd_fg_area.Y0, lcd_fg_area.XSize, lcd_fg_area.YSize, 0x00000000); /* Clear previous boxes */
-
   /* cpu load */
   cpuload_update(&cpu_load);
   cpuload_get_info(&cpu_load, NULL, &cpu_load_one_second, NULL);
 
   /* draw metrics */
-  nn_fps = 1000.0 / info->nn_period_ms;
+  nn_fps = 1000.0 / info->timing.nn_period_ms;
 #if 1
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "Cpu load");
+  overlay_panel_printf(line_nb, "Cpu load");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "   %.1f%%", cpu_load_one_second);
+  overlay_panel_printf(line_nb, "   %.1f%%", cpu_load_one_second);
   line_nb += 2;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Inference");
+  overlay_panel_printf(line_nb, "Inference");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->inf_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.inf_ms);
   line_nb += 2;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   FPS");
+  overlay_panel_printf(line_nb, "   FPS");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "  %.2f", nn_fps);
+  overlay_panel_printf(line_nb, "  %.2f", nn_fps);
   line_nb += 2;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, " Objects %u", nb_rois);
+  overlay_panel_printf(line_nb, " Objects %u", nb_rois);
   line_nb += 1;
+#ifdef USE_NN_DEADLINE
+  line_nb = Display_DeadlineStats(info, line_nb);
+#endif
 #else
   (void) nn_fps;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "Cpu load");
+  overlay_panel_printf(line_nb, "Cpu load");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "   %.1f%%", cpu_load_one_second);
+  overlay_panel_printf(line_nb, "   %.1f%%", cpu_load_one_second);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "nn period");
+  overlay_panel_printf(line_nb, "nn period");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->nn_period_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.nn_period_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Inference");
+  overlay_panel_printf(line_nb, "Inference");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->inf_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.inf_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Post process");
+  overlay_panel_printf(line_nb, "Post process");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->pp_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.pp_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Display");
+  overlay_panel_printf(line_nb, "Display");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->disp_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.disp_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, " Objects %u", nb_rois);
+  overlay_panel_printf(line_nb, " Objects %u", nb_rois);
   line_nb += 1;
 #endif
 
-  /* Draw bounding boxes */
+  /* Panel lines were written back as soon as drawn. Draw all boxes before labels so cpu only fetches label cache
+   * lines once DMA2D output is in memory, and no dirty line is left over an area DMA2D writes afterwards.
+   */
   for (i = 0; i < nb_rois; i++)
     Display_Detection(&rois[i]);
+  for (i = 0; i < nb_rois; i++)
+    Display_DetectionLabel(&rois[i]);
 }
 
 static int model_get_output_nb(const LL_Buffer_InfoTypeDef *nn_out_info)
@@ -547,24 +1026,39 @@ static int model_get_output_nb(const LL_Buffer_InfoTypeDef *nn_out_info)
 }
 
 #ifdef TRACKER_MODULE
-static void Display_TrackingBox(tbox_info *tbox)
+static void Display_TrackingArea(tbox_info *tbox, int *x0, int *y0, int *x1, int *y1)
 {
   int xc, yc;
-  int x0, y0;
-  int x1, y1;
   int w, h;
 
   convert_point(tbox->cx, tbox->cy, &xc, &yc);
   convert_length(tbox->w, tbox->h, &w, &h);
-  x0 = xc - (w + 1) / 2;
-  y0 = yc - (h + 1) / 2;
-  x1 = xc + (w + 1) / 2;
-  y1 = yc + (h + 1) / 2;
-  clamp_point(&x0, &y0);
-  clamp_point(&x1, &y1);
+  *x0 = xc - (w + 1) / 2;
+  *y0 = yc - (h + 1) / 2;
+  *x1 = xc + (w + 1) / 2;
+  *y1 = yc + (h + 1) / 2;
+  clamp_point(x0, y0);
+  clamp_point(x1, y1);
+}
+
+static void Display_TrackingBox(tbox_info *tbox)
+{
+  int x0, y0;
+  int x1, y1;
+
+  Display_TrackingArea(tbox, &x0, &y0, &x1, &y1);
+  overlay_draw_rect(x0, y0, x1 - x0, y1 - y0, colors[tbox->id % NUMBER_COLORS]);
+}
 
-  UTIL_LCD_DrawRect(x0, y0, x1 - x0, y1 - y0, colors[tbox->id % NUMBER_COLORS]);
-  UTIL_LCDEx_PrintfAt(x0 + 1, y0 + 1, LEFT_MODE, "%3d", tbox->id);
+static void Display_TrackingLabel(tbox_info *tbox)
+{
+  char text[12];
+  int x0, y0;
+  int x1, y1;
+
+  Display_TrackingArea(tbox, &x0, &y0, &x1, &y1);
+  overlay_format_id(tbox->id, text);
+  overlay_draw_text(x0 + 1, y0 + 1, text);
 }
 
 static void Display_NetworkOutput_Tracking(display_info_t *info)
@@ -574,59 +1068,63 @@ static void Display_NetworkOutput_Tracking(display_info_t *info)
   float nn_fps;
   int i;
 
-  /* clear previous ui */
-  UTIL_LCD_FillRect(lcd_fg_area.X0, lcd_fg_area.Y0, lcd_fg_area.XSize, lcd_fg_area.YSize, 0x00000000); /* Clear previous boxes */
-
   /* cpu load */
   cpuload_update(&cpu_load);
   cpuload_get_info(&cpu_load, NULL, &cpu_load_one_second, NULL);
 
   /* draw metrics */
-  nn_fps = 1000.0 / info->nn_period_ms;
+  nn_fps = 1000.0 / info->timing.nn_period_ms;
 #if 1
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "Cpu load");
+  overlay_panel_printf(line_nb, "Cpu load");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "   %.1f%%", cpu_load_one_second);
+  overlay_panel_printf(line_nb, "   %.1f%%", cpu_load_one_second);
   line_nb += 2;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Inference");
+  overlay_panel_printf(line_nb, "Inference");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->inf_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.inf_ms);
   line_nb += 2;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   FPS");
+  overlay_panel_printf(line_nb, "   FPS");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "  %.2f", nn_fps);
+  overlay_panel_printf(line_nb, "  %.2f", nn_fps);
   line_nb += 2;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, " Objects %u", info->tboxes_valid_nb);
+  overlay_panel_printf(line_nb, " Objects %u", info->tracks.nb);
   line_nb += 1;
+#ifdef USE_NN_DEADLINE
+  line_nb = Display_DeadlineStats(info, line_nb);
+#endif
 #else
   (void) nn_fps;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "Cpu load");
+  overlay_panel_printf(line_nb, "Cpu load");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb),  RIGHT_MODE, "   %.1f%%", cpu_load_one_second);
+  overlay_panel_printf(line_nb, "   %.1f%%", cpu_load_one_second);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "nn period");
+  overlay_panel_printf(line_nb, "nn period");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->nn_period_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.nn_period_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Inference");
+  overlay_panel_printf(line_nb, "Inference");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->inf_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.inf_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Post process");
+  overlay_panel_printf(line_nb, "Post process");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->pp_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.pp_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "Display");
+  overlay_panel_printf(line_nb, "Display");
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, "   %ums", info->disp_ms);
+  overlay_panel_printf(line_nb, "   %ums", info->timing.disp_ms);
   line_nb += 1;
-  UTIL_LCDEx_PrintfAt(0, LINE(line_nb), RIGHT_MODE, " Objects %u", info->tboxes_valid_nb);
+  overlay_panel_printf(line_nb, " Objects %u", info->tracks.nb);
   line_nb += 1;
 #endif
 
-  /* Draw bounding boxes */
-  for (i = 0; i < info->tboxes_valid_nb; i++)
-    Display_TrackingBox(&info->tboxes[i]);
+  /* Panel lines were written back as soon as drawn. Draw all boxes before labels so cpu only fetches label cache
+   * lines once DMA2D output is in memory, and no dirty line is left over an area DMA2D writes afterwards.
+   */
+  for (i = 0; i < info->tracks.nb; i++)
+    Display_TrackingBox(&info->tracks.boxes[i]);
+  for (i = 0; i < info->tracks.nb; i++)
+    Display_TrackingLabel(&info->tracks.boxes[i]);
 }
 #else
 static void Display_NetworkOutput_Tracking(display_info_t *info)
@@ -638,7 +1136,7 @@ static void Display_NetworkOutput_Tracking(display_info_t *info)
 
 static void Display_NetworkOutput(display_info_t *info)
 {
-  if (info->tracking_enabled)
+  if (info->tracks.is_enabled)
     Display_NetworkOutput_Tracking(info);
   else
     Display_NetworkOutput_NoTracking(info);
@@ -648,17 +1146,75 @@ static void Display_NetworkOutput(display_info_t *info)
 static ai_handle network = AI_HANDLE_NULL;
 
 /* Global c-array to handle the activations buffer(s) */
+/* mem_plan(run): nn activations */
 __attribute__ ((section (".npuram_bss")))
 __attribute__ ((aligned (32)))
 AI_ALIGNED(32) static ai_u8 activations_1[AI_NETWORK_DATA_ACTIVATION_1_SIZE];
 
-/* Array to store the data of the input tensors */
-AI_ALIGNED(32) static ai_i8 data_in_1[AI_NETWORK_IN_1_SIZE_BYTES];
+#ifdef USE_NN_DEADLINE
+/* Called by nn thread when misses accumulate and once they went away. This is where app trades quality for latency.
+ * A single model is linked so there is no lighter one to switch to. nn rate is lowered instead, which leaves memory
+ * bandwidth and cpu to other threads, and post process threshold is raised so fewer boxes go through nms and tracking.
+ */
+static void nn_deadline_degrade(int is_degraded)
+{
+  nn_deadline_period_ms = is_degraded ? DEADLINE_DEGRADED_NN_PERIOD_MS : 0;
+  nn_deadline_conf_min = is_degraded ? DEADLINE_DEGRADED_CONF : 0;
+}
+
+static void nn_deadline_report()
+{
+  const dl_stats_t *st = &dl_ctx.st;
+  int i;
 
-/* Array to store the data of the output tensors */
-AI_ALIGNED(32) static ai_i8 data_out_1[AI_NETWORK_OUT_1_SIZE_BYTES];
-AI_ALIGNED(32) static ai_i8 data_out_2[AI_NETWORK_OUT_2_SIZE_BYTES];
-AI_ALIGNED(32) static ai_i8 data_out_3[AI_NETWORK_OUT_3_SIZE_BYTES];
+  printf("deadline: %lu runs, %lu misses, %lu errors, worst %lums, degraded %lu times\n", (unsigned long) st->run_nb,
+         (unsigned long) st->miss_nb, (unsigned long) st->error_nb, (unsigned long) st->worst_ms,
+         (unsigned long) st->degrade_nb);
+  if (st->error_nb)
+    printf("deadline: last error type 0x%02lx code 0x%04lx at run %lu\n", (unsigned long) (st->error >> 24),
+           (unsigned long) (st->error & 0xffffff), (unsigned long) st->error_run);
+  printf("deadline: latency");
+  for (i = 0; i < DL_HIST_NB - 1; i++)
+    printf(" <%lums:%lu", (unsigned long) dl_hist_bound(&dl_ctx, i), (unsigned long) st->hist[i]);
+  printf(" more:%lu\n", (unsigned long) st->hist[DL_HIST_NB - 1]);
+}
+
+static void nn_deadline_update(uint32_t inf_ms, uint32_t error)
+{
+  const dl_stats_t *st = &dl_ctx.st;
+  uint32_t miss_nb = st->miss_nb;
+
+  if (dl_update(&dl_ctx, inf_ms, error)) {
+    TRACE_INSTANT(TRC_ID_NN_DEGRADE, st->is_degraded);
+    printf("deadline: %s mode, %d misses in last %d inferences\n", st->is_degraded ? "degraded" : "normal",
+           st->window_miss_nb, DEADLINE_WINDOW_NB);
+    nn_deadline_degrade(st->is_degraded);
+  }
+  if (st->miss_nb != miss_nb)
+    TRACE_INSTANT(TRC_ID_NN_MISS, inf_ms);
+
+  disp.timing.nn_miss_nb = st->miss_nb;
+  disp.timing.nn_error_nb = st->error_nb;
+  disp.timing.nn_worst_ms = st->worst_ms;
+  if (st->run_nb % DEADLINE_REPORT_NB == 0)
+    nn_deadline_report();
+}
+#endif
+
+/* A failing network usually fails each inference the same way, so only print when error changes. Successful
+ * inferences give 0, so failing again after them is printed again.
+ */
+static void nn_log_error(uint32_t error)
+{
+  static uint32_t prev_error;
+
+  if (error && error != prev_error)
+    printf("nn: inference failed, error type 0x%02lx code 0x%04lx\n", (unsigned long) (error >> 24),
+           (unsigned long) (error & 0xffffff));
+  prev_error = error;
+}
+
+/* Input and output tensors have no storage of their own. They point to nn_input_queue and nn_output_queue buffers */
 
 /* Array of pointer to manage the model's input/output tensors */
 static ai_buffer *ai_input;
@@ -672,6 +1228,16 @@ static void nn_thread_fct(void *arg)
   uint32_t nn_period[2];
   uint8_t *nn_pipe_dst;
   uint32_t nn_in_len;
+#ifdef USE_GOVERNOR
+  gov_setpoint_t sp;
+#endif
+#if defined(USE_GOVERNOR) || defined(USE_NN_DEADLINE)
+  uint32_t elapsed;
+#endif
+  uint32_t bench_ts;
+  uint32_t meta_ts;
+  ai_error nn_error;
+  uint32_t error;
   uint32_t inf_ms;
   uint32_t ts;
   int ret;
@@ -682,6 +1248,11 @@ static void nn_thread_fct(void *arg)
   };
 
   ai_network_create_and_init(&network, acts, NULL);
+  /* layer list editors first, they assert no other walker saw layers they unlink */
+  NNIN_Init(network);
+  NNOUT_Init(network);
+  WCACHE_Init(network);
+  NNPROF_Init(network);
   /* Reteive pointers to the model's input/output tensors */
   ai_input = ai_network_inputs_get(network, NULL);
   ai_output = ai_network_outputs_get(network, NULL);
@@ -699,6 +1270,9 @@ static void nn_thread_fct(void *arg)
 
   nn_pipe_dst = bqueue_get_free(&nn_input_queue, 0);
   assert(nn_pipe_dst);
+#ifdef APP_NN_CROP
+  nn_crop_capture_buffer = nn_pipe_dst;
+#endif
   CAM_NNPipe_Start(nn_pipe_dst, CMW_MODE_CONTINUOUS);
 
   while (1)
@@ -714,13 +1288,22 @@ static void nn_thread_fct(void *arg)
     nn_period_ms = nn_period[1] - nn_period[0];
       
     /* 入力バッファ取得 */
+    TRACE_BEGIN(TRC_ID_NN_WAIT);
     capture_buffer = bqueue_get_ready(&nn_input_queue);
     assert(capture_buffer);
+    TRACE_END(TRC_ID_NN_WAIT);
     ai_input[0].data = AI_HANDLE_PTR(capture_buffer);
       
     /* 出力バッファ取得 */
-    output_buffer = bqueue_get_free(&nn_output_queue, 1);
+    output_buffer = bqueue_get_free(&nn_output_queue, 0);
+    if (!output_buffer) {
+      BENCH_QueueDrop(BENCH_QUEUE_NN_OUTPUT);
+      output_buffer = bqueue_get_free(&nn_output_queue, 1);
+    }
     assert(output_buffer);
+#ifdef APP_NN_CROP
+    nn_output_crop[nn_output_idx(output_buffer)] = nn_input_crop[nn_input_idx(capture_buffer)];
+#endif
     out[0] = output_buffer;
     for (i = 1; i < NN_OUT_NB; i++)
       out[i] = out[i - 1] + ALIGN_VALUE(nn_out_len_user[i - 1], 32);
@@ -728,6 +1311,7 @@ static void nn_thread_fct(void *arg)
     ai_output[0].data = AI_HANDLE_PTR(out[0]);
     ai_output[1].data = AI_HANDLE_PTR(out[1]);
     ai_output[2].data = AI_HANDLE_PTR(out[2]);
+    NNOUT_Bind(out);
 
     /* 時間計測 */
     ts = HAL_GetTick();
@@ -745,21 +1329,60 @@ static void nn_thread_fct(void *arg)
     Run_Inference(&NN_Instance_Default);
 #endif
 
+    TRACE_BEGIN(TRC_ID_NN_RUN);
+    bench_ts = BENCH_Now();
+    meta_ts = META_Now();
+#ifdef USE_NN_SIGNED_INPUT
+    /* dcmipp wrote frame behind cpu back */
+    CACHE_OP(SCB_InvalidateDCache_by_Addr(capture_buffer, sizeof(nn_input_buffers[0])));
+    NNIN_Convert(capture_buffer, sizeof(nn_input_buffers[0]));
+#endif
     ret = ai_network_run(network, &ai_input[0], &ai_output[0]);
+    META_StageDone(META_STAGE_INFERENCE, meta_ts);
+    BENCH_StageDone(BENCH_STAGE_INFERENCE, bench_ts);
+    TRACE_END(TRC_ID_NN_RUN);
   
     inf_ms = HAL_GetTick() - ts;
+    /* a single batch is processed, anything else is a failure */
+    error = 0;
+    if (ret != 1) {
+      nn_error = ai_network_get_error(network);
+      error = ((uint32_t) nn_error.type << 24) | nn_error.code;
+    }
 
     /* release buffers */
+#ifdef USE_NN_SIGNED_INPUT
+    /* drop converted lines so their eviction can't overwrite next dcmipp frame */
+    CACHE_OP(SCB_InvalidateDCache_by_Addr(capture_buffer, sizeof(nn_input_buffers[0])));
+#endif
     bqueue_put_free(&nn_input_queue);
-    bqueue_put_ready(&nn_output_queue);
+    if (error) {
+      /* output content is undefined, don't let post process decode it */
+      bqueue_unget_free(&nn_output_queue);
+    } else
+      bqueue_put_ready(&nn_output_queue);
+    nn_log_error(error);
 
     /* update display stats */
-    ret = xSemaphoreTake(disp.lock, portMAX_DELAY);
-    assert(ret == pdTRUE);
-    disp.info.inf_ms = inf_ms;
-    disp.info.nn_period_ms = nn_period_ms;
-    ret = xSemaphoreGive(disp.lock);
-    assert(ret == pdTRUE);
+    disp.timing.inf_ms = inf_ms;
+    disp.timing.nn_period_ms = nn_period_ms;
+#ifdef USE_NN_DEADLINE
+    nn_deadline_update(inf_ms, error);
+#endif
+
+#ifdef USE_GOVERNOR
+    /* leave cpu to other threads until governor nn period is reached. Governor notifies us when leaving idle mode */
+    gov_get_setpoint(&sp);
+    elapsed = HAL_GetTick() - nn_period[1];
+    if (elapsed < sp.nn_period_ms)
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sp.nn_period_ms - elapsed));
+#endif
+#ifdef USE_NN_DEADLINE
+    /* degraded mode skips frames until its own nn period is reached */
+    elapsed = HAL_GetTick() - nn_period[1];
+    if (elapsed < nn_deadline_period_ms)
+      vTaskDelay(pdMS_TO_TICKS(nn_deadline_period_ms - elapsed));
+#endif
   }
 }
 
@@ -841,6 +1464,117 @@ static int app_tracking(od_pp_out_t *pp)
 }
 #endif
 
+#ifdef USE_NN_ROI
+/* bring detections back to full field of view before tracking and display */
+static void nn_roi_remap(od_pp_out_t *pp, uint8_t *output_buffer)
+{
+  const zoom_roi_t *roi = &nn_output_crop[nn_output_idx(output_buffer)].roi;
+  od_pp_outBuffer_t *box;
+  int i;
+
+  for (i = 0; i < pp->nb_detect; i++) {
+    box = &pp->pOutBuff[i];
+    zoom_remap(roi, &box->x_center, &box->y_center, &box->width, &box->height);
+  }
+}
+
+static void nn_roi_update(od_pp_out_t *pp, int tracking_enabled)
+{
+  zoom_roi_t roi;
+  int nb = 0;
+  int i;
+
+#ifdef TRACKER_MODULE
+  /* follow tracks, lost ones included, so roi doesn't leave someone nn missed once */
+  for (i = 0; tracking_enabled && i < ARRAY_NB(tboxes); i++) {
+    if (!tboxes[i].is_tracking)
+      continue;
+    zoom_boxes[nb].cx = tboxes[i].cx;
+    zoom_boxes[nb].cy = tboxes[i].cy;
+    zoom_boxes[nb].w = tboxes[i].w;
+    zoom_boxes[nb].h = tboxes[i].h;
+    nb++;
+  }
+#endif
+  for (i = 0; !tracking_enabled && i < MIN(pp->nb_detect, ARRAY_NB(zoom_boxes)); i++) {
+    zoom_boxes[nb].cx = pp->pOutBuff[i].x_center;
+    zoom_boxes[nb].cy = pp->pOutBuff[i].y_center;
+    zoom_boxes[nb].w = pp->pOutBuff[i].width;
+    zoom_boxes[nb].h = pp->pOutBuff[i].height;
+    nb++;
+  }
+
+  zoom_update(&zoom_ctx, nb, zoom_boxes, &roi);
+  if (memcmp(&roi, &nn_roi_selected, sizeof(roi)) == 0)
+    return;
+
+  nn_roi_selected = roi;
+  __disable_irq();
+  nn_crop_next.roi = roi;
+  nn_crop_pending = 1;
+  __enable_irq();
+}
+#endif
+
+#ifdef USE_NN_TILING
+/* Add tile result and replace it by merge of all tiles when it's time to. Return 0 when result has to wait for other
+ * tiles.
+ */
+static int nn_tiling_merge(od_pp_out_t *pp, uint8_t *output_buffer)
+{
+  const nn_crop_t *crop = &nn_output_crop[nn_output_idx(output_buffer)];
+  int nb = MIN(pp->nb_detect, ARRAY_NB(tile_in));
+  int i;
+
+  for (i = 0; i < nb; i++) {
+    tile_in[i].cx = pp->pOutBuff[i].x_center;
+    tile_in[i].cy = pp->pOutBuff[i].y_center;
+    tile_in[i].w = pp->pOutBuff[i].width;
+    tile_in[i].h = pp->pOutBuff[i].height;
+    tile_in[i].conf = pp->pOutBuff[i].conf;
+    tile_in[i].class_index = pp->pOutBuff[i].class_index;
+  }
+  if (!tile_add(&tile_ctx, crop->tile, &crop->roi, nb, tile_in))
+    return 0;
+
+  nb = tile_merge(&tile_ctx, ARRAY_NB(tile_merged), tile_merged);
+  for (i = 0; i < nb; i++) {
+    tile_out[i].x_center = tile_merged[i].cx;
+    tile_out[i].y_center = tile_merged[i].cy;
+    tile_out[i].width = tile_merged[i].w;
+    tile_out[i].height = tile_merged[i].h;
+    tile_out[i].conf = tile_merged[i].conf;
+    tile_out[i].class_index = tile_merged[i].class_index;
+  }
+  pp->pOutBuff = tile_out;
+  pp->nb_detect = nb;
+
+  return 1;
+}
+#endif
+
+static void app_metadata_send(display_detects_t *detects, display_tracks_t *tracks)
+{
+  int i;
+
+#ifdef TRACKER_MODULE
+  if (tracks->is_enabled) {
+    META_FrameBegin(1);
+    for (i = 0; i < tracks->nb; i++)
+      META_AddBox(tracks->boxes[i].id, tracks->boxes[i].cx, tracks->boxes[i].cy, tracks->boxes[i].w,
+                  tracks->boxes[i].h, 0, 0);
+    META_FrameEnd();
+    return;
+  }
+#endif
+
+  META_FrameBegin(0);
+  for (i = 0; i < detects->nb; i++)
+    META_AddBox(0, detects->boxes[i].x_center, detects->boxes[i].y_center, detects->boxes[i].width,
+                detects->boxes[i].height, detects->boxes[i].conf, detects->boxes[i].class_index);
+  META_FrameEnd();
+}
+
 static void pp_thread_fct(void *arg)
 {
 #if POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V2_UF
@@ -849,15 +1583,31 @@ static void pp_thread_fct(void *arg)
   od_yolov5_pp_static_param_t pp_params;
 #elif POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V8_UF || POSTPROCESS_TYPE == POSTPROCESS_OD_YOLO_V8_UI
   od_yolov8_pp_static_param_t pp_params;
-#elif POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UF
+#elif POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UF || POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UI
   od_st_yolox_pp_static_param_t pp_params;
 #else
     #error "PostProcessing type not supported"
 #endif
   uint8_t *pp_input[NN_OUT_NB];
   od_pp_out_t pp_output;
+  display_detects_t *detects;
+  display_tracks_t *tracks;
+#ifdef USE_GOVERNOR
+  gov_setpoint_t sp;
+#endif
+#ifdef USE_NN_TILING
+  int is_merged;
+#endif
+  int disp_skip_cnt = 0;
+  int disp_divider = 1;
   int tracking_enabled;
+  float conf_threshold;
+  uint32_t bench_ts;
+  uint32_t meta_ts;
   uint32_t nn_pp[2];
+#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UI
+  int is_quant_read = 0;
+#endif
   int ret;
   int i;
 
@@ -865,6 +1615,7 @@ static void pp_thread_fct(void *arg)
   /* setup post process */
 //  app_postprocess_init(&pp_params, &NN_Instance_Default);
     app_postprocess_init(&pp_params, NULL);
+  conf_threshold = pp_params.conf_threshold;
   while (1)
   {
     uint8_t *output_buffer;
@@ -876,36 +1627,116 @@ static void pp_thread_fct(void *arg)
       pp_input[i] = pp_input[i - 1] + ALIGN_VALUE(nn_out_len_user[i - 1], 32);
     pp_output.pOutBuff = NULL;
 
+#if POSTPROCESS_TYPE == POSTPROCESS_OD_ST_YOLOX_UI
+    /* No output buffers info with this runtime. Quantization is read from network once nn thread produced a first
+     * result, so NNOUT_Init() is done. It doesn't change afterwards. Outputs come in S, L, M order.
+     */
+    if (!is_quant_read) {
+      NNOUT_GetQuant(0, &pp_params.raw_s_scale, &pp_params.raw_s_zero_point);
+      NNOUT_GetQuant(1, &pp_params.raw_l_scale, &pp_params.raw_l_zero_point);
+      NNOUT_GetQuant(2, &pp_params.raw_m_scale, &pp_params.raw_m_zero_point);
+      is_quant_read = 1;
+    }
+#endif
+
+#ifdef USE_GOVERNOR
+    gov_get_setpoint(&sp);
+    conf_threshold = sp.conf_threshold;
+    pp_params.max_boxes_limit = sp.max_boxes;
+    disp_divider = sp.disp_divider;
+#endif
+    pp_params.conf_threshold = conf_threshold;
+#ifdef USE_NN_DEADLINE
+    if (pp_params.conf_threshold < nn_deadline_conf_min)
+      pp_params.conf_threshold = nn_deadline_conf_min;
+#endif
+
     nn_pp[0] = HAL_GetTick();
+    TRACE_BEGIN(TRC_ID_PP_RUN);
+    bench_ts = BENCH_Now();
+    meta_ts = META_Now();
     ret = app_postprocess_run((void **)pp_input, NN_OUT_NB, &pp_output, &pp_params);
     assert(ret == 0);
+#ifdef USE_NN_ROI
+    nn_roi_remap(&pp_output, output_buffer);
+#endif
+#ifdef USE_NN_TILING
+    is_merged = nn_tiling_merge(&pp_output, output_buffer);
+#endif
+    META_StageDone(META_STAGE_PP, meta_ts);
+    BENCH_StageDone(BENCH_STAGE_PP, bench_ts);
+    TRACE_END(TRC_ID_PP_RUN);
+#ifdef USE_NN_TILING
+    /* sweep mode. Nothing to track or display until all tiles have a result */
+    if (!is_merged) {
+      bqueue_put_free(&nn_output_queue);
+      continue;
+    }
+#endif
+    TRACE_BEGIN(TRC_ID_PP_TRACK);
+    bench_ts = BENCH_Now();
+    meta_ts = META_Now();
     tracking_enabled = app_tracking(&pp_output);
+    if (tracking_enabled) {
+      META_StageDone(META_STAGE_TRACKING, meta_ts);
+      BENCH_StageDone(BENCH_STAGE_TRACKING, bench_ts);
+    }
+    TRACE_END(TRC_ID_PP_TRACK);
+#ifdef USE_NN_ROI
+    nn_roi_update(&pp_output, tracking_enabled);
+#endif
 
     nn_pp[1] = HAL_GetTick();
 
-    /* update display stats and detection info */
-    ret = xSemaphoreTake(disp.lock, portMAX_DELAY);
-    assert(ret == pdTRUE);
-    disp.info.nb_detect = pp_output.nb_detect;
-    for (i = 0; i < pp_output.nb_detect; i++)
-      disp.info.detects[i] = pp_output.pOutBuff[i];
+    /* publish detection info */
+    detects = snapshot_write_begin(&disp.detects);
+    detects->nb = MIN(pp_output.nb_detect, AI_OD_PP_MAX_BOXES_LIMIT);
+    /* decoding leaves the number of boxes above threshold in params */
+    detects->nb_candidates = pp_params.nb_detect;
+    for (i = 0; i < detects->nb; i++)
+      detects->boxes[i] = pp_output.pOutBuff[i];
+    snapshot_write_end(&disp.detects);
+
+    /* publish tracking info */
+    tracks = snapshot_write_begin(&disp.tracks);
+    tracks->is_enabled = 0;
 #ifdef TRACKER_MODULE
-    disp.info.tracking_enabled = tracking_enabled;
-    disp.info.tboxes_valid_nb = 0;
-    for (i = 0; i < ARRAY_NB(tboxes); i++) {
-      if (!tboxes[i].is_tracking || tboxes[i].tlost_cnt)
+    tracks->is_enabled = tracking_enabled;
+    tracks->nb = 0;
+    tracks->nb_lost = 0;
+    for (i = 0; i < ARRAY_NB(tboxes) && tracks->nb < AI_OD_PP_MAX_BOXES_LIMIT; i++) {
+      if (!tboxes[i].is_tracking)
+        continue;
+      if (tboxes[i].tlost_cnt) {
+        tracks->nb_lost++;
         continue;
-      tbox_to_tbox_info(&tboxes[i], &disp.info.tboxes[disp.info.tboxes_valid_nb]);
-      disp.info.tboxes_valid_nb++;
+      }
+      tbox_to_tbox_info(&tboxes[i], &tracks->boxes[tracks->nb]);
+      tracks->nb++;
     }
 #endif
-    disp.info.pp_ms = nn_pp[1] - nn_pp[0];
-    ret = xSemaphoreGive(disp.lock);
-    assert(ret == pdTRUE);
+    snapshot_write_end(&disp.tracks);
+
+    disp.timing.pp_ms = nn_pp[1] - nn_pp[0];
+
+    app_metadata_send(detects, tracks);
 
     bqueue_put_free(&nn_output_queue);
+    BENCH_FrameDone(pp_output.nb_detect);
+#ifdef APP_HEADLESS
+    /* headless. dp thread is not running */
+    (void) disp_skip_cnt;
+    (void) disp_divider;
+#else
+    /* skip display refresh as requested by governor */
+    if (++disp_skip_cnt < disp_divider)
+      continue;
+    disp_skip_cnt = 0;
     /* It's possible xqueue is empty if display is slow. So don't check error code that may by pdFALSE in that case */
-    xSemaphoreGive(disp.update);
+    ret = xSemaphoreGive(disp.update);
+    if (ret != pdTRUE)
+      BENCH_QueueDrop(BENCH_QUEUE_DISPLAY);
+#endif
   }
 }
 
@@ -932,8 +1763,8 @@ static void dp_commit_drawing_area()
 
 static void dp_thread_fct(void *arg)
 {
-  uint32_t disp_ms = 0;
-  display_info_t info;
+  /* static so a large AI_OD_PP_MAX_BOXES_LIMIT doesn't blow thread stack */
+  static display_info_t info;
   uint32_t ts;
   int ret;
 
@@ -942,19 +1773,21 @@ static void dp_thread_fct(void *arg)
     ret = xSemaphoreTake(disp.update, portMAX_DELAY);
     assert(ret == pdTRUE);
 
-    ret = xSemaphoreTake(disp.lock, portMAX_DELAY);
-    assert(ret == pdTRUE);
-    info = disp.info;
-    ret = xSemaphoreGive(disp.lock);
-    assert(ret == pdTRUE);
-    info.disp_ms = disp_ms;
+    snapshot_read(&disp.detects, &info.detects);
+    snapshot_read(&disp.tracks, &info.tracks);
+    display_timing_read(&info.timing);
 
     ts = HAL_GetTick();
     dp_update_drawing_area();
+    TRACE_BEGIN(TRC_ID_DP_DRAW);
+    overlay_clear();
     Display_NetworkOutput(&info);
-    SCB_CleanDCache_by_Addr(lcd_fg_buffer[lcd_fg_buffer_rd_idx], LCD_FG_WIDTH * LCD_FG_HEIGHT* 2);
+    TRACE_END(TRC_ID_DP_DRAW);
+    TRACE_BEGIN(TRC_ID_DP_CACHE);
+    overlay_clean();
+    TRACE_END(TRC_ID_DP_CACHE);
     dp_commit_drawing_area();
-    disp_ms = HAL_GetTick() - ts;
+    disp.timing.disp_ms = HAL_GetTick() - ts;
   }
 }
 
@@ -966,10 +1799,179 @@ static void isp_thread_fct(void *arg)
     ret = xSemaphoreTake(isp_sem, portMAX_DELAY);
     assert(ret == pdTRUE);
 
+    TRACE_BEGIN(TRC_ID_ISP_UPDATE);
     CAM_IspUpdate();
+    TRACE_END(TRC_ID_ISP_UPDATE);
+  }
+}
+
+#ifdef USE_GOVERNOR
+/* Samples and resulting setpoint as csv lines, so a log can be replayed with Scripts/governor_sim.py --replay */
+static void gov_log_conf(const gov_conf_t *cfg)
+{
+  printf("gov,cfg,%.1f,%lu,%lu,%lu,%.2f,%.2f,%.2f,%d,%d,%d,%lu,%lu\n", cfg->cpu_budget,
+         (unsigned long) cfg->pp_latency_ms, (unsigned long) cfg->nn_period_min_ms,
+         (unsigned long) cfg->nn_period_max_ms, cfg->conf_min, cfg->conf_max, cfg->conf_step, cfg->max_boxes_min,
+         cfg->max_boxes_max, cfg->disp_divider_max, (unsigned long) cfg->idle_delay_ms,
+         (unsigned long) cfg->idle_nn_period_ms);
+  printf("gov,ts_ms,cpu_load,nn_period_ms,inf_ms,pp_ms,disp_ms,nb_detect,nb_candidates,nb_tracks,nb_lost,"
+         "sp_nn_period_ms,sp_conf_threshold,sp_max_boxes,sp_disp_divider,sp_is_idle\n");
+}
+
+static void gov_log_sample(const gov_sample_t *s, const gov_setpoint_t *sp)
+{
+  printf("gov,%lu,%.2f,%lu,%lu,%lu,%lu,%d,%d,%d,%d,%lu,%.2f,%d,%d,%d\n", (unsigned long) s->ts_ms, s->cpu_load,
+         (unsigned long) s->nn_period_ms, (unsigned long) s->inf_ms, (unsigned long) s->pp_ms,
+         (unsigned long) s->disp_ms, s->nb_detect, s->nb_candidates, s->nb_tracks, s->nb_lost,
+         (unsigned long) sp->nn_period_ms, sp->conf_threshold, sp->max_boxes, sp->disp_divider, sp->is_idle);
+}
+
+static void gov_thread_fct(void *arg)
+{
+  static display_detects_t detects;
+  static display_tracks_t tracks;
+  display_timing_t timing;
+  TickType_t last_wake;
+  gov_sample_t s;
+  int was_idle = 0;
+
+  cpuload_update(&gov_cpu_load);
+  last_wake = xTaskGetTickCount();
+  while (1) {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(GOVERNOR_PERIOD_MS));
+
+    cpuload_update(&gov_cpu_load);
+    cpuload_get_info(&gov_cpu_load, &s.cpu_load, NULL, NULL);
+
+    snapshot_read(&disp.detects, &detects);
+    snapshot_read(&disp.tracks, &tracks);
+    display_timing_read(&timing);
+    s.ts_ms = HAL_GetTick();
+    s.nn_period_ms = timing.nn_period_ms;
+    s.inf_ms = timing.inf_ms;
+    s.pp_ms = timing.pp_ms;
+    s.disp_ms = timing.disp_ms;
+    s.nb_detect = detects.nb;
+    s.nb_candidates = detects.nb_candidates;
+    s.nb_tracks = -1;
+    s.nb_lost = -1;
+#ifdef TRACKER_MODULE
+    if (tracks.is_enabled) {
+      s.nb_tracks = tracks.nb;
+      s.nb_lost = tracks.nb_lost;
+    }
+#endif
+
+    gov_update(&gov_ctx, &s);
+    TRACE_INSTANT(TRC_ID_GOV_UPDATE, gov_ctx.sp.nn_period_ms);
+    gov_log_sample(&s, &gov_ctx.sp);
+
+    taskENTER_CRITICAL();
+    gov_sp = gov_ctx.sp;
+    taskEXIT_CRITICAL();
+
+    if (gov_ctx.sp.is_idle != was_idle) {
+      TRACE_INSTANT(TRC_ID_GOV_IDLE, gov_ctx.sp.is_idle);
+      printf("gov: %s mode\n", gov_ctx.sp.is_idle ? "idle" : "active");
+      /* don't wait for end of idle nn period to run at full rate */
+      if (!gov_ctx.sp.is_idle)
+        xTaskNotifyGive((TaskHandle_t) &nn_thread);
+      was_idle = gov_ctx.sp.is_idle;
+    }
   }
 }
 
+static void Governor_init()
+{
+  gov_conf_t cfg = {
+    .cpu_budget = GOVERNOR_CPU_BUDGET,
+    .pp_latency_ms = GOVERNOR_PP_LATENCY_MS,
+    .nn_period_min_ms = 1000 / CAMERA_FPS,
+    .nn_period_max_ms = GOVERNOR_NN_PERIOD_MAX_MS,
+    .conf_min = GOVERNOR_CONF_MIN,
+    .conf_max = GOVERNOR_CONF_MAX,
+    .conf_step = 0.05,
+    .max_boxes_min = 1,
+    .max_boxes_max = AI_OD_PP_MAX_BOXES_LIMIT,
+    .disp_divider_max = GOVERNOR_DISP_DIVIDER_MAX,
+    .idle_delay_ms = GOVERNOR_IDLE_DELAY_MS,
+    .idle_nn_period_ms = GOVERNOR_IDLE_NN_PERIOD_MS,
+  };
+  int ret;
+
+  ret = gov_init(&gov_ctx, &cfg, &gov_policy_presence, &gov_presence);
+  assert(ret == 0);
+  gov_log_conf(&cfg);
+  gov_sp = gov_ctx.sp;
+  cpuload_init(&gov_cpu_load);
+}
+#endif
+
+#ifdef USE_NN_DEADLINE
+static void NN_Deadline_init()
+{
+  dl_conf_t cfg = {
+    .budget_ms = DEADLINE_BUDGET_MS,
+    .window = DEADLINE_WINDOW_NB,
+    .degrade_nb = DEADLINE_DEGRADE_NB,
+    .recover_nb = DEADLINE_RECOVER_NB,
+  };
+  int ret;
+
+  ret = dl_init(&dl_ctx, &cfg);
+  assert(ret == 0);
+}
+#endif
+
+#ifdef USE_NN_ROI
+static void NN_ROI_init()
+{
+  zoom_conf_t cfg = {
+    .margin = NN_ROI_MARGIN,
+    .min_size = CAM_NNPipe_GetRoiMinSize(),
+    .hysteresis = NN_ROI_HYSTERESIS,
+    .shrink_delay = NN_ROI_SHRINK_DELAY,
+    .release_delay = NN_ROI_RELEASE_DELAY,
+    .scan_period = NN_ROI_SCAN_PERIOD,
+  };
+  int ret;
+
+  ret = zoom_init(&zoom_ctx, &cfg);
+  assert(ret == 0);
+  /* CAM_Init() configured nn pipe on full field of view */
+  nn_roi_selected = zoom_roi_full;
+  nn_crop_capture.roi = zoom_roi_full;
+  nn_crop_capture.tile = 0;
+  printf("roi: zoom up to x%.2f\n", 1 / cfg.min_size);
+}
+#endif
+
+#ifdef USE_NN_TILING
+static void NN_Tiling_init()
+{
+  tile_conf_t cfg = {
+    .grid = NN_TILING_GRID,
+    .overlap = NN_TILING_OVERLAP,
+    .min_size = CAM_NNPipe_GetRoiMinSize(),
+    .is_sweep = NN_TILING_SWEEP,
+    .iou_thresh = NN_TILING_IOU_THRESHOLD,
+    .contain_thresh = NN_TILING_CONTAIN_THRESHOLD,
+    .cut_margin = 0.02,
+  };
+  int ret;
+
+  ret = tile_init(&tile_ctx, &cfg, AI_OD_PP_MAX_BOXES_LIMIT, tile_boxes, tile_work);
+  assert(ret == 0);
+  /* nn pipe is not started yet. Start on first tile */
+  nn_crop_capture.tile = tile_next(&tile_ctx);
+  nn_crop_capture.roi = tile_ctx.tiles[nn_crop_capture.tile];
+  CAM_NNPipe_SetRoi(&nn_crop_capture.roi);
+  printf("tiling: %d tiles of %.2f x field of view, %s\n", tile_ctx.tile_nb, nn_crop_capture.roi.size,
+         cfg.is_sweep ? "sweep" : "round robin");
+}
+#endif
+
+#ifndef APP_HEADLESS
 static void Display_init()
 {
   SCRL_LayerConfig layers_config[2] = {
@@ -990,21 +1992,45 @@ static void Display_init()
     .size = {lcd_bg_area.XSize, lcd_bg_area.YSize},
 #ifdef SCR_LIB_USE_SPI
     .format = SCRL_RGB565,
+#elif defined(SCR_LIB_USE_UVCL) && defined(USE_USB_JPEG)
+    .format = SCRL_JPEG,
+    .composition_address = composition_buffer,
+    .jpeg_quality = USB_JPEG_QUALITY,
 #else
     .format = SCRL_YUV422, /* Use SCRL_RGB565 if host support this format to reduce cpu load */
 #endif
     .address = screen_buffer,
     .fps = CAMERA_FPS,
+    .buffer_nb = SCREEN_BUFFER_NB,
   };
   int ret;
+  int i;
+
+  for (i = 0; i < 2; i++)
+    ovl_dirty_init(&lcd_fg_dirty[i], lcd_fg_area.XSize, lcd_fg_area.YSize, lcd_fg_dirty_rects[i], OVERLAY_DIRTY_MAX);
 
   ret = SCRL_Init((SCRL_LayerConfig *[2]){&layers_config[0], &layers_config[1]}, &screen_config);
   assert(ret == 0);
+  /* on usb output, let screen lib blend and convert to YUV422 with cpu when it is faster than dma2d */
+  ret = SCRL_SetComposition(SCRL_COMPOSITION_AUTO);
+  assert(ret == 0);
 
   UTIL_LCD_SetLayer(SCRL_LAYER_1);
   UTIL_LCD_Clear(UTIL_LCD_COLOR_TRANSPARENT);
   UTIL_LCD_SetFont(&LCD_FONT);
   UTIL_LCD_SetTextColor(UTIL_LCD_COLOR_WHITE);
+  overlay_text_init();
+}
+#endif
+
+/* DWT_CYCCNT is the time base of trace, benchmark, metadata, nn profiler and usb composition probe. Enable it before
+ * any of them so it also works when debugger is not attached.
+ */
+static void DWT_init()
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 void app_run()
@@ -1013,19 +2039,26 @@ void app_run()
   UBaseType_t pp_priority = FREERTOS_PRIORITY(-2);
   UBaseType_t dp_priority = FREERTOS_PRIORITY(-2);
   UBaseType_t nn_priority = FREERTOS_PRIORITY(1);
+#ifdef USE_GOVERNOR
+  UBaseType_t gov_priority = FREERTOS_PRIORITY(2);
+#endif
   TaskHandle_t hdl;
   int ret;
 
   printf("Init application\n");
-  /* Enable DWT so DWT_CYCCNT works when debugger not attached */
-  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT_init();
+  TRC_Init();
+  BENCH_Init();
+  META_Init();
 
   /* screen init */
+#ifndef APP_HEADLESS
   memset(lcd_bg_buffer, 0, sizeof(lcd_bg_buffer));
   CACHE_OP(SCB_CleanInvalidateDCache_by_Addr(lcd_bg_buffer, sizeof(lcd_bg_buffer)));
   memset(lcd_fg_buffer, 0, sizeof(lcd_fg_buffer));
   CACHE_OP(SCB_CleanInvalidateDCache_by_Addr(lcd_fg_buffer, sizeof(lcd_fg_buffer)));
   Display_init();
+#endif
 
   /* create buffer queues */
   ret = bqueue_init(&nn_input_queue, 2, (uint8_t *[2]){nn_input_buffers[0], nn_input_buffers[1]});
@@ -1041,19 +2074,37 @@ void app_run()
 #endif
 
   cpuload_init(&cpu_load);
+#ifdef USE_GOVERNOR
+  Governor_init();
+#endif
+#ifdef USE_NN_DEADLINE
+  NN_Deadline_init();
+#endif
 
   /*** Camera Init ************************************************************/  
   CAM_Init();
+#ifdef USE_NN_ROI
+  NN_ROI_init();
+#endif
+#ifdef USE_NN_TILING
+  NN_Tiling_init();
+#endif
+#if defined(USE_BENCHMARK) && BENCHMARK_TEST_PATTERN >= 0
+  /* fixed input so results only depend on firmware */
+  ret = CMW_CAMERA_SetTestPattern(BENCHMARK_TEST_PATTERN);
+  if (ret != CMW_ERROR_NONE)
+    printf("bench: sensor test pattern not supported, use live scene\n");
+#endif
 
-  /* sems + mutex init */
+  /* sems + snapshots init */
   isp_sem = xSemaphoreCreateCountingStatic(1, 0, &isp_sem_buffer);
   assert(isp_sem);
   disp.update = xSemaphoreCreateCountingStatic(1, 0, &disp.update_buffer);
   assert(disp.update);
-  disp.lock = xSemaphoreCreateMutexStatic(&disp.lock_buffer);
-  assert(disp.lock);
+  snapshot_init(&disp.detects, sizeof(disp.detects_slots[0]), (uint8_t *) disp.detects_slots);
+  snapshot_init(&disp.tracks, sizeof(disp.tracks_slots[0]), (uint8_t *) disp.tracks_slots);
 
-  /* Start LCD Display camera pipe stream */
+  /* Start LCD Display camera pipe stream. Keep it running in headless mode since it drives isp update */
   CAM_DisplayPipe_Start(lcd_bg_buffer[0], CMW_MODE_CONTINUOUS);
 
   /* threads init */
@@ -1063,12 +2114,21 @@ void app_run()
   hdl = xTaskCreateStatic(pp_thread_fct, "pp", configMINIMAL_STACK_SIZE * 2, NULL, pp_priority, pp_thread_stack,
                           &pp_thread);
   assert(hdl != NULL);
+  /* In headless mode dp thread is never woken up */
   hdl = xTaskCreateStatic(dp_thread_fct, "dp", configMINIMAL_STACK_SIZE * 2, NULL, dp_priority, dp_thread_stack,
                           &dp_thread);
   assert(hdl != NULL);
   hdl = xTaskCreateStatic(isp_thread_fct, "isp", configMINIMAL_STACK_SIZE * 2, NULL, isp_priority, isp_thread_stack,
                           &isp_thread);
   assert(hdl != NULL);
+#ifdef USE_GOVERNOR
+  hdl = xTaskCreateStatic(gov_thread_fct, "gov", configMINIMAL_STACK_SIZE * 2, NULL, gov_priority, gov_thread_stack,
+                          &gov_thread);
+  assert(hdl != NULL);
+#endif
+
+  /* telemetry init */
+  TLM_Init();
 }
 
 int CMW_CAMERA_PIPE_FrameEventCallback(uint32_t pipe)
@@ -0,0 +1,240 @@
+ /**
+ ******************************************************************************
+ * @file    app_bench.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_bench.h"
+#include "app_wcache.h"
+
+#ifdef USE_BENCHMARK
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32n6xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifdef STM32N6570_DK_REV
+#define BENCH_BOARD "STM32N6570-DK"
+#else
+#define BENCH_BOARD "NUCLEO-N657X0-Q"
+#endif
+
+typedef enum {
+  BENCH_STATE_WARMUP,
+  BENCH_STATE_RUN,
+  BENCH_STATE_REPORT,
+} bench_state_t;
+
+typedef struct {
+  uint32_t min;
+  uint32_t avg;
+  uint32_t p50;
+  uint32_t p90;
+  uint32_t p99;
+  uint32_t max;
+} bench_stats_t;
+
+static const char * const bench_stage_names[BENCH_STAGE_NB] = {
+  [BENCH_STAGE_INFERENCE] = "inference",
+  [BENCH_STAGE_PP] = "pp",
+  [BENCH_STAGE_TRACKING] = "tracking",
+};
+
+static const char * const bench_queue_names[BENCH_QUEUE_NB] = {
+  [BENCH_QUEUE_NN_INPUT] = "nn_input",
+  [BENCH_QUEUE_NN_OUTPUT] = "nn_output",
+  [BENCH_QUEUE_DISPLAY] = "display",
+};
+
+static volatile bench_state_t bench_state;
+/* samples are in us */
+static uint32_t bench_samples[BENCH_STAGE_NB][BENCHMARK_FRAME_NB];
+static uint32_t bench_sample_nb[BENCH_STAGE_NB];
+static uint32_t bench_sorted[BENCHMARK_FRAME_NB];
+/* free running counters. Report uses delta against window start so isr never sees a reset */
+static volatile uint32_t bench_captured;
+static volatile uint32_t bench_drops[BENCH_QUEUE_NB];
+static uint32_t bench_frame_nb;
+static uint32_t bench_detect_nb;
+static uint32_t bench_report_nb;
+
+static struct {
+  uint32_t tick;
+  uint32_t captured;
+  uint32_t drops[BENCH_QUEUE_NB];
+  configRUN_TIME_COUNTER_TYPE total;
+  configRUN_TIME_COUNTER_TYPE idle;
+} bench_start;
+
+static int bench_cmp_u32(const void *a, const void *b)
+{
+  uint32_t va = *(const uint32_t *) a;
+  uint32_t vb = *(const uint32_t *) b;
+
+  return (va > vb) - (va < vb);
+}
+
+/* nearest rank percentile on sorted samples */
+static uint32_t bench_percentile(uint32_t *sorted, uint32_t nb, uint32_t p)
+{
+  uint32_t rank = (p * nb + 99) / 100;
+
+  return sorted[rank ? rank - 1 : 0];
+}
+
+static void bench_compute_stats(BENCH_Stage_t stage, bench_stats_t *stats)
+{
+  uint32_t nb = bench_sample_nb[stage];
+  uint64_t sum = 0;
+  uint32_t i;
+
+  memset(stats, 0, sizeof(*stats));
+  if (!nb)
+    return;
+
+  memcpy(bench_sorted, bench_samples[stage], nb * sizeof(bench_sorted[0]));
+  qsort(bench_sorted, nb, sizeof(bench_sorted[0]), bench_cmp_u32);
+  for (i = 0; i < nb; i++)
+    sum += bench_sorted[i];
+
+  stats->min = bench_sorted[0];
+  stats->avg = sum / nb;
+  stats->p50 = bench_percentile(bench_sorted, nb, 50);
+  stats->p90 = bench_percentile(bench_sorted, nb, 90);
+  stats->p99 = bench_percentile(bench_sorted, nb, 99);
+  stats->max = bench_sorted[nb - 1];
+}
+
+static void bench_window_start()
+{
+  int i;
+
+  taskENTER_CRITICAL();
+  for (i = 0; i < BENCH_STAGE_NB; i++)
+    bench_sample_nb[i] = 0;
+  bench_frame_nb = 0;
+  bench_detect_nb = 0;
+  bench_start.tick = HAL_GetTick();
+  bench_start.captured = bench_captured;
+  for (i = 0; i < BENCH_QUEUE_NB; i++)
+    bench_start.drops[i] = bench_drops[i];
+  bench_start.total = portGET_RUN_TIME_COUNTER_VALUE();
+  bench_start.idle = ulTaskGetIdleRunTimeCounter();
+  bench_state = BENCH_STATE_RUN;
+  taskEXIT_CRITICAL();
+}
+
+static void bench_report()
+{
+  configRUN_TIME_COUNTER_TYPE total;
+  configRUN_TIME_COUNTER_TYPE idle;
+  bench_stats_t stats;
+  uint32_t duration_ms;
+  float cpu_load;
+  float fps;
+  float dps;
+  int i;
+
+  /* stop recording so nn thread doesn't touch samples while we sort them */
+  taskENTER_CRITICAL();
+  bench_state = BENCH_STATE_REPORT;
+  duration_ms = HAL_GetTick() - bench_start.tick;
+  total = portGET_RUN_TIME_COUNTER_VALUE() - bench_start.total;
+  idle = ulTaskGetIdleRunTimeCounter() - bench_start.idle;
+  taskEXIT_CRITICAL();
+
+  cpu_load = total ? 100.0 * (total - idle) / total : 0;
+  fps = duration_ms ? 1000.0 * bench_frame_nb / duration_ms : 0;
+  dps = duration_ms ? 1000.0 * bench_detect_nb / duration_ms : 0;
+
+  /* single json object per line prefixed by 'bench,' so host can grep it out of console log */
+  printf("bench,{\"report\":%lu,\"board\":\"%s\",\"nn\":[%d,%d],\"test_pattern\":%d,", (unsigned long) bench_report_nb,
+         BENCH_BOARD, NN_WIDTH, NN_HEIGHT, BENCHMARK_TEST_PATTERN);
+  printf("\"weight_cache\":%lu,", (unsigned long) WCACHE_Used());
+  printf("\"frames\":%lu,\"duration_ms\":%lu,\"fps\":%.2f,\"detections_per_s\":%.2f,\"cpu_load\":%.1f,",
+         (unsigned long) bench_frame_nb, (unsigned long) duration_ms, fps, dps, cpu_load);
+  printf("\"captured\":%lu,\"drops\":{", (unsigned long) (bench_captured - bench_start.captured));
+  for (i = 0; i < BENCH_QUEUE_NB; i++)
+    printf("%s\"%s\":%lu", i ? "," : "", bench_queue_names[i],
+           (unsigned long) (bench_drops[i] - bench_start.drops[i]));
+  printf("},\"latency_us\":{");
+  for (i = 0; i < BENCH_STAGE_NB; i++) {
+    bench_compute_stats(i, &stats);
+    printf("%s\"%s\":{\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu}",
+           i ? "," : "", bench_stage_names[i], (unsigned long) bench_sample_nb[i], (unsigned long) stats.min,
+           (unsigned long) stats.avg, (unsigned long) stats.p50, (unsigned long) stats.p90,
+           (unsigned long) stats.p99, (unsigned long) stats.max);
+  }
+  printf("}}\n");
+
+  bench_report_nb++;
+}
+
+void BENCH_Init()
+{
+  bench_state = BENCH_STATE_WARMUP;
+  bench_frame_nb = 0;
+  bench_report_nb = 0;
+  printf("bench: warmup %d frames then report every %d frames\n", BENCHMARK_WARMUP_NB, BENCHMARK_FRAME_NB);
+}
+
+uint32_t BENCH_Now()
+{
+  return DWT->CYCCNT;
+}
+
+void BENCH_FrameCaptured()
+{
+  bench_captured++;
+}
+
+void BENCH_QueueDrop(BENCH_Queue_t queue)
+{
+  bench_drops[queue]++;
+}
+
+void BENCH_StageDone(BENCH_Stage_t stage, uint32_t start)
+{
+  uint32_t us = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+
+  taskENTER_CRITICAL();
+  if (bench_state == BENCH_STATE_RUN && bench_sample_nb[stage] < BENCHMARK_FRAME_NB)
+    bench_samples[stage][bench_sample_nb[stage]++] = us;
+  taskEXIT_CRITICAL();
+}
+
+void BENCH_FrameDone(int nb_detect)
+{
+  bench_frame_nb++;
+
+  if (bench_state == BENCH_STATE_WARMUP) {
+    if (bench_frame_nb >= BENCHMARK_WARMUP_NB)
+      bench_window_start();
+    return;
+  }
+
+  bench_detect_nb += nb_detect;
+  if (bench_frame_nb < BENCHMARK_FRAME_NB)
+    return;
+
+  bench_report();
+  bench_window_start();
+}
+
+#endif
@@ -62,7 +62,10 @@ static void DCMIPP_PipeInitDisplay(int sensor_width, int sensor_height)
   assert(hw_pitch == dcmipp_conf.output_width * dcmipp_conf.output_bpp);
 }
 
-static void DCMIPP_PipeInitNn(int sensor_width, int sensor_height)
+/* nn full field of view, in sensor pixels. Nn pipe roi are taken inside it */
+static CMW_Manual_roi_area_t nn_field;
+
+static void DCMIPP_PipeSetNn(CMW_Manual_roi_area_t *roi)
 {
   CMW_DCMIPP_Conf_t dcmipp_conf;
   uint32_t hw_pitch;
@@ -75,12 +78,18 @@ static void DCMIPP_PipeInitNn(int sensor_width, int sensor_height)
   dcmipp_conf.mode = CMW_Aspect_ratio_manual_roi;
   dcmipp_conf.enable_swap = 1;
   dcmipp_conf.enable_gamma_conversion = 0;
-  CAM_InitCropConfig(&dcmipp_conf.manual_conf, sensor_width, sensor_height);
+  dcmipp_conf.manual_conf = *roi;
   ret = CMW_CAMERA_SetPipeConfig(DCMIPP_PIPE2, &dcmipp_conf, &hw_pitch);
   assert(ret == HAL_OK);
   assert(hw_pitch == dcmipp_conf.output_width * dcmipp_conf.output_bpp);
 }
 
+static void DCMIPP_PipeInitNn(int sensor_width, int sensor_height)
+{
+  CAM_InitCropConfig(&nn_field, sensor_width, sensor_height);
+  DCMIPP_PipeSetNn(&nn_field);
+}
+
 void CAM_Init(void)
 {
   CMW_CameraInit_t cam_conf;
@@ -117,6 +126,34 @@ void CAM_NNPipe_Start(uint8_t *nn_pipe_dst, uint32_t cam_mode)
   assert(ret == CMW_ERROR_NONE);
 }
 
+float CAM_NNPipe_GetRoiMinSize(void)
+{
+  /* dcmipp can only downscale */
+  return MIN(1.0f, MAX((float) NN_WIDTH / nn_field.width, (float) NN_HEIGHT / nn_field.height));
+}
+
+void CAM_NNPipe_SetRoi(zoom_roi_t *roi)
+{
+  CMW_Manual_roi_area_t area;
+
+  /* even sizes and offsets keep bayer / yuv pixel pairs together */
+  area.width = MAX((uint32_t) (roi->size * nn_field.width) & ~1U, NN_WIDTH);
+  area.height = MAX((uint32_t) (roi->size * nn_field.height) & ~1U, NN_HEIGHT);
+  area.width = MIN(area.width, nn_field.width);
+  area.height = MIN(area.height, nn_field.height);
+  area.offset_x = MIN((uint32_t) (roi->x * nn_field.width) & ~1U, nn_field.width - area.width);
+  area.offset_y = MIN((uint32_t) (roi->y * nn_field.height) & ~1U, nn_field.height - area.height);
+
+  /* report what is really captured so detections are mapped back exactly */
+  roi->size = (float) area.width / nn_field.width;
+  roi->x = (float) area.offset_x / nn_field.width;
+  roi->y = (float) area.offset_y / nn_field.height;
+
+  area.offset_x += nn_field.offset_x;
+  area.offset_y += nn_field.offset_y;
+  DCMIPP_PipeSetNn(&area);
+}
+
 void CAM_IspUpdate(void)
 {
   int ret;
@@ -0,0 +1,269 @@
+ /**
+ ******************************************************************************
+ * @file    app_metadata.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_metadata.h"
+
+#ifdef USE_METADATA
+
+#include <assert.h>
+#include <math.h>
+
+#include "stm32n6xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#define META_HEADER_SIZE 6
+#define META_FRAME_SIZE 22
+#define META_BOX_SIZE 14
+#define META_CRC_SIZE 2
+#define META_RECORD_MAX (META_HEADER_SIZE + META_FRAME_SIZE + META_BOX_MAX * META_BOX_SIZE + META_CRC_SIZE)
+#define META_BUSY_RETRY_MS 2
+
+typedef struct {
+  int len;
+  uint8_t data[META_RECORD_MAX];
+} meta_record_t;
+
+extern UART_HandleTypeDef huart1;
+
+/* single producer (record builder) / single consumer (sender thread) ring */
+static meta_record_t meta_records[METADATA_QUEUE_NB];
+static volatile uint32_t meta_head;
+static volatile uint32_t meta_tail;
+static meta_record_t *meta_current;
+static uint32_t meta_frame_id;
+static volatile uint32_t meta_stage_us[META_STAGE_NB];
+static SemaphoreHandle_t meta_ready_sem;
+static StaticSemaphore_t meta_ready_sem_buffer;
+static SemaphoreHandle_t meta_tx_sem;
+static StaticSemaphore_t meta_tx_sem_buffer;
+static SemaphoreHandle_t meta_uart_lock;
+static StaticSemaphore_t meta_uart_lock_buffer;
+static StaticTask_t meta_thread;
+static StackType_t meta_thread_stack[configMINIMAL_STACK_SIZE];
+
+static uint8_t *meta_put_u8(uint8_t *p, uint8_t v)
+{
+  *p++ = v;
+
+  return p;
+}
+
+static uint8_t *meta_put_u16(uint8_t *p, uint16_t v)
+{
+  *p++ = v;
+  *p++ = v >> 8;
+
+  return p;
+}
+
+static uint8_t *meta_put_u32(uint8_t *p, uint32_t v)
+{
+  p = meta_put_u16(p, v);
+
+  return meta_put_u16(p, v >> 16);
+}
+
+static uint16_t meta_crc16(const uint8_t *data, int len)
+{
+  uint16_t crc = 0xffff;
+  int i;
+
+  while (len--) {
+    crc ^= *data++ << 8;
+    for (i = 0; i < 8; i++)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+
+  return crc;
+}
+
+static int16_t meta_to_fixed(float v)
+{
+  float f = roundf(v * (1 << META_COORD_FRAC_BITS));
+
+  if (f > INT16_MAX)
+    return INT16_MAX;
+  if (f < INT16_MIN)
+    return INT16_MIN;
+
+  return f;
+}
+
+static void meta_thread_fct(void *arg)
+{
+  meta_record_t *rec;
+  int ret;
+
+  while (1) {
+    ret = xSemaphoreTake(meta_ready_sem, portMAX_DELAY);
+    assert(ret == pdTRUE);
+
+    rec = &meta_records[meta_tail % METADATA_QUEUE_NB];
+    /* console output is held until record is sent. Mutex priority inheritance keeps a printf() caller from waiting
+     * on lower priority threads.
+     */
+    ret = xSemaphoreTake(meta_uart_lock, portMAX_DELAY);
+    assert(ret == pdTRUE);
+    /* printf() from interrupt does not take the lock. Uart is busy before any byte is sent so record is never split */
+    while (HAL_UART_Transmit_IT(&huart1, rec->data, rec->len) == HAL_BUSY)
+      vTaskDelay(pdMS_TO_TICKS(META_BUSY_RETRY_MS));
+    ret = xSemaphoreTake(meta_tx_sem, portMAX_DELAY);
+    assert(ret == pdTRUE);
+    xSemaphoreGive(meta_uart_lock);
+    meta_tail++;
+  }
+}
+
+void META_Init()
+{
+  const UBaseType_t meta_priority = tskIDLE_PRIORITY + 1;
+  TaskHandle_t hdl;
+
+  meta_ready_sem = xSemaphoreCreateCountingStatic(METADATA_QUEUE_NB, 0, &meta_ready_sem_buffer);
+  assert(meta_ready_sem);
+  meta_tx_sem = xSemaphoreCreateBinaryStatic(&meta_tx_sem_buffer);
+  assert(meta_tx_sem);
+  meta_uart_lock = xSemaphoreCreateMutexStatic(&meta_uart_lock_buffer);
+  assert(meta_uart_lock);
+
+  /* irq priority has already been lowered below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY at boot */
+  HAL_NVIC_EnableIRQ(USART1_IRQn);
+
+  hdl = xTaskCreateStatic(meta_thread_fct, "meta", configMINIMAL_STACK_SIZE, NULL, meta_priority, meta_thread_stack,
+                          &meta_thread);
+  assert(hdl != NULL);
+}
+
+uint32_t META_Now()
+{
+  return DWT->CYCCNT;
+}
+
+void META_StageDone(META_Stage_t stage, uint32_t start)
+{
+  meta_stage_us[stage] = (DWT->CYCCNT - start) / (SystemCoreClock / 1000000);
+}
+
+void META_FrameBegin(int is_tracks)
+{
+  uint8_t *p;
+
+  meta_frame_id++;
+  meta_current = NULL;
+  if (meta_head - meta_tail >= METADATA_QUEUE_NB)
+    return;
+
+  meta_current = &meta_records[meta_head % METADATA_QUEUE_NB];
+  p = meta_current->data;
+  p = meta_put_u8(p, META_SYNC0);
+  p = meta_put_u8(p, META_SYNC1);
+  p = meta_put_u8(p, META_VERSION);
+  p = meta_put_u8(p, META_TYPE_FRAME);
+  /* payload length is patched by META_FrameEnd() */
+  p = meta_put_u16(p, 0);
+  p = meta_put_u32(p, meta_frame_id);
+  p = meta_put_u32(p, HAL_GetTick());
+  p = meta_put_u32(p, meta_stage_us[META_STAGE_INFERENCE]);
+  p = meta_put_u32(p, meta_stage_us[META_STAGE_PP]);
+  p = meta_put_u32(p, is_tracks ? meta_stage_us[META_STAGE_TRACKING] : 0);
+  p = meta_put_u8(p, is_tracks ? META_FLAG_TRACKS : 0);
+  p = meta_put_u8(p, 0);
+  meta_current->len = p - meta_current->data;
+}
+
+void META_AddBox(uint32_t id, float cx, float cy, float w, float h, float conf, int class_index)
+{
+  uint8_t *flags;
+  uint8_t *p;
+
+  if (!meta_current)
+    return;
+
+  flags = &meta_current->data[META_HEADER_SIZE + META_FRAME_SIZE - 2];
+  if (flags[1] == META_BOX_MAX) {
+    flags[0] |= META_FLAG_TRUNCATED;
+    return;
+  }
+
+  p = &meta_current->data[meta_current->len];
+  p = meta_put_u32(p, id);
+  p = meta_put_u16(p, meta_to_fixed(cx));
+  p = meta_put_u16(p, meta_to_fixed(cy));
+  p = meta_put_u16(p, meta_to_fixed(w));
+  p = meta_put_u16(p, meta_to_fixed(h));
+  p = meta_put_u8(p, conf <= 0 ? 0 : conf >= 1 ? 255 : lroundf(conf * 255));
+  p = meta_put_u8(p, class_index);
+  meta_current->len = p - meta_current->data;
+  flags[1]++;
+}
+
+void META_FrameEnd()
+{
+  uint8_t *p;
+
+  if (!meta_current)
+    return;
+
+  meta_put_u16(&meta_current->data[4], meta_current->len - META_HEADER_SIZE);
+  p = &meta_current->data[meta_current->len];
+  meta_put_u16(p, meta_crc16(&meta_current->data[2], meta_current->len - 2));
+  meta_current->len += META_CRC_SIZE;
+  meta_current = NULL;
+
+  meta_head++;
+  xSemaphoreGive(meta_ready_sem);
+}
+
+int META_UartLock()
+{
+  int ret;
+
+  if (!meta_uart_lock || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING || xPortIsInsideInterrupt())
+    return 0;
+
+  ret = xSemaphoreTake(meta_uart_lock, portMAX_DELAY);
+  assert(ret == pdTRUE);
+
+  return 1;
+}
+
+void META_UartUnlock(int is_locked)
+{
+  if (is_locked)
+    xSemaphoreGive(meta_uart_lock);
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+  if (huart != &huart1)
+    return;
+
+  xSemaphoreGiveFromISR(meta_tx_sem, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart1);
+}
+
+#endif
@@ -0,0 +1,99 @@
+ /**
+ ******************************************************************************
+ * @file    app_nninput.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nninput.h"
+
+#ifdef USE_NN_SIGNED_INPUT
+
+#include <assert.h>
+#include <stdio.h>
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#endif
+
+#include "app_nnlayer.h"
+#include "core_common.h"
+#include "core_convert.h"
+#include "core_private.h"
+
+/* first layer input tensor once conversion layer is unlinked, NULL if network was left as is */
+static ai_tensor *nnin_tensor;
+
+/* q_s8 = q_u8 - 128 is a sign bit flip, so both quantized tensors must share scale and differ by 128 in zero point */
+static int nnin_is_sign_flip(ai_tensor *in, ai_tensor *out)
+{
+  if (!in || !out || !in->data || !out->data)
+    return 0;
+  if (AI_TENSOR_FMT_GET_SIGN(in) || AI_TENSOR_FMT_GET_BITS(in) != 8)
+    return 0;
+  if (!AI_TENSOR_FMT_GET_SIGN(out) || AI_TENSOR_FMT_GET_BITS(out) != 8)
+    return 0;
+  if (AI_TENSOR_INTEGER_GET_SIZE(in) != 1 || AI_TENSOR_INTEGER_GET_SIZE(out) != 1)
+    return 0;
+  if (AI_TENSOR_INTEGER_GET_SCALE(in, 0) != AI_TENSOR_INTEGER_GET_SCALE(out, 0))
+    return 0;
+  if (AI_TENSOR_INTEGER_GET_ZEROPOINT_U8(in, 0) - 128 != AI_TENSOR_INTEGER_GET_ZEROPOINT_I8(out, 0))
+    return 0;
+
+  return in->data->size <= out->data->size;
+}
+
+void NNIN_Init(ai_handle network)
+{
+  ai_node *node = NNLAYER_EditFirst(network);
+  ai_tensor *in;
+  ai_tensor *out;
+
+  in = node ? GET_TENSOR_IN(node->tensors, 0) : NULL;
+  out = node ? GET_TENSOR_OUT(node->tensors, 0) : NULL;
+  if (!node || !NNLAYER_Next(node) || node->forward != node_convert_integer || !nnin_is_sign_flip(in, out)) {
+    printf("nninput: first layer is not an u8 to s8 conversion, network input left as is\n");
+    return;
+  }
+
+  /* runtime starts from input_node, so conversion layer is never executed again. Its output array is rebound to
+   * each frame by NNIN_Convert() and its activation slot is left unused.
+   */
+  NNLAYER_Unlink(network, NULL, node);
+  nnin_tensor = out;
+  printf("nninput: layer %u unlinked, %lu bytes input converted in place\n", node->id,
+         (unsigned long) AI_TENSOR_ARRAY_BYTE_SIZE(in));
+}
+
+void NNIN_Convert(uint8_t *buffer, uint32_t len)
+{
+  uint32_t i = 0;
+
+  if (!nnin_tensor)
+    return;
+
+#if defined(__ARM_FEATURE_MVE)
+  for (; i + 16 <= len; i += 16)
+    vst1q_u8(&buffer[i], veorq_u8(vld1q_u8(&buffer[i]), vdupq_n_u8(0x80)));
+#else
+  assert(((uintptr_t) buffer & 3) == 0);
+  for (; i + 4 <= len; i += 4)
+    *(uint32_t *) &buffer[i] ^= 0x80808080;
+#endif
+  for (; i < len; i++)
+    buffer[i] ^= 0x80;
+
+  AI_TENSOR_ARRAY_UPDATE_DATA_ADDR(nnin_tensor, buffer);
+}
+
+#endif
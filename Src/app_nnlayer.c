@@ -0,0 +1,57 @@
+ /**
+ ******************************************************************************
+ * @file    app_nnlayer.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nnlayer.h"
+
+#include <assert.h>
+
+static int nnlayer_is_walked;
+
+ai_node *NNLAYER_First(ai_handle network)
+{
+  nnlayer_is_walked = 1;
+
+  return AI_NETWORK_OBJ(network)->input_node;
+}
+
+ai_node *NNLAYER_Next(ai_node *node)
+{
+  /* last layer links to itself */
+  return node->next == node ? NULL : node->next;
+}
+
+ai_node *NNLAYER_EditFirst(ai_handle network)
+{
+  assert(!nnlayer_is_walked);
+
+  return AI_NETWORK_OBJ(network)->input_node;
+}
+
+void NNLAYER_Unlink(ai_handle network, ai_node *prev, ai_node *node)
+{
+  ai_node *next = NNLAYER_Next(node);
+
+  assert(!nnlayer_is_walked);
+  /* runtime needs at least one layer */
+  assert(prev || next);
+  /* last layer links to itself */
+  if (prev)
+    prev->next = next ? next : prev;
+  else
+    AI_NETWORK_OBJ(network)->input_node = next;
+}
@@ -0,0 +1,122 @@
+ /**
+ ******************************************************************************
+ * @file    app_nnoutput.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nnoutput.h"
+
+#ifdef USE_NN_INT8_OUTPUT
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "app_nnlayer.h"
+#include "core_common.h"
+#include "core_convert.h"
+#include "core_private.h"
+
+#define NNOUT_MAX_NB 4
+
+static int nnout_nb;
+/* int8 tensor carrying quantization of each output */
+static ai_tensor *nnout_tensor[NNOUT_MAX_NB];
+/* int8 tensor to rebind to user buffer, NULL when output was generated as int8 and runtime binds it */
+static ai_tensor *nnout_bind[NNOUT_MAX_NB];
+
+static int nnout_is_s8(ai_tensor *t)
+{
+  if (!t || !t->data)
+    return 0;
+  if (AI_TENSOR_FMT_GET_TYPE(t) != AI_BUFFER_FMT_TYPE_Q)
+    return 0;
+  if (!AI_TENSOR_FMT_GET_SIGN(t) || AI_TENSOR_FMT_GET_BITS(t) != 8)
+    return 0;
+
+  return AI_TENSOR_INTEGER_GET_SIZE(t) == 1;
+}
+
+/* Unlink layer producing out when it only dequantizes an int8 tensor of same size. Return that tensor */
+static ai_tensor *nnout_unlink(ai_handle network, ai_tensor *out)
+{
+  ai_node *prev = NULL;
+  ai_node *node;
+  ai_tensor *in;
+
+  for (node = NNLAYER_EditFirst(network); node; node = NNLAYER_Next(node)) {
+    if (GET_TENSOR_OUT(node->tensors, 0) == out)
+      break;
+    prev = node;
+  }
+  if (!node)
+    return NULL;
+
+  in = GET_TENSOR_IN(node->tensors, 0);
+  if (!prev || node->forward != node_convert || !nnout_is_s8(in) || in->data->size != out->data->size)
+    return NULL;
+
+  NNLAYER_Unlink(network, prev, node);
+  printf("nnoutput: layer %u unlinked, %lu bytes output kept as int8\n", node->id,
+         (unsigned long) AI_TENSOR_ARRAY_BYTE_SIZE(in));
+
+  return in;
+}
+
+void NNOUT_Init(ai_handle network)
+{
+  ai_network *net = AI_NETWORK_OBJ(network);
+  ai_tensor *out;
+  ai_tensor *in;
+  int i;
+
+  nnout_nb = GET_TENSOR_LIST_SIZE(GET_TENSOR_LIST_OUT(&net->tensors));
+  assert(nnout_nb <= NNOUT_MAX_NB);
+  for (i = 0; i < nnout_nb; i++) {
+    out = GET_TENSOR_OUT(&net->tensors, i);
+    if (nnout_is_s8(out)) {
+      nnout_tensor[i] = out;
+      continue;
+    }
+
+    /* output buffers are sized for int8, a float output would overflow them */
+    in = nnout_unlink(network, out);
+    if (!in) {
+      printf("nnoutput: output %d is neither int8 nor an int8 conversion\n", i);
+      assert(0);
+    }
+    nnout_tensor[i] = in;
+    nnout_bind[i] = in;
+  }
+}
+
+void NNOUT_Bind(uint8_t *out[])
+{
+  int i;
+
+  for (i = 0; i < nnout_nb; i++) {
+    if (nnout_bind[i])
+      AI_TENSOR_ARRAY_UPDATE_DATA_ADDR(nnout_bind[i], out[i]);
+  }
+}
+
+void NNOUT_GetQuant(int idx, float *scale, int8_t *zero_point)
+{
+  assert(idx < nnout_nb && nnout_tensor[idx]);
+
+  *scale = AI_TENSOR_INTEGER_GET_SCALE(nnout_tensor[idx], 0);
+  *zero_point = AI_TENSOR_INTEGER_GET_ZEROPOINT_I8(nnout_tensor[idx], 0);
+}
+
+#endif
@@ -0,0 +1,204 @@
+ /**
+ ******************************************************************************
+ * @file    app_nnprof.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_nnprof.h"
+
+#ifdef USE_NN_PROFILER
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stm32n6xx_hal.h"
+#include "app_nnlayer.h"
+#include "core_common.h"
+#include "layers_common.h"
+
+#define NNPROF_TYPE_MAX 32
+
+typedef struct {
+  ai_node *node;
+  uint64_t cycles;
+  uint32_t min;
+  uint32_t max;
+  uint16_t type;
+  uint16_t id;
+} nnprof_layer_t;
+
+typedef struct {
+  uint64_t cycles;
+  uint16_t type;
+  uint16_t layer_nb;
+} nnprof_type_t;
+
+static nnprof_layer_t nnprof_layers[NN_PROFILER_LAYER_MAX];
+static uint16_t nnprof_sorted[NN_PROFILER_LAYER_MAX];
+static nnprof_type_t nnprof_types[NNPROF_TYPE_MAX];
+static int nnprof_layer_nb;
+static uint32_t nnprof_run_nb;
+static uint32_t nnprof_report_nb;
+static uint64_t nnprof_run_cycles;
+static uint32_t nnprof_run_start;
+static uint32_t nnprof_layer_start;
+
+static int nnprof_cmp_layer(const void *a, const void *b)
+{
+  uint64_t va = nnprof_layers[*(const uint16_t *) a].cycles;
+  uint64_t vb = nnprof_layers[*(const uint16_t *) b].cycles;
+
+  return (va < vb) - (va > vb);
+}
+
+static int nnprof_cmp_type(const void *a, const void *b)
+{
+  uint64_t va = ((const nnprof_type_t *) a)->cycles;
+  uint64_t vb = ((const nnprof_type_t *) b)->cycles;
+
+  return (va < vb) - (va > vb);
+}
+
+static void nnprof_reset()
+{
+  int i;
+
+  for (i = 0; i < nnprof_layer_nb; i++) {
+    nnprof_layers[i].cycles = 0;
+    nnprof_layers[i].min = UINT32_MAX;
+    nnprof_layers[i].max = 0;
+  }
+  nnprof_run_cycles = 0;
+  nnprof_run_nb = 0;
+}
+
+static int nnprof_aggregate_types()
+{
+  nnprof_layer_t *layer;
+  int type_nb = 0;
+  int i, j;
+
+  for (i = 0; i < nnprof_layer_nb; i++) {
+    layer = &nnprof_layers[i];
+    for (j = 0; j < type_nb; j++)
+      if (nnprof_types[j].type == layer->type)
+        break;
+    if (j == NNPROF_TYPE_MAX)
+      continue;
+    if (j == type_nb) {
+      nnprof_types[j].type = layer->type;
+      nnprof_types[j].cycles = 0;
+      nnprof_types[j].layer_nb = 0;
+      type_nb++;
+    }
+    nnprof_types[j].cycles += layer->cycles;
+    nnprof_types[j].layer_nb++;
+  }
+  qsort(nnprof_types, type_nb, sizeof(nnprof_types[0]), nnprof_cmp_type);
+
+  return type_nb;
+}
+
+/* csv lines prefixed by 'prof,' so host can grep them out of console log. Cycles are averaged per inference */
+static void nnprof_report()
+{
+  nnprof_layer_t *layer;
+  uint64_t layers_cycles = 0;
+  int type_nb;
+  int i;
+
+  for (i = 0; i < nnprof_layer_nb; i++) {
+    layers_cycles += nnprof_layers[i].cycles;
+    nnprof_sorted[i] = i;
+  }
+  qsort(nnprof_sorted, nnprof_layer_nb, sizeof(nnprof_sorted[0]), nnprof_cmp_layer);
+  type_nb = nnprof_aggregate_types();
+
+  printf("prof,begin,%lu,%lu,%lu,%d,%lu,%lu\n", (unsigned long) nnprof_report_nb, (unsigned long) nnprof_run_nb,
+         (unsigned long) SystemCoreClock, nnprof_layer_nb, (unsigned long) (nnprof_run_cycles / nnprof_run_nb),
+         (unsigned long) (layers_cycles / nnprof_run_nb));
+  for (i = 0; i < type_nb; i++)
+    printf("prof,type,%s,%u,%lu,%lu\n", AI_LAYER_TYPE_NAME(nnprof_types[i].type), nnprof_types[i].layer_nb,
+           (unsigned long) (nnprof_types[i].cycles / nnprof_run_nb),
+           (unsigned long) (layers_cycles ? 1000 * nnprof_types[i].cycles / layers_cycles : 0));
+  for (i = 0; i < nnprof_layer_nb; i++) {
+    layer = &nnprof_layers[nnprof_sorted[i]];
+    printf("prof,layer,%u,%u,%s,0x%08lx,%lu,%lu,%lu\n", nnprof_sorted[i], layer->id, AI_LAYER_TYPE_NAME(layer->type),
+           (unsigned long) (layer->node ? (uintptr_t) layer->node->forward : 0),
+           (unsigned long) (layer->cycles / nnprof_run_nb), (unsigned long) layer->min, (unsigned long) layer->max);
+  }
+  printf("prof,end\n");
+
+  nnprof_report_nb++;
+}
+
+static ai_u32 nnprof_on_node(const ai_handle cookie, const ai_u32 flags, const ai_observer_node *node)
+{
+  uint32_t now = DWT->CYCCNT;
+  nnprof_layer_t *layer;
+  uint32_t cycles;
+
+  if (flags & AI_OBSERVER_PRE_EVT) {
+    if (flags & AI_OBSERVER_FIRST_EVT)
+      nnprof_run_start = now;
+    /* take timestamp last so our own processing is not accounted */
+    nnprof_layer_start = DWT->CYCCNT;
+    return 0;
+  }
+
+  cycles = now - nnprof_layer_start;
+  if (node->c_idx < nnprof_layer_nb) {
+    layer = &nnprof_layers[node->c_idx];
+    /* layer list walk and runtime execution order are expected to match. Forward function is unknown otherwise */
+    if (layer->node && layer->node->id != node->id)
+      layer->node = NULL;
+    layer->type = node->type;
+    layer->id = node->id;
+    layer->cycles += cycles;
+    if (cycles < layer->min)
+      layer->min = cycles;
+    if (cycles > layer->max)
+      layer->max = cycles;
+  }
+
+  if (flags & AI_OBSERVER_LAST_EVT) {
+    nnprof_run_cycles += now - nnprof_run_start;
+    if (++nnprof_run_nb == NN_PROFILER_RUN_NB) {
+      nnprof_report();
+      nnprof_reset();
+    }
+  }
+
+  return 0;
+}
+
+void NNPROF_Init(ai_handle network)
+{
+  ai_node *node;
+  int ret;
+
+  for (node = NNLAYER_First(network); node && nnprof_layer_nb < NN_PROFILER_LAYER_MAX; node = NNLAYER_Next(node))
+    nnprof_layers[nnprof_layer_nb++].node = node;
+  if (node)
+    printf("prof: more than %d layers, only first ones are profiled\n", NN_PROFILER_LAYER_MAX);
+  nnprof_reset();
+
+  ret = ai_platform_observer_register(network, nnprof_on_node, NULL, AI_OBSERVER_PRE_EVT | AI_OBSERVER_POST_EVT);
+  assert(ret);
+  printf("prof: %d layers, report every %d inferences\n", nnprof_layer_nb, NN_PROFILER_RUN_NB);
+}
+
+#endif
@@ -0,0 +1,108 @@
+ /**
+ ******************************************************************************
+ * @file    app_telemetry.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_telemetry.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "app_config.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Task numbers are given in creation order so this covers application, screen and usb threads */
+#define TLM_TASK_MAX 24
+
+#ifdef USE_TELEMETRY
+static volatile uint32_t tlm_switch_cnt[TLM_TASK_MAX];
+static StaticTask_t tlm_thread;
+static StackType_t tlm_thread_stack[configMINIMAL_STACK_SIZE];
+static TaskStatus_t tlm_status[TLM_TASK_MAX];
+static configRUN_TIME_COUNTER_TYPE tlm_prev_runtime[TLM_TASK_MAX];
+static uint32_t tlm_prev_switch_cnt[TLM_TASK_MAX];
+
+void TLM_TaskSwitchedIn(uint32_t task_nb)
+{
+  if (task_nb < TLM_TASK_MAX)
+    tlm_switch_cnt[task_nb]++;
+}
+
+static void TLM_Emit(uint32_t ts, configRUN_TIME_COUNTER_TYPE total, int task_nb)
+{
+  configRUN_TIME_COUNTER_TYPE runtime;
+  uint32_t switch_cnt;
+  uint32_t cpu_permille;
+  TaskStatus_t *st;
+  uint32_t nb;
+  int i;
+
+  for (i = 0; i < task_nb; i++) {
+    st = &tlm_status[i];
+    nb = st->xTaskNumber;
+    if (nb >= TLM_TASK_MAX)
+      continue;
+
+    runtime = st->ulRunTimeCounter - tlm_prev_runtime[nb];
+    tlm_prev_runtime[nb] = st->ulRunTimeCounter;
+    switch_cnt = tlm_switch_cnt[nb];
+    cpu_permille = total ? (uint32_t) (((uint64_t) runtime * 1000) / total) : 0;
+
+    /* tlm,ts_ms,task,prio,cpu_permille,stack_free_words,ctx_switches */
+    printf("tlm,%lu,%s,%lu,%lu,%lu,%lu\n", (unsigned long) ts, st->pcTaskName,
+           (unsigned long) st->uxBasePriority, (unsigned long) cpu_permille,
+           (unsigned long) st->usStackHighWaterMark, (unsigned long) (switch_cnt - tlm_prev_switch_cnt[nb]));
+    tlm_prev_switch_cnt[nb] = switch_cnt;
+  }
+}
+
+static void tlm_thread_fct(void *arg)
+{
+  configRUN_TIME_COUNTER_TYPE prev_total = 0;
+  configRUN_TIME_COUNTER_TYPE total;
+  TickType_t last_wake;
+  UBaseType_t task_nb;
+
+  printf("tlm,ts_ms,task,prio,cpu_permille,stack_free_words,ctx_switches\n");
+  last_wake = xTaskGetTickCount();
+  while (1) {
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TELEMETRY_PERIOD_MS));
+
+    task_nb = uxTaskGetSystemState(tlm_status, TLM_TASK_MAX, &total);
+    if (!task_nb) {
+      printf("tlm: more than %d tasks\n", TLM_TASK_MAX);
+      continue;
+    }
+    TLM_Emit(xTaskGetTickCount() * portTICK_PERIOD_MS, total - prev_total, task_nb);
+    prev_total = total;
+  }
+}
+
+void TLM_Init()
+{
+  const UBaseType_t tlm_priority = tskIDLE_PRIORITY + configMAX_PRIORITIES / 2 - 1;
+  TaskHandle_t hdl;
+
+  hdl = xTaskCreateStatic(tlm_thread_fct, "tlm", configMINIMAL_STACK_SIZE, NULL, tlm_priority, tlm_thread_stack,
+                          &tlm_thread);
+  assert(hdl != NULL);
+}
+#else
+void TLM_Init()
+{
+}
+#endif
@@ -0,0 +1,145 @@
+ /**
+ ******************************************************************************
+ * @file    app_text.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_text.h"
+
+#include <string.h>
+
+#include "scrl_raster.h"
+
+#define TXT_ARGB8888_TO_ARGB4444(_c_) ((((_c_) >> 16) & 0xf000) | (((_c_) >> 12) & 0x0f00) | \
+                                       (((_c_) >> 8) & 0x00f0) | (((_c_) >> 4) & 0x000f))
+
+static struct {
+  int width;
+  int height;
+  uint16_t *atlas;
+} txt;
+
+static const uint16_t *txt_glyph(char c)
+{
+  if (c < TXT_GLYPH_FIRST || c > TXT_GLYPH_LAST)
+    c = '?';
+
+  return &txt.atlas[(c - TXT_GLYPH_FIRST) * txt.width * txt.height];
+}
+
+static void txt_blit(uint16_t *fb, int fb_width, int x, int y, const uint16_t *src, int pitch, int w, int h)
+{
+  SCRR_CopyRect16(fb + y * fb_width + x, fb_width, (const uint8_t *) src, pitch, w, h);
+}
+
+int TXT_Init(sFONT *font, uint32_t text_color, uint32_t back_color, uint16_t *atlas, int atlas_pixels)
+{
+  const int bytes_per_row = (font->Width + 7) / 8;
+  uint16_t fg = TXT_ARGB8888_TO_ARGB4444(text_color);
+  uint16_t bg = TXT_ARGB8888_TO_ARGB4444(back_color);
+  const uint8_t *row;
+  uint16_t *dst;
+  int c, i, j;
+
+  if (atlas_pixels < TXT_ATLAS_PIXELS(font->Width, font->Height))
+    return -1;
+
+  txt.width = font->Width;
+  txt.height = font->Height;
+  txt.atlas = atlas;
+
+  /* Same glyph layout as lcd utility: height rows of msb first bits, padded to bytes */
+  dst = atlas;
+  for (c = 0; c < TXT_GLYPH_NB; c++) {
+    row = &font->table[c * txt.height * bytes_per_row];
+    for (i = 0; i < txt.height; i++, row += bytes_per_row)
+      for (j = 0; j < txt.width; j++)
+        *dst++ = (row[j / 8] & (0x80 >> (j % 8))) ? fg : bg;
+  }
+
+  return 0;
+}
+
+int TXT_GetGlyphWidth()
+{
+  return txt.width;
+}
+
+int TXT_GetGlyphHeight()
+{
+  return txt.height;
+}
+
+int TXT_RenderString(const char *text, TXT_Bitmap_t *bmp, uint16_t *pixels, int pixels_nb)
+{
+  int len = strlen(text);
+  int i;
+
+  if (len * txt.width * txt.height > pixels_nb)
+    return -1;
+
+  bmp->width = len * txt.width;
+  bmp->height = txt.height;
+  bmp->pitch = bmp->width;
+  bmp->pixels = pixels;
+  for (i = 0; i < len; i++)
+    txt_blit(pixels, bmp->pitch, i * txt.width, 0, txt_glyph(text[i]), txt.width, txt.width, txt.height);
+
+  return 0;
+}
+
+int TXT_DrawBitmap(uint16_t *fb, int fb_width, int fb_height, int x, int y, const TXT_Bitmap_t *bmp)
+{
+  const uint16_t *src = bmp->pixels;
+  int w = bmp->width;
+  int h = bmp->height;
+
+  if (x < 0) {
+    src -= x;
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    src -= y * bmp->pitch;
+    h += y;
+    y = 0;
+  }
+  w = w < fb_width - x ? w : fb_width - x;
+  h = h < fb_height - y ? h : fb_height - y;
+  if (w <= 0 || h <= 0)
+    return 0;
+
+  txt_blit(fb, fb_width, x, y, src, bmp->pitch, w, h);
+
+  return w;
+}
+
+int TXT_DrawString(uint16_t *fb, int fb_width, int fb_height, int x, int y, const char *text)
+{
+  TXT_Bitmap_t glyph = {
+    .width = txt.width,
+    .height = txt.height,
+    .pitch = txt.width,
+  };
+  int x0 = x;
+
+  /* only draw glyphs that fully fit on the line */
+  for (; *text && x + txt.width <= fb_width; text++, x += txt.width) {
+    glyph.pixels = txt_glyph(*text);
+    TXT_DrawBitmap(fb, fb_width, fb_height, x, y, &glyph);
+  }
+
+  return x - x0;
+}
@@ -0,0 +1,179 @@
+ /**
+ ******************************************************************************
+ * @file    app_trace.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_trace.h"
+
+#ifdef USE_TRACE
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "stm32n6xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) != 0
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+
+#define TRC_TASK_MAX 24
+#define TRC_CONSOLE_POLL_MS 50
+
+typedef struct {
+  uint32_t ts;
+  /* isr number or task handle */
+  uint32_t ctx;
+  uint16_t id;
+  uint8_t type;
+  uint8_t reserved;
+  uint32_t arg;
+} trc_record_t;
+
+static const char * const trc_names[TRC_ID_NB] = {
+  [TRC_ID_NN_RUN] = "nn_run",
+  [TRC_ID_NN_WAIT] = "nn_wait",
+  [TRC_ID_PP_RUN] = "pp_run",
+  [TRC_ID_PP_TRACK] = "pp_track",
+  [TRC_ID_DP_DRAW] = "dp_draw",
+  [TRC_ID_DP_CACHE] = "dp_cache_clean",
+  [TRC_ID_ISP_UPDATE] = "isp_update",
+  [TRC_ID_GOV_UPDATE] = "gov_update",
+  [TRC_ID_GOV_IDLE] = "gov_idle",
+  [TRC_ID_CAM_VSYNC] = "cam_vsync",
+  [TRC_ID_CAM_FRAME] = "cam_frame",
+  [TRC_ID_NN_FRAME_DROP] = "nn_frame_drop",
+  [TRC_ID_NN_MISS] = "nn_miss",
+  [TRC_ID_NN_DEGRADE] = "nn_degrade",
+  [TRC_ID_SCRL_UPDATE] = "scrl_update",
+  [TRC_ID_SCRL_DMA2D] = "scrl_dma2d",
+  [TRC_ID_SCRL_YUV] = "scrl_yuv",
+  [TRC_ID_SCRL_SHOW] = "scrl_show",
+  [TRC_ID_SCRL_RELEASE] = "scrl_release",
+  [TRC_ID_SCRL_SPI] = "scrl_spi",
+  [TRC_ID_SCRL_CPU_COMPOSE] = "scrl_cpu_compose",
+  [TRC_ID_SCRL_JPEG] = "scrl_jpeg",
+};
+
+extern UART_HandleTypeDef huart1;
+
+/* mem_plan(run, trace builds): event trace ring */
+static trc_record_t trc_ring[TRACE_RING_SIZE];
+static volatile uint32_t trc_head;
+static volatile int trc_is_enabled;
+static TaskStatus_t trc_tasks[TRC_TASK_MAX];
+static StaticTask_t trc_thread;
+static StackType_t trc_thread_stack[configMINIMAL_STACK_SIZE];
+
+void TRC_Record(uint32_t type, uint32_t id, uint32_t arg)
+{
+  trc_record_t *rec;
+  uint32_t ipsr;
+  uint32_t idx;
+
+  if (!trc_is_enabled)
+    return;
+
+  /* reserve a slot. A thread or isr preempting us between ldrex and strex makes strex fail and we retry */
+  do {
+    idx = __LDREXW(&trc_head);
+  } while (__STREXW(idx + 1, &trc_head));
+
+  rec = &trc_ring[idx & (TRACE_RING_SIZE - 1)];
+  rec->ts = DWT->CYCCNT;
+  ipsr = __get_IPSR();
+  rec->ctx = ipsr ? ipsr : (uint32_t) xTaskGetCurrentTaskHandle();
+  rec->id = id;
+  rec->type = type;
+  rec->arg = arg;
+}
+
+void TRC_Dump()
+{
+  trc_record_t *rec;
+  UBaseType_t task_nb;
+  uint32_t start;
+  uint32_t head;
+  uint32_t i;
+
+  trc_is_enabled = 0;
+  head = trc_head;
+  start = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+
+  printf("trc,begin,%lu,%lu\n", (unsigned long) SystemCoreClock, (unsigned long) (head - start));
+  task_nb = uxTaskGetSystemState(trc_tasks, TRC_TASK_MAX, NULL);
+  for (i = 0; i < task_nb; i++)
+    printf("trc,ctx,%lx,%s\n", (unsigned long) trc_tasks[i].xHandle, trc_tasks[i].pcTaskName);
+  for (i = 0; i < TRC_ID_NB; i++)
+    printf("trc,name,%lu,%s\n", (unsigned long) i, trc_names[i]);
+  for (i = start; i < head; i++) {
+    rec = &trc_ring[i & (TRACE_RING_SIZE - 1)];
+    printf("trc,evt,%lu,%lx,%u,%u,%lu\n", (unsigned long) rec->ts, (unsigned long) rec->ctx, rec->id, rec->type,
+           (unsigned long) rec->arg);
+  }
+  printf("trc,end\n");
+
+  trc_head = 0;
+  trc_is_enabled = 1;
+}
+
+static int trc_console_getc()
+{
+  if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_ORE))
+    __HAL_UART_CLEAR_FLAG(&huart1, UART_CLEAR_OREF);
+  if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_RXNE))
+    return -1;
+
+  return huart1.Instance->RDR & 0xff;
+}
+
+static void trc_thread_fct(void *arg)
+{
+  int c;
+
+  while (1) {
+    vTaskDelay(pdMS_TO_TICKS(TRC_CONSOLE_POLL_MS));
+
+    c = trc_console_getc();
+    switch (c) {
+    case 'd':
+      TRC_Dump();
+      break;
+    case 'c':
+      trc_head = 0;
+      printf("trc,clear\n");
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void TRC_Init()
+{
+  const UBaseType_t trc_priority = tskIDLE_PRIORITY + configMAX_PRIORITIES / 2 - 1;
+  TaskHandle_t hdl;
+
+  trc_head = 0;
+  trc_is_enabled = 1;
+
+  hdl = xTaskCreateStatic(trc_thread_fct, "trc", configMINIMAL_STACK_SIZE, NULL, trc_priority, trc_thread_stack,
+                          &trc_thread);
+  assert(hdl != NULL);
+}
+
+#endif
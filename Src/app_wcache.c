@@ -0,0 +1,170 @@
+ /**
+ ******************************************************************************
+ * @file    app_wcache.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "app_wcache.h"
+
+#ifdef USE_WEIGHT_CACHE
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stm32n6xx_hal.h"
+#include "ai_datatypes_internal.h"
+#include "app_nnlayer.h"
+#include "core_common.h"
+#include "network.h"
+
+#define WCACHE_ALIGN 32
+#define WCACHE_ALIGN_VALUE(_v_) (((_v_) + WCACHE_ALIGN - 1) & ~(WCACHE_ALIGN - 1))
+
+typedef void (*wcache_visit_fct)(ai_array *array, uint32_t size, uint32_t reuse, void *arg);
+
+typedef struct {
+  ai_network_report *report;
+  ai_array *array;
+  uint32_t size;
+  uint32_t reuse;
+} wcache_hottest_t;
+
+/* nn activations leave about 800K of AXISRAM3_6 free */
+/* mem_plan(run, weight cache builds): copies of most reused nn weight tensors, read by every inference */
+__attribute__ ((section (".npuram_bss")))
+__attribute__ ((aligned (WCACHE_ALIGN)))
+static uint8_t wcache_pool[WEIGHT_CACHE_SIZE];
+static uint32_t wcache_used;
+
+/* Weights of a layer are read again for each output pixel, so output plane size is their reuse count */
+static uint32_t wcache_layer_reuse(ai_node *node)
+{
+  ai_tensor *out = GET_TENSOR_OUT(node->tensors, 0);
+
+  if (!out)
+    return 1;
+
+  return AI_SHAPE_H(&out->shape) * AI_SHAPE_W(&out->shape);
+}
+
+static void wcache_visit(ai_handle network, wcache_visit_fct fct, void *arg)
+{
+  ai_node *node;
+  ai_tensor_list *weights;
+  ai_tensor *tensor;
+  uint32_t reuse;
+  int i;
+
+  for (node = NNLAYER_First(network); node; node = NNLAYER_Next(node)) {
+    weights = node->tensors ? GET_TENSOR_LIST_WEIGTHS(node->tensors) : NULL;
+    reuse = GET_TENSOR_LIST_SIZE(weights) ? wcache_layer_reuse(node) : 0;
+    for (i = 0; i < GET_TENSOR_LIST_SIZE(weights); i++) {
+      tensor = GET_TENSOR_LIST_ITEM(weights, i);
+      if (tensor && tensor->data)
+        fct(tensor->data, AI_ARRAY_GET_BYTE_SIZE(tensor->data->format, tensor->data->size), reuse, arg);
+    }
+  }
+}
+
+static int wcache_is_external(ai_network_report *report, ai_ptr addr)
+{
+  ai_buffer *buf;
+  int i;
+
+  for (i = 0; i < report->map_weights.size; i++) {
+    buf = &report->map_weights.buffer[i];
+    if (addr >= (ai_ptr) buf->data && addr < (ai_ptr) buf->data + buf->size)
+      return 1;
+  }
+
+  return 0;
+}
+
+/* Tensors below WEIGHT_CACHE_MIN_SIZE stay in dcache while being reused, moving them saves a single read */
+static void wcache_count_reads(ai_array *array, uint32_t size, uint32_t reuse, void *arg)
+{
+  uint64_t *reads = arg;
+
+  if (size >= WEIGHT_CACHE_MIN_SIZE)
+    *reads += (uint64_t) size * reuse;
+}
+
+static void wcache_find_hottest(ai_array *array, uint32_t size, uint32_t reuse, void *arg)
+{
+  wcache_hottest_t *hot = arg;
+
+  if (size < WEIGHT_CACHE_MIN_SIZE || !wcache_is_external(hot->report, array->data_start))
+    return;
+  if (wcache_used + WCACHE_ALIGN_VALUE(size) > WEIGHT_CACHE_SIZE)
+    return;
+  if (hot->array && (reuse < hot->reuse || (reuse == hot->reuse && size <= hot->size)))
+    return;
+
+  hot->array = array;
+  hot->size = size;
+  hot->reuse = reuse;
+}
+
+static void wcache_move(ai_array *array, uint32_t size)
+{
+  uint8_t *dst = &wcache_pool[wcache_used];
+
+  memcpy(dst, array->data_start, size);
+  array->data = dst + ((uint8_t *) array->data - (uint8_t *) array->data_start);
+  array->data_start = dst;
+  wcache_used += WCACHE_ALIGN_VALUE(size);
+}
+
+void WCACHE_Init(ai_handle network)
+{
+  ai_network_report report;
+  wcache_hottest_t hot;
+  uint64_t total_reads = 0;
+  uint64_t moved_reads = 0;
+  uint32_t moved_nb = 0;
+  uint32_t ts;
+  int ret;
+
+  ret = ai_network_get_report(network, &report);
+  assert(ret);
+
+  ts = HAL_GetTick();
+  wcache_visit(network, wcache_count_reads, &total_reads);
+  /* greedy placement in decreasing reuse order. Weights are constant and read by cpu only, so no cache maintenance
+   * is needed once copied.
+   */
+  while (1) {
+    hot.report = &report;
+    hot.array = NULL;
+    wcache_visit(network, wcache_find_hottest, &hot);
+    if (!hot.array)
+      break;
+    wcache_move(hot.array, hot.size);
+    moved_reads += (uint64_t) hot.size * hot.reuse;
+    moved_nb++;
+  }
+
+  printf("wcache: %lu tensors, %lu / %d bytes in %lu ms, %.1f%% of large tensor reads from internal ram\n",
+         (unsigned long) moved_nb, (unsigned long) wcache_used, WEIGHT_CACHE_SIZE,
+         (unsigned long) (HAL_GetTick() - ts), total_reads ? 100.0 * moved_reads / total_reads : 0.0);
+}
+
+uint32_t WCACHE_Used()
+{
+  return wcache_used;
+}
+
+#endif
@@ -0,0 +1,93 @@
+ /**
+ ******************************************************************************
+ * @file    deadline.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "deadline.h"
+
+#include <string.h>
+
+/* upper bounds of histogram buckets in percent of budget. Finer around budget, coarse in tail */
+static const uint32_t dl_hist_pct[DL_HIST_NB - 1] = {50, 75, 100, 125, 150, 200, 300};
+
+int dl_init(dl_ctx_t *ctx, dl_conf_t *cfg)
+{
+  if (cfg->budget_ms == 0 || cfg->window < 1 || cfg->window > DL_WINDOW_MAX)
+    return -1;
+  if (cfg->degrade_nb < 1 || cfg->degrade_nb > cfg->window || cfg->recover_nb < 0 ||
+      cfg->recover_nb >= cfg->degrade_nb)
+    return -1;
+
+  ctx->cfg = *cfg;
+  ctx->window = 0;
+  memset(&ctx->st, 0, sizeof(ctx->st));
+
+  return 0;
+}
+
+uint32_t dl_hist_bound(const dl_ctx_t *ctx, int idx)
+{
+  if (idx >= DL_HIST_NB - 1)
+    return UINT32_MAX;
+
+  return ctx->cfg.budget_ms * dl_hist_pct[idx] / 100;
+}
+
+/* Misses are counted over a sliding window rather than in a row, so a scene where every other inference is late
+ * degrades too. Recovery threshold is lower than degrade one so mode doesn't toggle at each inference.
+ */
+int dl_update(dl_ctx_t *ctx, uint32_t ms, uint32_t error)
+{
+  const dl_conf_t *cfg = &ctx->cfg;
+  dl_stats_t *st = &ctx->st;
+  int is_miss;
+  int i;
+
+  st->run_nb++;
+  st->last_ms = ms;
+  if (ms > st->worst_ms)
+    st->worst_ms = ms;
+  for (i = 0; i < DL_HIST_NB - 1; i++) {
+    if (ms < dl_hist_bound(ctx, i))
+      break;
+  }
+  st->hist[i]++;
+  if (error) {
+    st->error_nb++;
+    st->error = error;
+    st->error_run = st->run_nb;
+  }
+
+  is_miss = error || ms > cfg->budget_ms;
+  st->miss_nb += is_miss;
+  st->window_miss_nb -= (ctx->window >> (cfg->window - 1)) & 1;
+  st->window_miss_nb += is_miss;
+  ctx->window = (ctx->window << 1) | is_miss;
+  if (cfg->window < DL_WINDOW_MAX)
+    ctx->window &= (1U << cfg->window) - 1;
+
+  if (!st->is_degraded && st->window_miss_nb >= cfg->degrade_nb) {
+    st->is_degraded = 1;
+    st->degrade_nb++;
+    return 1;
+  }
+  if (st->is_degraded && st->window_miss_nb <= cfg->recover_nb) {
+    st->is_degraded = 0;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,176 @@
+ /**
+ ******************************************************************************
+ * @file    governor.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "governor.h"
+
+/* Don't go back to a faster setpoint until cpu load is this amount below budget */
+#define GOV_AIMD_HYSTERESIS 5.0
+#define GOV_AIMD_PERIOD_STEP_MS 20
+/* Don't relax post process settings until post process time is this percentage below target */
+#define GOV_AIMD_PP_HYSTERESIS 25
+
+static uint32_t gov_clamp_u32(uint32_t v, uint32_t min, uint32_t max)
+{
+  if (v < min)
+    return min;
+  if (v > max)
+    return max;
+
+  return v;
+}
+
+static int gov_clamp_int(int v, int min, int max)
+{
+  if (v < min)
+    return min;
+  if (v > max)
+    return max;
+
+  return v;
+}
+
+static float gov_clamp_float(float v, float min, float max)
+{
+  if (v < min)
+    return min;
+  if (v > max)
+    return max;
+
+  return v;
+}
+
+static void gov_default_init(void *priv, const gov_conf_t *cfg, gov_setpoint_t *sp)
+{
+  sp->nn_period_ms = cfg->nn_period_min_ms;
+  sp->conf_threshold = cfg->conf_min;
+  sp->max_boxes = cfg->max_boxes_max;
+  sp->disp_divider = 1;
+  sp->is_idle = 0;
+}
+
+static void gov_fixed_update(void *priv, const gov_conf_t *cfg, const gov_sample_t *s, gov_setpoint_t *sp)
+{
+  (void) priv;
+  (void) cfg;
+  (void) s;
+  (void) sp;
+}
+
+static void gov_aimd_update(void *priv, const gov_conf_t *cfg, const gov_sample_t *s, gov_setpoint_t *sp)
+{
+  int nb_candidates = s->nb_candidates >= 0 ? s->nb_candidates : s->nb_detect;
+  /* output is capped at max_boxes, so busy must be computed before the cap or it would never clear once lowered */
+  int is_busy = nb_candidates > sp->max_boxes;
+  uint32_t latency_ms = s->inf_ms + s->pp_ms;
+  uint32_t period_min;
+
+  /* No point asking for an nn period shorter than what the pipeline can do */
+  period_min = gov_clamp_u32(latency_ms, cfg->nn_period_min_ms, cfg->nn_period_max_ms);
+
+  if (s->cpu_load > cfg->cpu_budget) {
+    /* give back cpu time to isp and usb stack */
+    sp->nn_period_ms = sp->nn_period_ms + sp->nn_period_ms / 4 + 1;
+    sp->disp_divider++;
+  } else if (s->cpu_load < cfg->cpu_budget - GOV_AIMD_HYSTERESIS) {
+    sp->nn_period_ms = sp->nn_period_ms > GOV_AIMD_PERIOD_STEP_MS ? sp->nn_period_ms - GOV_AIMD_PERIOD_STEP_MS : 0;
+    sp->disp_divider--;
+  }
+
+  /* post process cost grows with the number of candidates. On busy scene trade recall for latency. Inference time
+   * doesn't depend on those knobs, so only post process time drives them.
+   */
+  if (s->pp_ms > cfg->pp_latency_ms && is_busy) {
+    sp->conf_threshold += cfg->conf_step;
+    sp->max_boxes--;
+  } else if (s->pp_ms * 100 < cfg->pp_latency_ms * (100 - GOV_AIMD_PP_HYSTERESIS)) {
+    sp->conf_threshold -= cfg->conf_step;
+    sp->max_boxes++;
+  }
+
+  sp->nn_period_ms = gov_clamp_u32(sp->nn_period_ms, period_min, cfg->nn_period_max_ms);
+  sp->disp_divider = gov_clamp_int(sp->disp_divider, 1, cfg->disp_divider_max);
+  sp->conf_threshold = gov_clamp_float(sp->conf_threshold, cfg->conf_min, cfg->conf_max);
+  sp->max_boxes = gov_clamp_int(sp->max_boxes, cfg->max_boxes_min, cfg->max_boxes_max);
+}
+
+static void gov_presence_init(void *priv, const gov_conf_t *cfg, gov_setpoint_t *sp)
+{
+  gov_presence_t *p = priv;
+
+  gov_default_init(priv, cfg, sp);
+  p->last_seen_ms = 0;
+  p->nn_period_ms = sp->nn_period_ms;
+}
+
+static void gov_presence_update(void *priv, const gov_conf_t *cfg, const gov_sample_t *s, gov_setpoint_t *sp)
+{
+  gov_presence_t *p = priv;
+  int is_present = s->nb_detect > 0 || s->nb_tracks > 0 || s->nb_lost > 0;
+
+  if (is_present)
+    p->last_seen_ms = s->ts_ms;
+
+  /* aimd keeps tracking load with its own period so waking up doesn't start from idle period */
+  sp->nn_period_ms = p->nn_period_ms;
+  gov_aimd_update(priv, cfg, s, sp);
+  p->nn_period_ms = sp->nn_period_ms;
+
+  sp->is_idle = cfg->idle_delay_ms && s->ts_ms - p->last_seen_ms >= cfg->idle_delay_ms;
+  if (sp->is_idle && sp->nn_period_ms < cfg->idle_nn_period_ms)
+    sp->nn_period_ms = cfg->idle_nn_period_ms;
+}
+
+const gov_policy_t gov_policy_fixed = {
+  .name = "fixed",
+  .init = gov_default_init,
+  .update = gov_fixed_update,
+};
+
+const gov_policy_t gov_policy_aimd = {
+  .name = "aimd",
+  .init = gov_default_init,
+  .update = gov_aimd_update,
+};
+
+const gov_policy_t gov_policy_presence = {
+  .name = "presence",
+  .init = gov_presence_init,
+  .update = gov_presence_update,
+};
+
+int gov_init(gov_ctx_t *ctx, gov_conf_t *cfg, const gov_policy_t *policy, void *priv)
+{
+  if (!policy || !policy->init || !policy->update)
+    return -1;
+  if (cfg->nn_period_min_ms > cfg->nn_period_max_ms || cfg->conf_min > cfg->conf_max)
+    return -1;
+  if (cfg->max_boxes_min < 1 || cfg->max_boxes_min > cfg->max_boxes_max || cfg->disp_divider_max < 1)
+    return -1;
+
+  ctx->cfg = *cfg;
+  ctx->policy = policy;
+  ctx->priv = priv;
+  policy->init(priv, &ctx->cfg, &ctx->sp);
+
+  return 0;
+}
+
+void gov_update(gov_ctx_t *ctx, const gov_sample_t *s)
+{
+  ctx->policy->update(ctx->priv, &ctx->cfg, s, &ctx->sp);
+}
@@ -0,0 +1,92 @@
+ /**
+ ******************************************************************************
+ * @file    overlay.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "overlay.h"
+
+static int ovl_min(int a, int b)
+{
+  return a < b ? a : b;
+}
+
+void ovl_dirty_init(ovl_dirty_t *dirty, int width, int height, Rectangle_TypeDef *rects, int rect_max)
+{
+  dirty->width = width;
+  dirty->height = height;
+  dirty->rects = rects;
+  dirty->rect_max = rect_max;
+  ovl_dirty_reset(dirty);
+}
+
+void ovl_dirty_add(ovl_dirty_t *dirty, int x, int y, int w, int h)
+{
+  Rectangle_TypeDef *r;
+
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  w = ovl_min(w, dirty->width - x);
+  h = ovl_min(h, dirty->height - y);
+  if (w <= 0 || h <= 0)
+    return;
+
+  if (dirty->nb == dirty->rect_max) {
+    dirty->is_overflow = 1;
+    return;
+  }
+
+  r = &dirty->rects[dirty->nb++];
+  r->X0 = x;
+  r->Y0 = y;
+  r->XSize = w;
+  r->YSize = h;
+}
+
+void ovl_dirty_reset(ovl_dirty_t *dirty)
+{
+  dirty->nb = 0;
+  dirty->is_overflow = 0;
+}
+
+int ovl_is_overlapping(const Rectangle_TypeDef *a, const Rectangle_TypeDef *b)
+{
+  return a->X0 < b->X0 + b->XSize && b->X0 < a->X0 + a->XSize &&
+         a->Y0 < b->Y0 + b->YSize && b->Y0 < a->Y0 + a->YSize;
+}
+
+int ovl_range_next(const Rectangle_TypeDef *r, int width, int *row, uint32_t *offset)
+{
+  const uint32_t stride = width * 2;
+
+  if (*row >= (int) r->YSize)
+    return 0;
+
+  *offset = (r->Y0 + *row) * stride + r->X0 * 2;
+  /* wide areas are handled in one go, gaps between rows are small compared to per range overhead */
+  if (r->XSize * 2 >= (uint32_t) width) {
+    *row = r->YSize;
+    return (r->YSize - 1) * stride + r->XSize * 2;
+  }
+
+  (*row)++;
+  return r->XSize * 2;
+}
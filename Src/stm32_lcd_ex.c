@@ -27,7 +27,7 @@
 /* Functions Definition ------------------------------------------------------*/
 void UTIL_LCDEx_PrintfAtLine(uint16_t line, const char * format, ...)
 {
-  static char buffer[N_PRINTABLE_CHARS + 1];
+  char buffer[N_PRINTABLE_CHARS + 1];
   va_list args;
   va_start(args, format);
   vsnprintf(buffer, N_PRINTABLE_CHARS + 1, format, args);
@@ -37,7 +37,7 @@ void UTIL_LCDEx_PrintfAtLine(uint16_t line, const char * format, ...)
 
 void UTIL_LCDEx_PrintfAt(uint32_t x_pos, uint32_t y_pos, Text_AlignModeTypdef mode, const char * format, ...)
 {
-  static char buffer[N_PRINTABLE_CHARS + 1];
+  char buffer[N_PRINTABLE_CHARS + 1];
   va_list args;
   va_start(args, format);
   vsnprintf(buffer, N_PRINTABLE_CHARS + 1, format, args);
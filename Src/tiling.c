@@ -0,0 +1,244 @@
+ /**
+ ******************************************************************************
+ * @file    tiling.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "tiling.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  float x0;
+  float y0;
+  float x1;
+  float y1;
+} tile_rect_t;
+
+static float tile_min(float a, float b)
+{
+  return a < b ? a : b;
+}
+
+static float tile_max(float a, float b)
+{
+  return a > b ? a : b;
+}
+
+static void tile_box_to_rect(const tile_box_t *box, tile_rect_t *r)
+{
+  r->x0 = box->cx - box->w / 2;
+  r->y0 = box->cy - box->h / 2;
+  r->x1 = box->cx + box->w / 2;
+  r->y1 = box->cy + box->h / 2;
+}
+
+static int tile_cmp_conf(const void *a, const void *b)
+{
+  float va = ((const tile_box_t *) a)->conf;
+  float vb = ((const tile_box_t *) b)->conf;
+
+  return (va < vb) - (va > vb);
+}
+
+/* overlap of [a0, a1] and [b0, b1] over the smaller one */
+static float tile_overlap_ratio(float a0, float a1, float b0, float b1)
+{
+  float len = tile_min(a1 - a0, b1 - b0);
+
+  if (len <= 0)
+    return 0;
+
+  return tile_max(0, tile_min(a1, b1) - tile_max(a0, b0)) / len;
+}
+
+/* Within a tile, post process already ran nms, so plain iou is enough. Across tiles, the same person is also seen:
+ *  - whole in one tile and cut at the border of the other one. Cut box is mostly contained in whole one.
+ *  - cut in both tiles, when wider than tiles overlap. Boxes are cut on facing sides and aligned across the seam.
+ */
+static int tile_is_same_object(const tile_conf_t *cfg, const tile_box_t *a, const tile_box_t *b)
+{
+  tile_rect_t ra, rb;
+  float area_a, area_b;
+  float inter;
+
+  tile_box_to_rect(a, &ra);
+  tile_box_to_rect(b, &rb);
+  inter = tile_max(0, tile_min(ra.x1, rb.x1) - tile_max(ra.x0, rb.x0)) *
+          tile_max(0, tile_min(ra.y1, rb.y1) - tile_max(ra.y0, rb.y0));
+  if (inter <= 0)
+    return 0;
+
+  area_a = a->w * a->h;
+  area_b = b->w * b->h;
+  if (inter > cfg->iou_thresh * (area_a + area_b - inter))
+    return 1;
+  if (a->tile == b->tile)
+    return 0;
+  /* only a cut view may be contained in a whole one, a smaller whole box is someone else in front or behind */
+  if ((area_a < area_b ? a->cut : b->cut) && inter > cfg->contain_thresh * tile_min(area_a, area_b))
+    return 1;
+
+  if (((a->cut & TILE_CUT_RIGHT) && (b->cut & TILE_CUT_LEFT) && a->cx < b->cx) ||
+      ((a->cut & TILE_CUT_LEFT) && (b->cut & TILE_CUT_RIGHT) && a->cx > b->cx))
+    return tile_overlap_ratio(ra.y0, ra.y1, rb.y0, rb.y1) > cfg->contain_thresh;
+  if (((a->cut & TILE_CUT_BOTTOM) && (b->cut & TILE_CUT_TOP) && a->cy < b->cy) ||
+      ((a->cut & TILE_CUT_TOP) && (b->cut & TILE_CUT_BOTTOM) && a->cy > b->cy))
+    return tile_overlap_ratio(ra.x0, ra.x1, rb.x0, rb.x1) > cfg->contain_thresh;
+
+  return 0;
+}
+
+/* Keep a, the most confident. When one of them is cut, the object extends over both so a becomes their union. A
+ * side of the union stays cut only if the box it comes from was cut there.
+ */
+static void tile_absorb(tile_box_t *a, const tile_box_t *b)
+{
+  tile_rect_t ra, rb, u;
+  int cut = 0;
+
+  if (!a->cut && !b->cut)
+    return;
+
+  tile_box_to_rect(a, &ra);
+  tile_box_to_rect(b, &rb);
+  u.x0 = tile_min(ra.x0, rb.x0);
+  u.y0 = tile_min(ra.y0, rb.y0);
+  u.x1 = tile_max(ra.x1, rb.x1);
+  u.y1 = tile_max(ra.y1, rb.y1);
+  cut |= (ra.x0 <= rb.x0 ? a->cut : b->cut) & TILE_CUT_LEFT;
+  cut |= (ra.x1 >= rb.x1 ? a->cut : b->cut) & TILE_CUT_RIGHT;
+  cut |= (ra.y0 <= rb.y0 ? a->cut : b->cut) & TILE_CUT_TOP;
+  cut |= (ra.y1 >= rb.y1 ? a->cut : b->cut) & TILE_CUT_BOTTOM;
+
+  a->cx = (u.x0 + u.x1) / 2;
+  a->cy = (u.y0 + u.y1) / 2;
+  a->w = u.x1 - u.x0;
+  a->h = u.y1 - u.y0;
+  a->cut = cut;
+}
+
+int tile_init(tile_ctx_t *ctx, tile_conf_t *cfg, int box_max, tile_box_t *boxes, tile_box_t *work)
+{
+  float size;
+  float step;
+  int i;
+
+  if (cfg->grid < 1 || cfg->grid * cfg->grid > TILE_MAX || box_max < 1 || !boxes || !work)
+    return -1;
+  if (cfg->overlap < 0 || cfg->overlap >= 1 || cfg->min_size <= 0 || cfg->min_size > 1)
+    return -1;
+
+  ctx->cfg = *cfg;
+  ctx->tile_nb = cfg->grid * cfg->grid;
+  ctx->box_max = box_max;
+  ctx->boxes = boxes;
+  ctx->work = work;
+  ctx->next = 0;
+  ctx->fresh = 0;
+  memset(ctx->box_nb, 0, sizeof(ctx->box_nb));
+
+  /* grid tiles with overlap cover grid - (grid - 1) * overlap tile sizes. Tiles are spread evenly so any extra
+   * size due to min_size goes into overlap.
+   */
+  size = 1 / (cfg->grid - (cfg->grid - 1) * cfg->overlap);
+  size = tile_min(tile_max(size, cfg->min_size), 1);
+  step = cfg->grid > 1 ? (1 - size) / (cfg->grid - 1) : 0;
+  for (i = 0; i < ctx->tile_nb; i++) {
+    ctx->tiles[i].x = (i % cfg->grid) * step;
+    ctx->tiles[i].y = (i / cfg->grid) * step;
+    ctx->tiles[i].size = size;
+  }
+
+  return 0;
+}
+
+int tile_next(tile_ctx_t *ctx)
+{
+  int res = ctx->next;
+
+  ctx->next = (ctx->next + 1) % ctx->tile_nb;
+
+  return res;
+}
+
+int tile_add(tile_ctx_t *ctx, int tile, const zoom_roi_t *roi, int nb, tile_box_t *boxes)
+{
+  const float margin = ctx->cfg.cut_margin;
+  tile_box_t *dst;
+  tile_rect_t r;
+  int i;
+
+  if (tile < 0 || tile >= ctx->tile_nb)
+    return 0;
+
+  dst = &ctx->boxes[tile * ctx->box_max];
+  if (nb > ctx->box_max)
+    nb = ctx->box_max;
+  for (i = 0; i < nb; i++) {
+    tile_box_to_rect(&boxes[i], &r);
+    boxes[i].tile = tile;
+    boxes[i].cut = 0;
+    /* tile borders on frame border don't cut anything */
+    if (r.x0 < margin && roi->x > 0)
+      boxes[i].cut |= TILE_CUT_LEFT;
+    if (r.x1 > 1 - margin && roi->x + roi->size < 1)
+      boxes[i].cut |= TILE_CUT_RIGHT;
+    if (r.y0 < margin && roi->y > 0)
+      boxes[i].cut |= TILE_CUT_TOP;
+    if (r.y1 > 1 - margin && roi->y + roi->size < 1)
+      boxes[i].cut |= TILE_CUT_BOTTOM;
+    zoom_remap(roi, &boxes[i].cx, &boxes[i].cy, &boxes[i].w, &boxes[i].h);
+    dst[i] = boxes[i];
+  }
+  ctx->box_nb[tile] = nb;
+
+  ctx->fresh |= 1U << tile;
+  if (ctx->cfg.is_sweep && ctx->fresh != (1U << ctx->tile_nb) - 1)
+    return 0;
+  ctx->fresh = 0;
+
+  return 1;
+}
+
+int tile_merge(tile_ctx_t *ctx, int out_max, tile_box_t *out)
+{
+  tile_box_t *work = ctx->work;
+  int nb = 0;
+  int res = 0;
+  int i, j;
+
+  for (i = 0; i < ctx->tile_nb; i++) {
+    memcpy(&work[nb], &ctx->boxes[i * ctx->box_max], ctx->box_nb[i] * sizeof(work[0]));
+    nb += ctx->box_nb[i];
+  }
+  qsort(work, nb, sizeof(work[0]), tile_cmp_conf);
+
+  /* greedy nms. Absorbed boxes are flagged with a negative confidence */
+  for (i = 0; i < nb && res < out_max; i++) {
+    if (work[i].conf < 0)
+      continue;
+    for (j = i + 1; j < nb; j++) {
+      if (work[j].conf < 0 || !tile_is_same_object(&ctx->cfg, &work[i], &work[j]))
+        continue;
+      tile_absorb(&work[i], &work[j]);
+      work[j].conf = -1;
+    }
+    out[res++] = work[i];
+  }
+
+  return res;
+}
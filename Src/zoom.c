@@ -0,0 +1,142 @@
+ /**
+ ******************************************************************************
+ * @file    zoom.c
+ * @author  GPM Application Team
+ *
+ ******************************************************************************
+ * @attention
+ *
+ * Copyright (c) 2025 STMicroelectronics.
+ * All rights reserved.
+ *
+ * This software is licensed under terms that can be found in the LICENSE file
+ * in the root directory of this software component.
+ * If no LICENSE file comes with this software, it is provided AS-IS.
+ *
+ ******************************************************************************
+ */
+
+#include "zoom.h"
+
+const zoom_roi_t zoom_roi_full = {
+  .x = 0,
+  .y = 0,
+  .size = 1,
+};
+
+static float zoom_min(float a, float b)
+{
+  return a < b ? a : b;
+}
+
+static float zoom_max(float a, float b)
+{
+  return a > b ? a : b;
+}
+
+static float zoom_clamp(float v, float min, float max)
+{
+  if (v < min)
+    return min;
+  if (v > max)
+    return max;
+
+  return v;
+}
+
+/* roi of given side centered on (cx, cy), shifted to stay inside full field of view */
+static void zoom_roi_center(zoom_roi_t *roi, float cx, float cy, float size)
+{
+  roi->size = size;
+  roi->x = zoom_clamp(cx - size / 2, 0, 1 - size);
+  roi->y = zoom_clamp(cy - size / 2, 0, 1 - size);
+}
+
+static int zoom_roi_contains(const zoom_roi_t *roi, float x0, float y0, float x1, float y1)
+{
+  return x0 >= roi->x && y0 >= roi->y && x1 <= roi->x + roi->size && y1 <= roi->y + roi->size;
+}
+
+int zoom_init(zoom_ctx_t *ctx, zoom_conf_t *cfg)
+{
+  if (cfg->margin < 0 || cfg->min_size <= 0 || cfg->min_size > 1)
+    return -1;
+  if (cfg->hysteresis < 0 || cfg->hysteresis >= 1 || cfg->shrink_delay < 1 || cfg->release_delay < 1)
+    return -1;
+  if (cfg->scan_period < 0)
+    return -1;
+
+  ctx->cfg = *cfg;
+  ctx->roi = zoom_roi_full;
+  ctx->shrink_cnt = 0;
+  ctx->empty_cnt = 0;
+  ctx->update_cnt = 0;
+
+  return 0;
+}
+
+/* Roi follows boxes hull plus margin:
+ *  - it moves or grows as soon as hull plus half margin leaves it, so people are not cut at its border. Half margin
+ *    slack avoids chasing detection jitter.
+ *  - it only shrinks after hull got clearly smaller for shrink_delay updates, so zoom doesn't pump.
+ *  - it goes back to full field of view after release_delay updates without boxes.
+ * Periodic full field of view scans let nn catch people entering outside of roi.
+ */
+void zoom_update(zoom_ctx_t *ctx, int nb, const zoom_box_t *boxes, zoom_roi_t *roi)
+{
+  const zoom_conf_t *cfg = &ctx->cfg;
+  float x0 = 1, y0 = 1;
+  float x1 = 0, y1 = 0;
+  float mx, my;
+  float size;
+  int i;
+
+  ctx->update_cnt++;
+  if (nb == 0) {
+    ctx->shrink_cnt = 0;
+    if (++ctx->empty_cnt >= cfg->release_delay)
+      ctx->roi = zoom_roi_full;
+    goto out;
+  }
+  ctx->empty_cnt = 0;
+
+  for (i = 0; i < nb; i++) {
+    x0 = zoom_min(x0, boxes[i].cx - boxes[i].w / 2);
+    y0 = zoom_min(y0, boxes[i].cy - boxes[i].h / 2);
+    x1 = zoom_max(x1, boxes[i].cx + boxes[i].w / 2);
+    y1 = zoom_max(y1, boxes[i].cy + boxes[i].h / 2);
+  }
+  x0 = zoom_clamp(x0, 0, 1);
+  y0 = zoom_clamp(y0, 0, 1);
+  x1 = zoom_clamp(x1, x0, 1);
+  y1 = zoom_clamp(y1, y0, 1);
+  mx = cfg->margin * (x1 - x0);
+  my = cfg->margin * (y1 - y0);
+  size = zoom_max(x1 - x0 + 2 * mx, y1 - y0 + 2 * my);
+  size = zoom_clamp(size, cfg->min_size, 1);
+
+  if (!zoom_roi_contains(&ctx->roi, x0 - mx / 2, y0 - my / 2, x1 + mx / 2, y1 + my / 2)) {
+    zoom_roi_center(&ctx->roi, (x0 + x1) / 2, (y0 + y1) / 2, zoom_max(size, ctx->roi.size));
+    ctx->shrink_cnt = 0;
+  } else if (size < ctx->roi.size * (1 - cfg->hysteresis)) {
+    if (++ctx->shrink_cnt >= cfg->shrink_delay) {
+      zoom_roi_center(&ctx->roi, (x0 + x1) / 2, (y0 + y1) / 2, size);
+      ctx->shrink_cnt = 0;
+    }
+  } else
+    ctx->shrink_cnt = 0;
+
+out:
+  if (cfg->scan_period && ctx->update_cnt % cfg->scan_period == 0)
+    *roi = zoom_roi_full;
+  else
+    *roi = ctx->roi;
+}
+
+void zoom_remap(const zoom_roi_t *roi, float *cx, float *cy, float *w, float *h)
+{
+  *cx = roi->x + *cx * roi->size;
+  *cy = roi->y + *cy * roi->size;
+  *w *= roi->size;
+  *h *= roi->size;
+}